@@ -1724,11 +1724,15 @@ do_connections_show (NmCli *nmc, int argc, char **argv)
 		char *fields_common = NMC_FIELDS_CON_SHOW_COMMON;
 		const NMMetaAbstractInfo *const*tmpl;
 		NmcOutputField *arr;
+		const char *header_name;
 		NMC_OUTPUT_DATA_DEFINE_SCOPED (out);
 
 		if (nmc->complete)
 			goto finish;
 
+		header_name = active_only ? _("NetworkManager active profiles")
+		                          : _("NetworkManager connection profiles");
+
 		if (!nmc->required_fields || strcasecmp (nmc->required_fields, "common") == 0)
 			fields_str = fields_common;
 		else if (!nmc->required_fields || strcasecmp (nmc->required_fields, "all") == 0) {
@@ -1754,15 +1758,14 @@ do_connections_show (NmCli *nmc, int argc, char **argv)
 		/* Sort the connections and fill the output data */
 		connections = nm_client_get_connections (nmc->client);
 		sorted_cons = sort_connections (connections, nmc, order);
-		for (i = 0; i < sorted_cons->len; i++)
+		for (i = 0; i < sorted_cons->len; i++) {
 			fill_output_connection (sorted_cons->pdata[i], nmc->client, nmc->nmc_config.print_output, out.output_data, active_only);
+			print_data_stream (&nmc->nmc_config, out_indices, header_name, 0, &out);
+		}
 		g_ptr_array_free (sorted_cons, TRUE);
 
 		print_data_prepare_width (out.output_data);
-		print_data (&nmc->nmc_config, out_indices,
-		            active_only ? _("NetworkManager active profiles")
-		                        : _("NetworkManager connection profiles"),
-		            0, &out);
+		print_data (&nmc->nmc_config, out_indices, header_name, 0, &out);
 	} else {
 		gboolean new_line = FALSE;
 		gboolean without_fields = (nmc->required_fields == NULL);
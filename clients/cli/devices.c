@@ -2499,12 +2499,14 @@ do_devices_monitor (NmCli *nmc, int argc, char **argv)
 }
 
 static void
-show_access_point_info (NMDevice *device, NmCli *nmc, NmcOutputData *out)
+show_access_point_info (NMDevice *device, NmCli *nmc, const GArray *indices,
+                        const char *header_name, NmcOutputData *out)
 {
 	NMAccessPoint *active_ap = NULL;
 	const char *active_bssid = NULL;
 	GPtrArray *aps;
 	NmcOutputField *arr;
+	guint i;
 
 	if (nm_device_get_state (device) == NM_DEVICE_STATE_ACTIVATED) {
 		active_ap = nm_device_wifi_get_active_access_point (NM_DEVICE_WIFI (device));
@@ -2526,11 +2528,15 @@ show_access_point_info (NMDevice *device, NmCli *nmc, NmcOutputData *out)
 		};
 
 		aps = sort_access_points (nm_device_wifi_get_access_points (NM_DEVICE_WIFI (device)));
-		g_ptr_array_foreach (aps, fill_output_access_point, &info);
+		for (i = 0; i < aps->len; i++) {
+			fill_output_access_point (aps->pdata[i], &info);
+			print_data_stream (&nmc->nmc_config, indices, header_name, 0, out);
+		}
 		g_ptr_array_free (aps, FALSE);
 	}
 
 	print_data_prepare_width (out->output_data);
+	print_data (&nmc->nmc_config, indices, header_name, 0, out);
 }
 
 /*
@@ -2763,8 +2769,7 @@ do_device_wifi_list (NmCli *nmc, int argc, char **argv)
 				print_data (&nmc->nmc_config, out_indices, header_name, 0, &out);
 				g_free (info);
 			} else {
-				show_access_point_info (device, nmc, &out);
-				print_data (&nmc->nmc_config, out_indices, NULL, 0, &out);
+				show_access_point_info (device, nmc, out_indices, NULL, &out);
 			}
 		} else {
 			if (   nm_device_get_device_type (device) == NM_DEVICE_TYPE_GENERIC
@@ -2846,8 +2851,7 @@ do_device_wifi_list (NmCli *nmc, int argc, char **argv)
 				if (NM_IS_DEVICE_WIFI (dev)) {
 					if (empty_line)
 						g_print ("\n"); /* Empty line between devices' APs */
-					show_access_point_info (dev, nmc, &out2);
-					print_data (&nmc->nmc_config, out2_indices, header_name2, 0, &out2);
+					show_access_point_info (dev, nmc, out2_indices, header_name2, &out2);
 					empty_line = TRUE;
 				}
 			}
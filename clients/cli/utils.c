@@ -1060,23 +1060,13 @@ _print_data_cell_clear (gpointer cell_p)
 	_print_data_cell_clear_text (cell);
 }
 
-static void
-_print_fill (const NmcConfig *nmc_config,
-             gpointer const *targets,
-             const PrintDataCol *cols,
-             guint cols_len,
-             GArray **out_header_row,
-             GArray **out_cells)
+static GArray *
+_print_fill_header (const NmcConfig *nmc_config,
+                    const PrintDataCol *cols,
+                    guint cols_len)
 {
-	GArray *cells;
 	GArray *header_row;
-	guint i_row, i_col;
-	guint targets_len;
-	gboolean pretty;
-	NMMetaAccessorGetType text_get_type;
-	NMMetaAccessorGetFlags text_get_flags;
-
-	pretty = (nmc_config->print_output != NMC_PRINT_TERSE);
+	guint i_col;
 
 	header_row = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataHeaderCell), cols_len);
 	g_array_set_clear_func (header_row, _print_data_header_cell_clear);
@@ -1112,13 +1102,27 @@ _print_fill (const NmcConfig *nmc_config,
 			                                      header_cell->title);
 			header_cell->title_to_free = TRUE;
 		}
+
+		header_cell->width = nmc_string_screen_width (header_cell->title, NULL);
 	}
 
-	targets_len = NM_PTRARRAY_LEN (targets);
+	return header_row;
+}
+
+static void
+_print_fill_row (const NmcConfig *nmc_config,
+                 gpointer target,
+                 guint i_row,
+                 const PrintDataHeaderCell *header_row,
+                 guint col_len,
+                 PrintDataCell *cells_line)
+{
+	guint i_col;
+	gboolean pretty;
+	NMMetaAccessorGetType text_get_type;
+	NMMetaAccessorGetFlags text_get_flags;
 
-	cells = g_array_sized_new (FALSE, TRUE, sizeof (PrintDataCell), targets_len * header_row->len);
-	g_array_set_clear_func (cells, _print_data_cell_clear);
-	g_array_set_size (cells, targets_len * header_row->len);
+	pretty = (nmc_config->print_output != NMC_PRINT_TERSE);
 
 	text_get_type = pretty
 	                ? NM_META_ACCESSOR_GET_TYPE_PRETTY
@@ -1127,102 +1131,106 @@ _print_fill (const NmcConfig *nmc_config,
 	if (nmc_config->show_secrets)
 		text_get_flags |= NM_META_ACCESSOR_GET_FLAGS_SHOW_SECRETS;
 
-	for (i_row = 0; i_row < targets_len; i_row++) {
-		gpointer target = targets[i_row];
-		PrintDataCell *cells_line = &g_array_index (cells, PrintDataCell, i_row * header_row->len);
-
-		for (i_col = 0; i_col < header_row->len; i_col++) {
-			char *to_free = NULL;
-			PrintDataCell *cell = &cells_line[i_col];
-			const PrintDataHeaderCell *header_cell;
-			const NMMetaAbstractInfo *info;
-			NMMetaAccessorGetOutFlags text_out_flags, color_out_flags;
-			gconstpointer value;
-
-			header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
-			info = header_cell->col->selection_item->info;
-
-			cell->row_idx = i_row;
-			cell->header_cell = header_cell;
-
-			value = nm_meta_abstract_info_get (info,
-			                                   nmc_meta_environment,
-			                                   nmc_meta_environment_arg,
-			                                   target,
-			                                   text_get_type,
-			                                   text_get_flags,
-			                                   &text_out_flags,
-			                                   (gpointer *) &to_free);
-			if (NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_STRV)) {
-				if (value) {
-					if (nmc_config->multiline_output) {
-						cell->text_format = PRINT_DATA_CELL_FORMAT_TYPE_STRV;
-						cell->text.strv = value;
-						cell->text_to_free = !!to_free;
-					} else {
-						cell->text.plain = g_strjoinv (" | ", (char **) value);
-						cell->text_to_free = TRUE;
-						if (to_free)
-							g_strfreev ((char **) to_free);
-					}
+	for (i_col = 0; i_col < col_len; i_col++) {
+		char *to_free = NULL;
+		PrintDataCell *cell = &cells_line[i_col];
+		const PrintDataHeaderCell *header_cell;
+		const NMMetaAbstractInfo *info;
+		NMMetaAccessorGetOutFlags text_out_flags, color_out_flags;
+		gconstpointer value;
+
+		header_cell = &header_row[i_col];
+		info = header_cell->col->selection_item->info;
+
+		cell->row_idx = i_row;
+		cell->header_cell = header_cell;
+		cell->text_format = PRINT_DATA_CELL_FORMAT_TYPE_PLAIN;
+
+		value = nm_meta_abstract_info_get (info,
+		                                   nmc_meta_environment,
+		                                   nmc_meta_environment_arg,
+		                                   target,
+		                                   text_get_type,
+		                                   text_get_flags,
+		                                   &text_out_flags,
+		                                   (gpointer *) &to_free);
+		if (NM_FLAGS_HAS (text_out_flags, NM_META_ACCESSOR_GET_OUT_FLAGS_STRV)) {
+			if (value) {
+				if (nmc_config->multiline_output) {
+					cell->text_format = PRINT_DATA_CELL_FORMAT_TYPE_STRV;
+					cell->text.strv = value;
+					cell->text_to_free = !!to_free;
+				} else {
+					cell->text.plain = g_strjoinv (" | ", (char **) value);
+					cell->text_to_free = TRUE;
+					if (to_free)
+						g_strfreev ((char **) to_free);
 				}
-			} else {
-				cell->text.plain = value;
-				cell->text_to_free = !!to_free;
 			}
+		} else {
+			cell->text.plain = value;
+			cell->text_to_free = !!to_free;
+		}
 
-			nm_meta_termformat_unpack (nm_meta_abstract_info_get (info,
-			                                                      nmc_meta_environment,
-			                                                      nmc_meta_environment_arg,
-			                                                      target,
-			                                                      NM_META_ACCESSOR_GET_TYPE_TERMFORMAT,
-			                                                      NM_META_ACCESSOR_GET_FLAGS_NONE,
-			                                                      &color_out_flags,
-			                                                      NULL),
-			                           &cell->term_color,
-			                           &cell->term_format);
-
-			if (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_PLAIN) {
-				if (pretty && (!cell->text.plain|| !cell->text.plain[0])) {
-					_print_data_cell_clear_text (cell);
-					cell->text.plain = "--";
-				} else if (!cell->text.plain)
-					cell->text.plain = "";
-			}
+		nm_meta_termformat_unpack (nm_meta_abstract_info_get (info,
+		                                                      nmc_meta_environment,
+		                                                      nmc_meta_environment_arg,
+		                                                      target,
+		                                                      NM_META_ACCESSOR_GET_TYPE_TERMFORMAT,
+		                                                      NM_META_ACCESSOR_GET_FLAGS_NONE,
+		                                                      &color_out_flags,
+		                                                      NULL),
+		                           &cell->term_color,
+		                           &cell->term_format);
+
+		if (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_PLAIN) {
+			if (pretty && (!cell->text.plain|| !cell->text.plain[0])) {
+				_print_data_cell_clear_text (cell);
+				cell->text.plain = "--";
+			} else if (!cell->text.plain)
+				cell->text.plain = "";
 		}
 	}
+}
+
+static void
+_print_clear_row (PrintDataCell *cells_line,
+                  guint col_len)
+{
+	guint i_col;
 
-	for (i_col = 0; i_col < header_row->len; i_col++) {
-		PrintDataHeaderCell *header_cell = &g_array_index (header_row, PrintDataHeaderCell, i_col);
+	for (i_col = 0; i_col < col_len; i_col++)
+		_print_data_cell_clear (&cells_line[i_col]);
+}
 
-		header_cell->width = nmc_string_screen_width (header_cell->title, NULL);
+static void
+_print_update_width (PrintDataHeaderCell *header_row,
+                     guint col_len,
+                     const PrintDataCell *cells_line)
+{
+	guint i_col;
 
-		for (i_row = 0; i_row < targets_len; i_row++) {
-			const PrintDataCell *cell = &g_array_index (cells, PrintDataCell, i_row * cols_len + i_col);
-			const char *const*i_strv;
+	for (i_col = 0; i_col < col_len; i_col++) {
+		PrintDataHeaderCell *header_cell = &header_row[i_col];
+		const PrintDataCell *cell = &cells_line[i_col];
+		const char *const*i_strv;
 
-			switch (cell->text_format) {
-			case PRINT_DATA_CELL_FORMAT_TYPE_PLAIN:
-				header_cell->width = NM_MAX (header_cell->width,
-				                             nmc_string_screen_width (cell->text.plain, NULL));
-				break;
-			case PRINT_DATA_CELL_FORMAT_TYPE_STRV:
-				i_strv = cell->text.strv;
-				if (i_strv) {
-					for (; *i_strv; i_strv++) {
-						header_cell->width = NM_MAX (header_cell->width,
-						                             nmc_string_screen_width (*i_strv, NULL));
-					}
+		switch (cell->text_format) {
+		case PRINT_DATA_CELL_FORMAT_TYPE_PLAIN:
+			header_cell->width = NM_MAX (header_cell->width,
+			                             nmc_string_screen_width (cell->text.plain, NULL));
+			break;
+		case PRINT_DATA_CELL_FORMAT_TYPE_STRV:
+			i_strv = cell->text.strv;
+			if (i_strv) {
+				for (; *i_strv; i_strv++) {
+					header_cell->width = NM_MAX (header_cell->width,
+					                             nmc_string_screen_width (*i_strv, NULL));
 				}
-				break;
 			}
+			break;
 		}
-
-		header_cell->width += 1;
 	}
-
-	*out_header_row = header_row;
-	*out_cells = cells;
 }
 
 static gboolean
@@ -1259,23 +1267,19 @@ _print_skip_column (const NmcConfig *nmc_config,
 }
 
 static void
-_print_do (const NmcConfig *nmc_config,
-           const char *header_name_no_l10n,
-           guint col_len,
-           guint row_len,
-           const PrintDataHeaderCell *header_row,
-           const PrintDataCell *cells)
+_print_do_header (const NmcConfig *nmc_config,
+                  const char *header_name_no_l10n,
+                  guint col_len,
+                  const PrintDataHeaderCell *header_row)
 {
 	int width1, width2;
 	int table_width = 0;
 	gboolean pretty = (nmc_config->print_output == NMC_PRINT_PRETTY);
 	gboolean terse = (nmc_config->print_output == NMC_PRINT_TERSE);
 	gboolean multiline = nmc_config->multiline_output;
-	guint i_row, i_col;
+	guint i_col;
 	nm_auto_free_gstring GString *str = NULL;
 
-	g_assert (col_len && row_len);
-
 	/* Main header */
 	if (pretty && header_name_no_l10n) {
 		gs_free char *line = NULL;
@@ -1299,12 +1303,10 @@ _print_do (const NmcConfig *nmc_config,
 		g_print ("%s\n", line);
 	}
 
-	str = !multiline
-	      ? g_string_sized_new (100)
-	      : NULL;
-
 	/* print the header for the tabular form */
 	if (!multiline && !terse) {
+		str = g_string_sized_new (100);
+
 		for (i_col = 0; i_col < col_len; i_col++) {
 			const PrintDataHeaderCell *header_cell = &header_row[i_col];
 			const char *title;
@@ -1324,7 +1326,6 @@ _print_do (const NmcConfig *nmc_config,
 		if (str->len)
 			g_string_truncate (str, str->len-1);  /* Chop off last column separator */
 		g_print ("%s\n", str->str);
-		g_string_truncate (str, 0);
 
 		/* Print horizontal separator */
 		if (pretty) {
@@ -1333,91 +1334,101 @@ _print_do (const NmcConfig *nmc_config,
 			g_print ("%s\n", (line = g_strnfill (table_width, '-')));
 		}
 	}
+}
 
-	for (i_row = 0; i_row < row_len; i_row++) {
-		const PrintDataCell *current_line = &cells[i_row * col_len];
-
-		for (i_col = 0; i_col < col_len; i_col++) {
-			const PrintDataCell *cell = &current_line[i_col];
-			const char *const*lines = NULL;
-			guint i_lines, lines_len;
-
-			if (_print_skip_column (nmc_config, cell->header_cell))
-				continue;
+static void
+_print_do_row (const NmcConfig *nmc_config,
+               guint col_len,
+               const PrintDataHeaderCell *header_row,
+               const PrintDataCell *current_line,
+               gboolean last_row,
+               GString *str)
+{
+	int width1, width2;
+	gboolean pretty = (nmc_config->print_output == NMC_PRINT_PRETTY);
+	gboolean terse = (nmc_config->print_output == NMC_PRINT_TERSE);
+	gboolean multiline = nmc_config->multiline_output;
+	guint i_col;
 
-			lines_len = 0;
-			switch (cell->text_format) {
-			case PRINT_DATA_CELL_FORMAT_TYPE_PLAIN:
-				lines = &cell->text.plain;
-				lines_len = 1;
-				break;
-			case PRINT_DATA_CELL_FORMAT_TYPE_STRV:
-				nm_assert (multiline);
-				lines = cell->text.strv;
-				lines_len = NM_PTRARRAY_LEN (lines);
-				break;
-			}
+	for (i_col = 0; i_col < col_len; i_col++) {
+		const PrintDataCell *cell = &current_line[i_col];
+		const char *const*lines = NULL;
+		guint i_lines, lines_len;
 
-			for (i_lines = 0; i_lines < lines_len; i_lines++) {
-				gs_free char *text_to_free = NULL;
-				const char *text;
+		if (_print_skip_column (nmc_config, cell->header_cell))
+			continue;
 
-				text = colorize_string (nmc_config->use_colors,
-				                        cell->term_color, cell->term_format,
-				                        lines[i_lines], &text_to_free);
-				if (multiline) {
-					gs_free char *prefix = NULL;
+		lines_len = 0;
+		switch (cell->text_format) {
+		case PRINT_DATA_CELL_FORMAT_TYPE_PLAIN:
+			lines = &cell->text.plain;
+			lines_len = 1;
+			break;
+		case PRINT_DATA_CELL_FORMAT_TYPE_STRV:
+			nm_assert (multiline);
+			lines = cell->text.strv;
+			lines_len = NM_PTRARRAY_LEN (lines);
+			break;
+		}
 
-					if (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_STRV)
-						prefix = g_strdup_printf ("%s[%u]:", cell->header_cell->title, i_lines + 1);
-					else
-						prefix = g_strdup_printf ("%s:", cell->header_cell->title);
-					width1 = strlen (prefix);
-					width2 = nmc_string_screen_width (prefix, NULL);
-					g_print ("%-*s%s\n", (int) (terse ? 0 : ML_VALUE_INDENT+width1-width2), prefix, text);
-				} else {
-					nm_assert (str);
-					if (terse) {
-						if (nmc_config->escape_values) {
-							const char *p = text;
-							while (*p) {
-								if (*p == ':' || *p == '\\')
-									g_string_append_c (str, '\\');  /* Escaping by '\' */
-								g_string_append_c (str, *p);
-								p++;
-							}
+		for (i_lines = 0; i_lines < lines_len; i_lines++) {
+			gs_free char *text_to_free = NULL;
+			const char *text;
+
+			text = colorize_string (nmc_config->use_colors,
+			                        cell->term_color, cell->term_format,
+			                        lines[i_lines], &text_to_free);
+			if (multiline) {
+				gs_free char *prefix = NULL;
+
+				if (cell->text_format == PRINT_DATA_CELL_FORMAT_TYPE_STRV)
+					prefix = g_strdup_printf ("%s[%u]:", cell->header_cell->title, i_lines + 1);
+				else
+					prefix = g_strdup_printf ("%s:", cell->header_cell->title);
+				width1 = strlen (prefix);
+				width2 = nmc_string_screen_width (prefix, NULL);
+				g_print ("%-*s%s\n", (int) (terse ? 0 : ML_VALUE_INDENT+width1-width2), prefix, text);
+			} else {
+				nm_assert (str);
+				if (terse) {
+					if (nmc_config->escape_values) {
+						const char *p = text;
+						while (*p) {
+							if (*p == ':' || *p == '\\')
+								g_string_append_c (str, '\\');  /* Escaping by '\' */
+							g_string_append_c (str, *p);
+							p++;
 						}
-						else
-							g_string_append_printf (str, "%s", text);
-						g_string_append_c (str, ':');  /* Column separator */
-					} else {
-						const PrintDataHeaderCell *header_cell = &header_row[i_col];
-
-						width1 = strlen (text);
-						width2 = nmc_string_screen_width (text, NULL);  /* Width of the string (in screen colums) */
-						g_string_append_printf (str, "%-*s", (int) (header_cell->width + width1 - width2), text);
-						g_string_append_c (str, ' ');  /* Column separator */
-						table_width += header_cell->width + width1 - width2 + 1;
 					}
+					else
+						g_string_append_printf (str, "%s", text);
+					g_string_append_c (str, ':');  /* Column separator */
+				} else {
+					const PrintDataHeaderCell *header_cell = &header_row[i_col];
+
+					width1 = strlen (text);
+					width2 = nmc_string_screen_width (text, NULL);  /* Width of the string (in screen colums) */
+					g_string_append_printf (str, "%-*s", (int) (header_cell->width + width1 - width2), text);
+					g_string_append_c (str, ' ');  /* Column separator */
 				}
 			}
 		}
+	}
 
-		if (!multiline) {
-			if (str->len)
-				g_string_truncate (str, str->len-1);  /* Chop off last column separator */
-			g_print ("%s\n", str->str);
+	if (!multiline) {
+		if (str->len)
+			g_string_truncate (str, str->len-1);  /* Chop off last column separator */
+		g_print ("%s\n", str->str);
 
-			g_string_truncate (str, 0);
-		}
+		g_string_truncate (str, 0);
+	}
 
-		if (   pretty
-		    && (   i_row < row_len - 1
-		        || multiline)) {
-			gs_free char *line = NULL;
+	if (   pretty
+	    && (   !last_row
+	        || multiline)) {
+		gs_free char *line = NULL;
 
-			g_print ("%s\n", (line = g_strnfill (ML_HEADER_WIDTH, '-')));
-		}
+		g_print ("%s\n", (line = g_strnfill (ML_HEADER_WIDTH, '-')));
 	}
 }
 
@@ -1431,27 +1442,53 @@ nmc_print (const NmcConfig *nmc_config,
 {
 	gs_unref_ptrarray GPtrArray *gfree_keeper = NULL;
 	gs_unref_array GArray *cols = NULL;
-	gs_unref_array GArray *header_row = NULL;
-	gs_unref_array GArray *cells = NULL;
+	gs_unref_array GArray *header_row_arr = NULL;
+	gs_free PrintDataCell *cells_line = NULL;
+	nm_auto_free_gstring GString *str = NULL;
+	PrintDataHeaderCell *header_row;
+	guint i_row, row_len;
+	guint i_col, col_len;
 
 	if (!_output_selection_parse (fields, fields_str,
 	                              &cols, &gfree_keeper,
 	                              error))
 		return FALSE;
 
-	_print_fill (nmc_config,
-	             targets,
-	             &g_array_index (cols, PrintDataCol, 0),
-	             cols->len,
-	             &header_row,
-	             &cells);
+	header_row_arr = _print_fill_header (nmc_config,
+	                                     &g_array_index (cols, PrintDataCol, 0),
+	                                     cols->len);
+	header_row = &g_array_index (header_row_arr, PrintDataHeaderCell, 0);
+	col_len = header_row_arr->len;
+	row_len = NM_PTRARRAY_LEN (targets);
+
+	g_assert (col_len && row_len);
 
-	_print_do (nmc_config,
-	           header_name_no_l10n,
-	           header_row->len,
-	           cells->len / header_row->len,
-	           &g_array_index (header_row, PrintDataHeaderCell, 0),
-	           &g_array_index (cells, PrintDataCell, 0));
+	/* Only one row of cells is kept at a time. Each row is printed as soon
+	 * as it is filled, unless the columns must be aligned. Then a first pass
+	 * determines the column widths and the rows are filled again for printing. */
+	cells_line = g_new0 (PrintDataCell, col_len);
+
+	if (   nmc_config->print_output != NMC_PRINT_TERSE
+	    && !nmc_config->multiline_output) {
+		for (i_row = 0; i_row < row_len; i_row++) {
+			_print_fill_row (nmc_config, targets[i_row], i_row, header_row, col_len, cells_line);
+			_print_update_width (header_row, col_len, cells_line);
+			_print_clear_row (cells_line, col_len);
+		}
+	}
+	for (i_col = 0; i_col < col_len; i_col++)
+		header_row[i_col].width += 1;
+
+	_print_do_header (nmc_config, header_name_no_l10n, col_len, header_row);
+
+	if (!nmc_config->multiline_output)
+		str = g_string_sized_new (100);
+
+	for (i_row = 0; i_row < row_len; i_row++) {
+		_print_fill_row (nmc_config, targets[i_row], i_row, header_row, col_len, cells_line);
+		_print_do_row (nmc_config, col_len, header_row, cells_line, i_row == row_len - 1, str);
+		_print_clear_row (cells_line, col_len);
+	}
 
 	return TRUE;
 }
@@ -1838,3 +1875,23 @@ print_data (const NmcConfig *nmc_config,
 	}
 }
 
+/*
+ * Print the rows accumulated in 'out' right away and drop them, if the
+ * output mode doesn't align columns (terse or multiline). That way long
+ * listings are not kept in memory in full. In tabular mode this does
+ * nothing, and the rows are printed by print_data() once all are known.
+ */
+void
+print_data_stream (const NmcConfig *nmc_config,
+                   const GArray *indices,
+                   const char *header_name,
+                   int indent,
+                   NmcOutputData *out)
+{
+	if (   nmc_config->print_output != NMC_PRINT_TERSE
+	    && !nmc_config->multiline_output)
+		return;
+
+	print_data (nmc_config, indices, header_name, indent, out);
+	nmc_empty_output_fields (out);
+}
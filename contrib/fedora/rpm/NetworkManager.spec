@@ -589,6 +589,7 @@ fi
 %dir %{_sysconfdir}/%{name}/dispatcher.d/pre-down.d
 %dir %{_sysconfdir}/%{name}/dispatcher.d/pre-up.d
 %dir %{_sysconfdir}/%{name}/dispatcher.d/no-wait.d
+%dir %{_sysconfdir}/%{name}/dispatcher.d/parallel.d
 %dir %{_sysconfdir}/%{name}/dnsmasq.d
 %dir %{_sysconfdir}/%{name}/dnsmasq-shared.d
 %config(noreplace) %{_sysconfdir}/%{name}/NetworkManager.conf
@@ -0,0 +1,781 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2008 - 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+
+#include "nm-dispatcher-api.h"
+
+#include "nm-dispatcher-queue.h"
+
+typedef struct Request Request;
+
+struct _NMDispatcherQueue {
+	guint max_parallel;
+	NMDispatcherQueueIdleFunc idle_func;
+	gpointer idle_user_data;
+
+	guint request_id_counter;
+
+	Request *current_request;
+	GQueue *requests_waiting;
+	gint num_requests_pending;
+
+	/* Requests with "parallel" scripts, per interface name (GQueue).
+	 * Only the head of each queue runs its parallel scripts. */
+	GHashTable *parallel_requests;
+	/* parallel scripts that wait for a free slot. */
+	GQueue *parallel_scripts_waiting;
+	guint num_parallel_running;
+};
+
+typedef struct {
+	Request *request;
+
+	char *script;
+	GPid pid;
+	DispatchResult result;
+	char *error;
+	NMDispatcherScriptType type;
+	gboolean wait;
+	gboolean dispatched;
+	guint watch_id;
+	guint timeout_id;
+} ScriptInfo;
+
+struct Request {
+	NMDispatcherQueue *queue;
+
+	guint request_id;
+
+	NMDispatcherRequestCompleteFunc complete_func;
+	gpointer complete_user_data;
+	char *action;
+	char *iface;
+	char **envp;
+	gboolean debug;
+
+	GPtrArray *scripts;  /* list of ScriptInfo */
+	guint idx;
+	gint num_scripts_done;
+	gint num_scripts_nowait;
+	gint num_scripts_parallel;
+	gboolean has_parallel;
+};
+
+static gboolean dispatch_one_script (Request *request);
+static gboolean script_dispatch (ScriptInfo *script);
+static void parallel_request_next (NMDispatcherQueue *queue, const char *iface);
+static void parallel_dispatch (NMDispatcherQueue *queue);
+
+/*****************************************************************************/
+
+#define __LOG_print(print_cmd, _request, _script, ...) \
+	G_STMT_START { \
+		nm_assert ((_request) && (!(_script) || (_script)->request == (_request))); \
+		print_cmd ("req:%u '%s'%s%s%s%s%s%s: " _NM_UTILS_MACRO_FIRST (__VA_ARGS__), \
+		           (_request)->request_id, \
+		           (_request)->action, \
+		           (_request)->iface ? " [" : "", \
+		           (_request)->iface ? (_request)->iface : "", \
+		           (_request)->iface ? "]" : "", \
+		           (_script) ? ", \"" : "", \
+		           (_script) ? (_script)->script : "", \
+		           (_script) ? "\"" : "" \
+		           _NM_UTILS_MACRO_REST (__VA_ARGS__)); \
+	} G_STMT_END
+
+#define _LOG(_request, _script, log_always, print_cmd, ...) \
+	G_STMT_START { \
+		const Request *__request = (_request); \
+		const ScriptInfo *__script = (_script); \
+		\
+		if (!__request) \
+			__request = __script->request; \
+		nm_assert (__request && (!__script || __script->request == __request)); \
+		if ((log_always) || _LOG_R_D_enabled (__request)) { \
+			if (FALSE) { \
+				/* g_message() alone does not warn about invalid format. Add a dummy printf() statement to
+				 * get a compiler warning about wrong format. */ \
+				__LOG_print (printf, __request, __script, __VA_ARGS__); \
+			} \
+			__LOG_print (print_cmd, __request, __script, __VA_ARGS__); \
+		} \
+	} G_STMT_END
+
+static gboolean
+_LOG_R_D_enabled (const Request *request)
+{
+	return request->debug;
+}
+
+#define _LOG_R_D(_request, ...) _LOG(_request, NULL, FALSE, g_debug,   __VA_ARGS__)
+#define _LOG_R_I(_request, ...) _LOG(_request, NULL, TRUE,  g_info,    __VA_ARGS__)
+#define _LOG_R_W(_request, ...) _LOG(_request, NULL, TRUE,  g_warning, __VA_ARGS__)
+
+#define _LOG_S_D(_script, ...)  _LOG(NULL, _script,  FALSE, g_debug,   __VA_ARGS__)
+#define _LOG_S_I(_script, ...)  _LOG(NULL, _script,  TRUE,  g_info,    __VA_ARGS__)
+#define _LOG_S_W(_script, ...)  _LOG(NULL, _script,  TRUE,  g_warning, __VA_ARGS__)
+
+/*****************************************************************************/
+
+static void
+script_info_free (gpointer ptr)
+{
+	ScriptInfo *info = ptr;
+
+	g_free (info->script);
+	g_free (info->error);
+	g_slice_free (ScriptInfo, info);
+}
+
+static void
+request_free (Request *request)
+{
+	g_assert_cmpuint (request->num_scripts_done, ==, request->scripts->len);
+	g_assert_cmpuint (request->num_scripts_nowait, ==, 0);
+	g_assert_cmpuint (request->num_scripts_parallel, ==, 0);
+
+	g_free (request->action);
+	g_free (request->iface);
+	g_strfreev (request->envp);
+	g_ptr_array_free (request->scripts, TRUE);
+
+	g_slice_free (Request, request);
+}
+
+static GVariant *
+request_get_results (Request *request)
+{
+	GVariantBuilder results;
+	guint i;
+
+	g_variant_builder_init (&results, G_VARIANT_TYPE ("a(sus)"));
+	for (i = 0; i < request->scripts->len; i++) {
+		ScriptInfo *script = g_ptr_array_index (request->scripts, i);
+
+		g_variant_builder_add (&results, "(sus)",
+		                       script->script,
+		                       script->result,
+		                       script->error ? script->error : "");
+	}
+	return g_variant_builder_end (&results);
+}
+
+/**
+ * next_request:
+ *
+ * @queue: the queue
+ * @request: (allow-none): the request to set as next. If %NULL, dequeue the next
+ * waiting request. Otherwise, try to set the given request.
+ *
+ * Sets the currently active request (@current_request). The current request
+ * is a request that has at least on "wait" script, because requests that only
+ * consist of "no-wait" scripts are handled right away and not enqueued to
+ * @requests_waiting nor set as @current_request.
+ *
+ * Returns: %TRUE, if there was currently not request in process and it set
+ * a new request as current.
+ */
+static gboolean
+next_request (NMDispatcherQueue *queue, Request *request)
+{
+	if (request) {
+		if (queue->current_request) {
+			g_queue_push_tail (queue->requests_waiting, request);
+			return FALSE;
+		}
+	} else {
+		/* when calling next_request() without explicit @request, we always
+		 * forcefully clear @current_request. That one is certainly
+		 * handled already. */
+		queue->current_request = NULL;
+
+		request = g_queue_pop_head (queue->requests_waiting);
+		if (!request)
+			return FALSE;
+	}
+
+	_LOG_R_I (request, "start running ordered scripts...");
+
+	queue->current_request = request;
+
+	return TRUE;
+}
+
+/**
+ * complete_request:
+ * @request: the request
+ *
+ * Checks if all the scripts for the request have terminated and in such case
+ * it reports the results and releases the request resources.
+ *
+ * It also decreases @num_requests_pending and possibly calls the idle function.
+ */
+static void
+complete_request (Request *request)
+{
+	NMDispatcherQueue *queue = request->queue;
+	gs_free char *parallel_iface = NULL;
+
+	nm_assert (request);
+
+	/* Are there still pending scripts? Then do nothing (for now). */
+	if (request->num_scripts_done < request->scripts->len)
+		return;
+
+	request->complete_func (request_get_results (request), request->complete_user_data);
+
+	_LOG_R_D (request, "completed (%u scripts)", request->scripts->len);
+
+	if (queue->current_request == request)
+		queue->current_request = NULL;
+
+	if (request->has_parallel) {
+		GQueue *parallel;
+
+		/* only the head of the queue runs its parallel scripts, so
+		 * only the head can complete. */
+		parallel_iface = g_strdup (request->iface ?: "");
+		parallel = g_hash_table_lookup (queue->parallel_requests, parallel_iface);
+		nm_assert (parallel && g_queue_peek_head (parallel) == request);
+		g_queue_pop_head (parallel);
+	}
+
+	request_free (request);
+
+	g_assert_cmpuint (queue->num_requests_pending, >, 0);
+	if (--queue->num_requests_pending <= 0) {
+		nm_assert (!queue->current_request && !g_queue_peek_head (queue->requests_waiting));
+		if (queue->idle_func)
+			queue->idle_func (queue, queue->idle_user_data);
+	}
+
+	if (parallel_iface)
+		parallel_request_next (queue, parallel_iface);
+}
+
+/**
+ * parallel_request_start:
+ * @request: the request
+ *
+ * Queues the "parallel" scripts of @request to be run as soon as
+ * there are free slots. Parallel scripts of a request only wait for
+ * the parallel scripts of previous requests for the same interface.
+ */
+static void
+parallel_request_start (Request *request)
+{
+	NMDispatcherQueue *queue = request->queue;
+	guint i;
+
+	_LOG_R_D (request, "start running parallel scripts...");
+
+	for (i = 0; i < request->scripts->len; i++) {
+		ScriptInfo *script = g_ptr_array_index (request->scripts, i);
+
+		if (script->type == NM_DISPATCHER_SCRIPT_TYPE_PARALLEL)
+			g_queue_push_tail (queue->parallel_scripts_waiting, script);
+	}
+}
+
+static void
+parallel_request_add (NMDispatcherQueue *queue, Request *request)
+{
+	const char *iface = request->iface ?: "";
+	GQueue *parallel;
+
+	parallel = g_hash_table_lookup (queue->parallel_requests, iface);
+	if (!parallel) {
+		parallel = g_queue_new ();
+		g_hash_table_insert (queue->parallel_requests, g_strdup (iface), parallel);
+	}
+	g_queue_push_tail (parallel, request);
+	if (parallel->length == 1)
+		parallel_request_start (request);
+}
+
+static void
+parallel_request_next (NMDispatcherQueue *queue, const char *iface)
+{
+	GQueue *parallel;
+	Request *request;
+
+	parallel = g_hash_table_lookup (queue->parallel_requests, iface);
+	if (!parallel)
+		return;
+
+	request = g_queue_peek_head (parallel);
+	if (!request) {
+		g_hash_table_remove (queue->parallel_requests, iface);
+		return;
+	}
+
+	parallel_request_start (request);
+	parallel_dispatch (queue);
+}
+
+/**
+ * parallel_dispatch:
+ * @queue: the queue
+ *
+ * Runs waiting parallel scripts until there are @max_parallel scripts
+ * running.
+ */
+static void
+parallel_dispatch (NMDispatcherQueue *queue)
+{
+	ScriptInfo *script;
+
+	while (queue->num_parallel_running < queue->max_parallel) {
+		script = g_queue_pop_head (queue->parallel_scripts_waiting);
+		if (!script)
+			return;
+
+		if (!script_dispatch (script)) {
+			/* the script failed to run. This might have been the
+			 * last script of its request. */
+			complete_request (script->request);
+		}
+	}
+}
+
+static void
+complete_script (ScriptInfo *script)
+{
+	NMDispatcherQueue *queue;
+	Request *request;
+	gboolean wait = script->wait;
+
+	request = script->request;
+	queue = request->queue;
+
+	if (script->type == NM_DISPATCHER_SCRIPT_TYPE_PARALLEL) {
+		/* parallel scripts only block their own request. Complete it,
+		 * if this was its last script, and use the free slot for the
+		 * next parallel script. */
+		complete_request (request);
+		parallel_dispatch (queue);
+		return;
+	}
+
+	if (wait) {
+		/* for "wait" scripts, try to schedule the next blocking script.
+		 * If that is successful, return (as we must wait for its completion). */
+		if (dispatch_one_script (request))
+			return;
+
+		/* the ordered scripts of @request are done. Parallel scripts of
+		 * @request might still be running, but they don't block the
+		 * ordered scripts of the next request. */
+		nm_assert (queue->current_request == request);
+		queue->current_request = NULL;
+	}
+
+	/* Try to complete the request. @request will be possibly free'd,
+	 * making @script and @request a dangling pointer. */
+	complete_request (request);
+
+	if (!wait) {
+		/* this was a "no-wait" script. We either completed the request,
+		 * or there is nothing to do. Especially, there is no need to
+		 * queue the next_request() -- because no-wait scripts don't block
+		 * requests. However, if this was the last "no-wait" script and
+		 * there are "wait" scripts ready to run, launch them.
+		 */
+		if (   queue->current_request == request
+		    && queue->current_request->num_scripts_nowait == 0) {
+
+			if (dispatch_one_script (queue->current_request))
+				return;
+
+			complete_request (queue->current_request);
+		} else
+			return;
+	} else {
+		/* if the script is a "wait" script, we already tried above to
+		 * dispatch the next script. As we didn't do that, it means we
+		 * just completed the last script of @request and we can continue
+		 * with the next request...
+		 *
+		 * Also, it cannot be that there is another request currently being
+		 * processed because only requests with "wait" scripts can become
+		 * @current_request. As there can only be one "wait" script running
+		 * at any time, it means complete_request() above completed @request. */
+		nm_assert (!queue->current_request);
+	}
+
+	while (next_request (queue, NULL)) {
+		request = queue->current_request;
+
+		if (dispatch_one_script (request))
+			return;
+
+		/* Try to complete the request. It will be either completed
+		 * now, or when all pending "no-wait" scripts return. */
+		complete_request (request);
+
+		/* We can immediately start next_request(), because our current
+		 * @request has obviously no more "wait" scripts either.
+		 * Repeat... */
+	}
+}
+
+static void
+script_terminated (ScriptInfo *script)
+{
+	Request *request = script->request;
+
+	request->num_scripts_done++;
+	switch (script->type) {
+	case NM_DISPATCHER_SCRIPT_TYPE_NO_WAIT:
+		request->num_scripts_nowait--;
+		break;
+	case NM_DISPATCHER_SCRIPT_TYPE_PARALLEL:
+		request->num_scripts_parallel--;
+		request->queue->num_parallel_running--;
+		break;
+	case NM_DISPATCHER_SCRIPT_TYPE_ORDERED:
+		break;
+	}
+}
+
+static void
+script_watch_cb (GPid pid, gint status, gpointer user_data)
+{
+	ScriptInfo *script = user_data;
+	guint err;
+
+	g_assert (pid == script->pid);
+
+	script->watch_id = 0;
+	nm_clear_g_source (&script->timeout_id);
+	script_terminated (script);
+
+	if (WIFEXITED (status)) {
+		err = WEXITSTATUS (status);
+		if (err == 0)
+			script->result = DISPATCH_RESULT_SUCCESS;
+		else {
+			script->error = g_strdup_printf ("Script '%s' exited with error status %d.",
+			                                 script->script, err);
+		}
+	} else if (WIFSTOPPED (status)) {
+		script->error = g_strdup_printf ("Script '%s' stopped unexpectedly with signal %d.",
+		                                 script->script, WSTOPSIG (status));
+	} else if (WIFSIGNALED (status)) {
+		script->error = g_strdup_printf ("Script '%s' died with signal %d",
+		                                 script->script, WTERMSIG (status));
+	} else {
+		script->error = g_strdup_printf ("Script '%s' died from an unknown cause",
+		                                 script->script);
+	}
+
+	if (script->result == DISPATCH_RESULT_SUCCESS) {
+		_LOG_S_D (script, "complete");
+	} else {
+		script->result = DISPATCH_RESULT_FAILED;
+		_LOG_S_W (script, "complete: failed with %s", script->error);
+	}
+
+	g_spawn_close_pid (script->pid);
+
+	complete_script (script);
+}
+
+static gboolean
+script_timeout_cb (gpointer user_data)
+{
+	ScriptInfo *script = user_data;
+
+	script->timeout_id = 0;
+	nm_clear_g_source (&script->watch_id);
+	script_terminated (script);
+
+	_LOG_S_W (script, "complete: timeout (kill script)");
+
+	kill (script->pid, SIGKILL);
+again:
+	if (waitpid (script->pid, NULL, 0) == -1) {
+		if (errno == EINTR)
+			goto again;
+	}
+
+	script->error = g_strdup_printf ("Script '%s' timed out.", script->script);
+	script->result = DISPATCH_RESULT_TIMEOUT;
+
+	g_spawn_close_pid (script->pid);
+
+	complete_script (script);
+
+	return FALSE;
+}
+
+#define SCRIPT_TIMEOUT 600  /* 10 minutes */
+
+static gboolean
+script_dispatch (ScriptInfo *script)
+{
+	GError *error = NULL;
+	gchar *argv[4];
+	Request *request = script->request;
+
+	if (script->dispatched)
+		return FALSE;
+
+	script->dispatched = TRUE;
+
+	argv[0] = script->script;
+	argv[1] = request->iface
+	          ? request->iface
+	          : (!strcmp (request->action, NMD_ACTION_HOSTNAME) ? "none" : "");
+	argv[2] = request->action;
+	argv[3] = NULL;
+
+	_LOG_S_D (script, "run script%s",
+	          script->type == NM_DISPATCHER_SCRIPT_TYPE_NO_WAIT
+	            ? " (no-wait)"
+	            : (script->type == NM_DISPATCHER_SCRIPT_TYPE_PARALLEL ? " (parallel)" : ""));
+
+	if (g_spawn_async ("/", argv, request->envp, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL, &script->pid, &error)) {
+		script->watch_id = g_child_watch_add (script->pid, (GChildWatchFunc) script_watch_cb, script);
+		script->timeout_id = g_timeout_add_seconds (SCRIPT_TIMEOUT, script_timeout_cb, script);
+		if (script->type == NM_DISPATCHER_SCRIPT_TYPE_NO_WAIT)
+			request->num_scripts_nowait++;
+		else if (script->type == NM_DISPATCHER_SCRIPT_TYPE_PARALLEL) {
+			request->num_scripts_parallel++;
+			request->queue->num_parallel_running++;
+		}
+		return TRUE;
+	} else {
+		_LOG_S_W (script, "complete: failed to execute script: %s", error->message);
+		script->result = DISPATCH_RESULT_EXEC_FAILED;
+		script->error = g_strdup (error->message);
+		request->num_scripts_done++;
+		g_clear_error (&error);
+		return FALSE;
+	}
+}
+
+static gboolean
+dispatch_one_script (Request *request)
+{
+	if (request->num_scripts_nowait > 0)
+		return TRUE;
+
+	while (request->idx < request->scripts->len) {
+		ScriptInfo *script;
+
+		script = g_ptr_array_index (request->scripts, request->idx++);
+		if (!script->wait)
+			continue;
+		if (script_dispatch (script))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+/*****************************************************************************/
+
+/**
+ * nm_dispatcher_queue_add_request:
+ * @queue: the queue
+ * @action: the dispatcher action
+ * @iface: (allow-none): the interface name
+ * @envp: (transfer full): the environment of the scripts
+ * @debug: whether to log the progress of the request
+ * @error_message: (allow-none): if set, the request is invalid and
+ *   completes right away without running any script.
+ * @scripts: the scripts to run, in order
+ * @n_scripts: the number of @scripts
+ * @complete_func: called once all scripts terminated
+ * @user_data: user data for @complete_func
+ *
+ * Enqueues a request. @complete_func may be called before this
+ * function returns, if there is nothing to run.
+ */
+void
+nm_dispatcher_queue_add_request (NMDispatcherQueue *queue,
+                                 const char *action,
+                                 const char *iface,
+                                 char **envp,
+                                 gboolean debug,
+                                 const char *error_message,
+                                 const NMDispatcherScript *scripts,
+                                 guint n_scripts,
+                                 NMDispatcherRequestCompleteFunc complete_func,
+                                 gpointer user_data)
+{
+	Request *request;
+	char **p;
+	guint i, num_nowait = 0, num_parallel = 0;
+
+	g_return_if_fail (queue);
+	g_return_if_fail (action);
+	g_return_if_fail (complete_func);
+
+	request = g_slice_new0 (Request);
+	request->request_id = ++queue->request_id_counter;
+	request->queue = queue;
+	request->debug = debug;
+	request->complete_func = complete_func;
+	request->complete_user_data = user_data;
+	request->action = g_strdup (action);
+	request->iface = g_strdup (iface);
+	request->envp = envp;
+
+	request->scripts = g_ptr_array_new_full (n_scripts, script_info_free);
+	for (i = 0; i < n_scripts; i++) {
+		ScriptInfo *s;
+
+		s = g_slice_new0 (ScriptInfo);
+		s->request = request;
+		s->script = g_strdup (scripts[i].path);
+		s->type = scripts[i].type;
+		s->wait = (s->type == NM_DISPATCHER_SCRIPT_TYPE_ORDERED);
+		g_ptr_array_add (request->scripts, s);
+	}
+
+	_LOG_R_I (request, "new request (%u scripts)", request->scripts->len);
+	if (   _LOG_R_D_enabled (request)
+	    && request->envp) {
+		for (p = request->envp; *p; p++)
+			_LOG_R_D (request, "environment: %s", *p);
+	}
+
+	if (error_message || request->scripts->len == 0) {
+		if (error_message)
+			_LOG_R_W (request, "completed: invalid request: %s", error_message);
+		else
+			_LOG_R_I (request, "completed: no scripts");
+
+		request->complete_func (g_variant_new_array (G_VARIANT_TYPE ("(sus)"), NULL, 0),
+		                        request->complete_user_data);
+		request->num_scripts_done = request->scripts->len;
+		request_free (request);
+		return;
+	}
+
+	queue->num_requests_pending++;
+
+	for (i = 0; i < request->scripts->len; i++) {
+		ScriptInfo *s = g_ptr_array_index (request->scripts, i);
+
+		if (s->type == NM_DISPATCHER_SCRIPT_TYPE_NO_WAIT) {
+			script_dispatch (s);
+			num_nowait++;
+		} else if (s->type == NM_DISPATCHER_SCRIPT_TYPE_PARALLEL)
+			num_parallel++;
+	}
+
+	if (num_parallel > 0) {
+		/* only enqueue the parallel scripts for now. They are started
+		 * below, after the ordered scripts are scheduled, because
+		 * a failure to start them might complete @request. */
+		request->has_parallel = TRUE;
+		parallel_request_add (queue, request);
+	}
+
+	if (num_nowait + num_parallel < request->scripts->len) {
+		/* The request has at least one wait script.
+		 * Try next_request() to schedule the request for
+		 * execution. This either enqueues the request or
+		 * sets it as queue->current_request. */
+		if (next_request (queue, request)) {
+			/* @request is now @current_request. Go ahead and
+			 * schedule the first wait script. */
+			if (!dispatch_one_script (request)) {
+				/* If that fails, we might be already finished with the
+				 * request. Try complete_request(). */
+				complete_request (request);
+
+				if (next_request (queue, NULL)) {
+					/* As @request was successfully scheduled as next_request(), there is no
+					 * other request in queue that can be scheduled afterwards. Assert against
+					 * that, but call next_request() to clear current_request. */
+					g_assert_not_reached ();
+				}
+			}
+		}
+	} else {
+		/* The request contains only no-wait scripts. Try to complete
+		 * the request right away (we might have failed to schedule any
+		 * of the scripts). It will be either completed now, or later
+		 * when the pending scripts return.
+		 * We don't enqueue it to queue->requests_waiting.
+		 * There is no need to handle next_request(), because @request is
+		 * not the current request anyway and does not interfere with requests
+		 * that have any "wait" scripts. */
+		complete_request (request);
+	}
+
+	if (num_parallel > 0)
+		parallel_dispatch (queue);
+}
+
+guint
+nm_dispatcher_queue_get_num_pending (NMDispatcherQueue *queue)
+{
+	g_return_val_if_fail (queue, 0);
+
+	return queue->num_requests_pending;
+}
+
+NMDispatcherQueue *
+nm_dispatcher_queue_new (guint max_parallel,
+                         NMDispatcherQueueIdleFunc idle_func,
+                         gpointer user_data)
+{
+	NMDispatcherQueue *queue;
+
+	queue = g_slice_new0 (NMDispatcherQueue);
+	queue->max_parallel = MAX (max_parallel, 1u);
+	queue->idle_func = idle_func;
+	queue->idle_user_data = user_data;
+	queue->requests_waiting = g_queue_new ();
+	queue->parallel_requests = g_hash_table_new_full (g_str_hash, g_str_equal,
+	                                                  g_free, (GDestroyNotify) g_queue_free);
+	queue->parallel_scripts_waiting = g_queue_new ();
+	return queue;
+}
+
+/**
+ * nm_dispatcher_queue_free:
+ * @queue: the queue
+ *
+ * Frees @queue. Pending requests are leaked, the dispatcher only
+ * frees the queue when it exits.
+ */
+void
+nm_dispatcher_queue_free (NMDispatcherQueue *queue)
+{
+	g_return_if_fail (queue);
+
+	g_queue_free (queue->requests_waiting);
+	g_queue_free (queue->parallel_scripts_waiting);
+	g_hash_table_unref (queue->parallel_requests);
+	g_slice_free (NMDispatcherQueue, queue);
+}
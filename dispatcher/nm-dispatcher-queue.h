@@ -0,0 +1,82 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2008 - 2018 Red Hat, Inc.
+ */
+
+#ifndef __NETWORKMANAGER_DISPATCHER_QUEUE_H__
+#define __NETWORKMANAGER_DISPATCHER_QUEUE_H__
+
+/* At most that many scripts from parallel.d run at the same time. */
+#define NM_DISPATCHER_MAX_PARALLEL 8
+
+typedef enum {
+	/* run one at a time, across all requests. */
+	NM_DISPATCHER_SCRIPT_TYPE_ORDERED,
+	/* run right away. */
+	NM_DISPATCHER_SCRIPT_TYPE_NO_WAIT,
+	/* run concurrently, after the parallel scripts of the previous
+	 * requests for the same interface. */
+	NM_DISPATCHER_SCRIPT_TYPE_PARALLEL,
+} NMDispatcherScriptType;
+
+typedef struct {
+	const char *path;
+	NMDispatcherScriptType type;
+} NMDispatcherScript;
+
+typedef struct _NMDispatcherQueue NMDispatcherQueue;
+
+/**
+ * NMDispatcherRequestCompleteFunc:
+ * @results: a floating #GVariant of type "a(sus)" with the path,
+ *   the #DispatchResult and the error message of each script.
+ * @user_data: the user data of the request.
+ */
+typedef void (*NMDispatcherRequestCompleteFunc) (GVariant *results,
+                                                 gpointer user_data);
+
+/**
+ * NMDispatcherQueueIdleFunc:
+ * @queue: the queue
+ * @user_data: the user data of the queue.
+ *
+ * Called whenever the last pending request completed.
+ */
+typedef void (*NMDispatcherQueueIdleFunc) (NMDispatcherQueue *queue,
+                                           gpointer user_data);
+
+NMDispatcherQueue *nm_dispatcher_queue_new (guint max_parallel,
+                                            NMDispatcherQueueIdleFunc idle_func,
+                                            gpointer user_data);
+
+void nm_dispatcher_queue_free (NMDispatcherQueue *queue);
+
+guint nm_dispatcher_queue_get_num_pending (NMDispatcherQueue *queue);
+
+void nm_dispatcher_queue_add_request (NMDispatcherQueue *queue,
+                                      const char *action,
+                                      const char *iface,
+                                      char **envp,
+                                      gboolean debug,
+                                      const char *error_message,
+                                      const NMDispatcherScript *scripts,
+                                      guint n_scripts,
+                                      NMDispatcherRequestCompleteFunc complete_func,
+                                      gpointer user_data);
+
+#endif  /* __NETWORKMANAGER_DISPATCHER_QUEUE_H__ */
@@ -0,0 +1,537 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2018 Red Hat, Inc.
+ *
+ */
+
+#include "nm-default.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "nm-dispatcher-queue.h"
+#include "nm-dispatcher-api.h"
+
+#include "nm-utils/nm-test-utils.h"
+
+/*****************************************************************************/
+
+/* a dispatcher script. It appends "start <name> <iface> <action>" to "log",
+ * waits until the file "gate <name> <iface> <action>" exists, appends
+ * "end ..." and exits with $EXIT. */
+#define SCRIPT \
+	"#!/bin/sh\n" \
+	"dir=\"${0%/*}\"\n" \
+	"name=\"${0##*/} $1 $2\"\n" \
+	"echo \"start $name\" >> \"$dir/log\"\n" \
+	"while [ ! -e \"$dir/gate $name\" ]; do sleep 0.01; done\n" \
+	"echo \"end $name\" >> \"$dir/log\"\n" \
+	"exit ${EXIT:-0}\n"
+
+#define STRV(...)  ((const char *const[]) { __VA_ARGS__, NULL })
+#define STRV_EMPTY ((const char *const[]) { NULL })
+
+typedef struct {
+	char *dir;
+	GMainLoop *loop;
+	NMDispatcherQueue *queue;
+	guint num_idle;
+
+	/* the names of the completed requests, in order. */
+	GPtrArray *completed;
+	/* the results of the completed requests, by name. */
+	GHashTable *results;
+} TestData;
+
+typedef struct {
+	TestData *td;
+	char *name;
+} RequestData;
+
+static char *
+_path (TestData *td, const char *name)
+{
+	return g_build_filename (td->dir, name, NULL);
+}
+
+static void
+_idle_cb (NMDispatcherQueue *queue, gpointer user_data)
+{
+	TestData *td = user_data;
+
+	td->num_idle++;
+}
+
+static RequestData *
+_request_data_new (TestData *td, const char *name)
+{
+	RequestData *rd;
+
+	rd = g_slice_new0 (RequestData);
+	rd->td = td;
+	rd->name = g_strdup (name);
+	return rd;
+}
+
+static void
+_complete_cb (GVariant *results, gpointer user_data)
+{
+	RequestData *rd = user_data;
+	TestData *td = rd->td;
+
+	g_assert (g_variant_is_floating (results));
+	g_assert (g_variant_is_of_type (results, G_VARIANT_TYPE ("a(sus)")));
+	g_assert (!g_hash_table_contains (td->results, rd->name));
+
+	g_hash_table_insert (td->results, g_strdup (rd->name), g_variant_ref_sink (results));
+	g_ptr_array_add (td->completed, rd->name);
+	g_slice_free (RequestData, rd);
+
+	g_main_loop_quit (td->loop);
+}
+
+/* @scripts is a space separated list of "name:type", where type is
+ * 'o' (ordered), 'n' (no-wait) or 'p' (parallel). Names are relative
+ * to the test directory. */
+static void
+_add_request (TestData *td,
+              const char *name,
+              const char *iface,
+              const char *action,
+              const char *scripts,
+              int exit_status)
+{
+	gs_strfreev char **tokens = g_strsplit (scripts, " ", -1);
+	gs_free NMDispatcherScript *s = g_new0 (NMDispatcherScript, g_strv_length (tokens));
+	gs_unref_ptrarray GPtrArray *paths = g_ptr_array_new_with_free_func (g_free);
+	char **envp;
+	guint i;
+
+	for (i = 0; tokens[i]; i++) {
+		char *type = strchr (tokens[i], ':');
+		char *path;
+
+		g_assert (type && type[1] && !type[2]);
+		*(type++) = '\0';
+		path = _path (td, tokens[i]);
+		g_ptr_array_add (paths, path);
+		s[i].path = path;
+		switch (type[0]) {
+		case 'o':
+			s[i].type = NM_DISPATCHER_SCRIPT_TYPE_ORDERED;
+			break;
+		case 'n':
+			s[i].type = NM_DISPATCHER_SCRIPT_TYPE_NO_WAIT;
+			break;
+		case 'p':
+			s[i].type = NM_DISPATCHER_SCRIPT_TYPE_PARALLEL;
+			break;
+		default:
+			g_assert_not_reached ();
+		}
+	}
+
+	envp = g_new0 (char *, 3);
+	envp[0] = g_strdup_printf ("PATH=%s", g_getenv ("PATH") ?: "/usr/bin:/bin");
+	envp[1] = g_strdup_printf ("EXIT=%d", exit_status);
+
+	nm_dispatcher_queue_add_request (td->queue, action, iface, envp, FALSE, NULL,
+	                                 s, i, _complete_cb, _request_data_new (td, name));
+}
+
+static void
+_write_script (TestData *td, const char *name)
+{
+	gs_free char *path = _path (td, name);
+	GError *error = NULL;
+
+	nmtst_assert_success (g_file_set_contents (path, SCRIPT, -1, &error), error);
+	g_assert_cmpint (chmod (path, 0755), ==, 0);
+}
+
+static void
+_open_gate (TestData *td, const char *name)
+{
+	gs_free char *gate = g_strdup_printf ("gate %s", name);
+	gs_free char *path = _path (td, gate);
+	GError *error = NULL;
+
+	nmtst_assert_success (g_file_set_contents (path, "", 0, &error), error);
+}
+
+/* runs the main loop for @timeout_ms, even if it gets quit. */
+static void
+_run (TestData *td, int timeout_ms)
+{
+	gint64 deadline = g_get_monotonic_time () + timeout_ms * 1000;
+	gint64 now;
+
+	while ((now = g_get_monotonic_time ()) < deadline)
+		nmtst_main_loop_run (td->loop, NM_MAX ((deadline - now) / 1000, 1));
+}
+
+static char *
+_strv_join_sorted (const char *const *strv)
+{
+	gs_free const char **copy = NULL;
+	guint n = NM_PTRARRAY_LEN (strv);
+
+	/* scripts that run at the same time may log in any order. */
+	copy = g_new (const char *, n + 1);
+	memcpy (copy, strv, (n + 1) * sizeof (char *));
+	qsort (copy, n, sizeof (char *), nm_strcmp_p);
+	return g_strjoinv ("\n", (char **) copy);
+}
+
+static char *
+_read_log_sorted (TestData *td)
+{
+	gs_free char *path = _path (td, "log");
+	gs_free char *contents = NULL;
+	gs_strfreev char **lines = NULL;
+
+	if (!g_file_get_contents (path, &contents, NULL, NULL))
+		return g_strdup ("");
+
+	lines = g_strsplit (g_strchomp (contents), "\n", -1);
+	return _strv_join_sorted ((const char *const *) lines);
+}
+
+/* waits until the log contains exactly the @expected lines, and
+ * checks that no other script starts shortly after. */
+static void
+_assert_log (TestData *td, const char *const *expected)
+{
+	gs_free char *expected_str = _strv_join_sorted (expected);
+	gint64 deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+
+	while (TRUE) {
+		gs_free char *log = _read_log_sorted (td);
+
+		if (nm_streq (log, expected_str))
+			break;
+		if (g_get_monotonic_time () >= deadline)
+			g_assert_cmpstr (log, ==, expected_str);
+		_run (td, 10);
+	}
+
+	_run (td, 100);
+	{
+		gs_free char *log = _read_log_sorted (td);
+
+		g_assert_cmpstr (log, ==, expected_str);
+	}
+}
+
+static void
+_wait_completed (TestData *td, guint n)
+{
+	while (td->completed->len < n)
+		g_assert (nmtst_main_loop_run (td->loop, 5000));
+}
+
+/* checks the completed requests, in order. */
+static void
+_assert_completed (TestData *td, const char *const *expected)
+{
+	guint i;
+
+	g_assert_cmpint (td->completed->len, ==, NM_PTRARRAY_LEN (expected));
+	for (i = 0; expected[i]; i++)
+		g_assert_cmpstr (td->completed->pdata[i], ==, expected[i]);
+}
+
+/* checks the results of @request. @expected has the DispatchResult
+ * for each of the scripts in @names. */
+static void
+_assert_results (TestData *td,
+                 const char *request,
+                 const char *const *names,
+                 const DispatchResult *expected)
+{
+	GVariant *results = g_hash_table_lookup (td->results, request);
+	guint i;
+
+	g_assert (results);
+	g_assert_cmpint (g_variant_n_children (results), ==, NM_PTRARRAY_LEN (names));
+	for (i = 0; names[i]; i++) {
+		gs_free char *path = _path (td, names[i]);
+		const char *script, *error;
+		guint32 result;
+
+		g_variant_get_child (results, i, "(&su&s)", &script, &result, &error);
+		g_assert_cmpstr (script, ==, path);
+		g_assert_cmpint (result, ==, expected[i]);
+		if (result == DISPATCH_RESULT_SUCCESS)
+			g_assert_cmpstr (error, ==, "");
+		else
+			g_assert (error[0]);
+	}
+}
+
+static void
+_setup (TestData *td, guint max_parallel)
+{
+	GError *error = NULL;
+
+	td->dir = g_dir_make_tmp ("test-dispatcher-queue-XXXXXX", &error);
+	nmtst_assert_success (td->dir, error);
+	td->loop = g_main_loop_new (NULL, FALSE);
+	td->completed = g_ptr_array_new_with_free_func (g_free);
+	td->results = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+	td->queue = nm_dispatcher_queue_new (max_parallel, _idle_cb, td);
+
+	_write_script (td, "10-a");
+	_write_script (td, "20-b");
+	_write_script (td, "nw");
+	_write_script (td, "par");
+	_write_script (td, "par2");
+}
+
+static void
+_teardown (TestData *td)
+{
+	GDir *dir;
+	const char *name;
+
+	g_assert_cmpint (nm_dispatcher_queue_get_num_pending (td->queue), ==, 0);
+	nm_dispatcher_queue_free (td->queue);
+
+	dir = g_dir_open (td->dir, 0, NULL);
+	g_assert (dir);
+	while ((name = g_dir_read_name (dir))) {
+		gs_free char *path = _path (td, name);
+
+		g_assert_cmpint (unlink (path), ==, 0);
+	}
+	g_dir_close (dir);
+	g_assert_cmpint (rmdir (td->dir), ==, 0);
+
+	g_hash_table_unref (td->results);
+	g_ptr_array_unref (td->completed);
+	g_main_loop_unref (td->loop);
+	g_free (td->dir);
+}
+
+/*****************************************************************************/
+
+static void
+test_ordered (void)
+{
+	TestData td_data = { 0 };
+	TestData *const td = &td_data;
+
+	_setup (td, NM_DISPATCHER_MAX_PARALLEL);
+
+	_add_request (td, "r1", "eth0", "up", "10-a:o 20-b:o", 0);
+	_add_request (td, "r2", "eth1", "up", "10-a:o", 0);
+	g_assert_cmpint (nm_dispatcher_queue_get_num_pending (td->queue), ==, 2);
+
+	/* ordered scripts run one at a time, even for other interfaces. */
+	_assert_log (td, STRV ("start 10-a eth0 up"));
+
+	_open_gate (td, "10-a eth0 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "end 10-a eth0 up",
+	                       "start 20-b eth0 up"));
+	_assert_completed (td, STRV_EMPTY);
+
+	_open_gate (td, "20-b eth0 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "end 10-a eth0 up",
+	                       "start 20-b eth0 up", "end 20-b eth0 up",
+	                       "start 10-a eth1 up"));
+	_assert_completed (td, STRV ("r1"));
+	g_assert_cmpint (td->num_idle, ==, 0);
+
+	_open_gate (td, "10-a eth1 up");
+	_wait_completed (td, 2);
+	_assert_completed (td, STRV ("r1", "r2"));
+	g_assert_cmpint (td->num_idle, ==, 1);
+
+	_assert_results (td, "r1", STRV ("10-a", "20-b"),
+	                 (DispatchResult []) { DISPATCH_RESULT_SUCCESS, DISPATCH_RESULT_SUCCESS });
+	_assert_results (td, "r2", STRV ("10-a"),
+	                 (DispatchResult []) { DISPATCH_RESULT_SUCCESS });
+
+	_teardown (td);
+}
+
+static void
+test_no_wait (void)
+{
+	TestData td_data = { 0 };
+	TestData *const td = &td_data;
+
+	_setup (td, NM_DISPATCHER_MAX_PARALLEL);
+
+	/* no-wait scripts start right away. The ordered scripts of a request
+	 * wait for its no-wait scripts, but other requests don't. */
+	_add_request (td, "r1", "eth0", "up", "10-a:o nw:n", 0);
+	_add_request (td, "r2", "eth1", "up", "nw:n", 0);
+	_assert_log (td, STRV ("start nw eth0 up", "start nw eth1 up"));
+
+	_open_gate (td, "nw eth1 up");
+	_assert_log (td, STRV ("start nw eth0 up", "start nw eth1 up",
+	                       "end nw eth1 up"));
+	_assert_completed (td, STRV ("r2"));
+
+	_open_gate (td, "nw eth0 up");
+	_assert_log (td, STRV ("start nw eth0 up", "start nw eth1 up",
+	                       "end nw eth1 up", "end nw eth0 up",
+	                       "start 10-a eth0 up"));
+	_assert_completed (td, STRV ("r2"));
+
+	_open_gate (td, "10-a eth0 up");
+	_wait_completed (td, 2);
+	_assert_completed (td, STRV ("r2", "r1"));
+	g_assert_cmpint (td->num_idle, ==, 1);
+
+	_assert_results (td, "r1", STRV ("10-a", "nw"),
+	                 (DispatchResult []) { DISPATCH_RESULT_SUCCESS, DISPATCH_RESULT_SUCCESS });
+
+	_teardown (td);
+}
+
+static void
+test_parallel (void)
+{
+	TestData td_data = { 0 };
+	TestData *const td = &td_data;
+
+	_setup (td, 2);
+
+	_add_request (td, "r1", "eth0", "up", "10-a:o par:p", 0);
+	_add_request (td, "r2", "eth0", "down", "par:p", 0);
+	_add_request (td, "r3", "eth1", "up", "par:p", 0);
+	_add_request (td, "r4", "eth2", "up", "par:p par2:p", 0);
+	_add_request (td, "r5", "eth3", "up", "20-b:o", 0);
+
+	/* the parallel scripts of r2 wait for the ones of r1 on the same
+	 * interface. r4 waits for a free slot, and r5 for the ordered
+	 * script of r1. */
+	_assert_log (td, STRV ("start 10-a eth0 up", "start par eth0 up",
+	                       "start par eth1 up"));
+
+	/* a free slot is used by the next waiting parallel script. */
+	_open_gate (td, "par eth1 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "start par eth0 up",
+	                       "start par eth1 up", "end par eth1 up",
+	                       "start par eth2 up"));
+	_assert_completed (td, STRV ("r3"));
+
+	/* r1 is not complete yet, so r2 still waits, and the slot goes to r4. */
+	_open_gate (td, "par eth0 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "start par eth0 up",
+	                       "start par eth1 up", "end par eth1 up",
+	                       "start par eth2 up", "end par eth0 up",
+	                       "start par2 eth2 up"));
+	_assert_completed (td, STRV ("r3"));
+
+	/* the end of the ordered script of r1 starts the one of r5, even
+	 * though parallel scripts still run. The parallel script of r2
+	 * now waits for a free slot. */
+	_open_gate (td, "10-a eth0 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "start par eth0 up",
+	                       "start par eth1 up", "end par eth1 up",
+	                       "start par eth2 up", "end par eth0 up",
+	                       "start par2 eth2 up", "end 10-a eth0 up",
+	                       "start 20-b eth3 up"));
+	_assert_completed (td, STRV ("r3", "r1"));
+
+	_open_gate (td, "par eth2 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "start par eth0 up",
+	                       "start par eth1 up", "end par eth1 up",
+	                       "start par eth2 up", "end par eth0 up",
+	                       "start par2 eth2 up", "end 10-a eth0 up",
+	                       "start 20-b eth3 up", "end par eth2 up",
+	                       "start par eth0 down"));
+	_assert_completed (td, STRV ("r3", "r1"));
+
+	_open_gate (td, "20-b eth3 up");
+	_open_gate (td, "par2 eth2 up");
+	_open_gate (td, "par eth0 down");
+	_wait_completed (td, 5);
+	g_assert_cmpint (td->num_idle, ==, 1);
+
+	_assert_results (td, "r1", STRV ("10-a", "par"),
+	                 (DispatchResult []) { DISPATCH_RESULT_SUCCESS, DISPATCH_RESULT_SUCCESS });
+	_assert_results (td, "r4", STRV ("par", "par2"),
+	                 (DispatchResult []) { DISPATCH_RESULT_SUCCESS, DISPATCH_RESULT_SUCCESS });
+
+	_teardown (td);
+}
+
+static void
+test_results (void)
+{
+	TestData td_data = { 0 };
+	TestData *const td = &td_data;
+
+	_setup (td, NM_DISPATCHER_MAX_PARALLEL);
+
+	/* the results are in the order of the scripts, whatever the
+	 * order they terminate in. */
+	g_test_expect_message ("nm-dispatcher", G_LOG_LEVEL_WARNING, "*\"*/10-a\": complete: failed with Script '*/10-a' exited with error status 3.");
+	g_test_expect_message ("nm-dispatcher", G_LOG_LEVEL_WARNING, "*\"*/missing\": complete: failed to execute script: *");
+	_add_request (td, "r1", "eth0", "up", "10-a:o missing:o par:p", 3);
+	_open_gate (td, "10-a eth0 up");
+	_assert_log (td, STRV ("start 10-a eth0 up", "start par eth0 up", "end 10-a eth0 up"));
+	g_test_assert_expected_messages ();
+	_assert_completed (td, STRV_EMPTY);
+
+	g_test_expect_message ("nm-dispatcher", G_LOG_LEVEL_WARNING, "*\"*/par\": complete: failed with Script '*/par' exited with error status 3.");
+	_open_gate (td, "par eth0 up");
+	_wait_completed (td, 1);
+	g_test_assert_expected_messages ();
+
+	_assert_results (td, "r1", STRV ("10-a", "missing", "par"),
+	                 (DispatchResult []) { DISPATCH_RESULT_FAILED,
+	                                       DISPATCH_RESULT_EXEC_FAILED,
+	                                       DISPATCH_RESULT_FAILED });
+
+	/* requests without scripts, or invalid ones, complete right away,
+	 * without ever becoming pending. */
+	g_test_expect_message ("nm-dispatcher", G_LOG_LEVEL_WARNING, "*completed: invalid request: no interface");
+	nm_dispatcher_queue_add_request (td->queue, "up", "eth0", NULL, FALSE, "no interface",
+	                                 (NMDispatcherScript []) { { "/bin/true", NM_DISPATCHER_SCRIPT_TYPE_ORDERED } }, 1,
+	                                 _complete_cb, _request_data_new (td, "r2"));
+	g_test_assert_expected_messages ();
+	_add_request (td, "r3", "eth0", "up", "", 0);
+	_assert_completed (td, STRV ("r1", "r2", "r3"));
+	_assert_results (td, "r2", STRV_EMPTY, NULL);
+	_assert_results (td, "r3", STRV_EMPTY, NULL);
+	g_assert_cmpint (td->num_idle, ==, 1);
+
+	_teardown (td);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init (&argc, &argv, TRUE);
+
+	g_test_add_func ("/dispatcher/queue/ordered", test_ordered);
+	g_test_add_func ("/dispatcher/queue/no-wait", test_no_wait);
+	g_test_add_func ("/dispatcher/queue/parallel", test_parallel);
+	g_test_add_func ("/dispatcher/queue/results", test_results);
+
+	return g_test_run ();
+}
@@ -204,6 +204,54 @@ test_nm_hash (void)
 	g_assert_cmpint (NM_HASH_COMBINE_BOOLS (guint16, 1, 0, 0, 1, 1, 0, 0, 0, 1), ==, 0x131);
 }
 
+static guint
+_test_hash_fast (guint seed, int ifindex, guint8 plen, guint32 metric, const char *buf, gsize len)
+{
+	NMHashState h;
+
+	nm_hash_init_fast (&h, seed);
+	nm_hash_update_vals (&h, ifindex, plen, metric);
+	if (len > 0)
+		nm_hash_update (&h, buf, len);
+	return nm_hash_complete (&h);
+}
+
+static void
+test_nm_hash_fast (void)
+{
+	const char buf[] = "0123456789abcdefghij";
+	GHashTable *seen;
+	guint h;
+	gsize len;
+	int i;
+
+	/* the hash is stable within the process. */
+	g_assert_cmpint (_test_hash_fast (1, 5, 24, 100, NULL, 0), ==, _test_hash_fast (1, 5, 24, 100, NULL, 0));
+
+	/* every value and the seed contribute to the hash. Collisions are possible
+	 * in principle, but not for these few values. */
+	h = _test_hash_fast (1, 5, 24, 100, NULL, 0);
+	g_assert (h);
+	g_assert_cmpint (h, !=, _test_hash_fast (2, 5, 24, 100, NULL, 0));
+	g_assert_cmpint (h, !=, _test_hash_fast (1, 6, 24, 100, NULL, 0));
+	g_assert_cmpint (h, !=, _test_hash_fast (1, 5, 25, 100, NULL, 0));
+	g_assert_cmpint (h, !=, _test_hash_fast (1, 5, 24, 101, NULL, 0));
+
+	/* trailing bytes that are not a multiple of 8 are hashed, including their length. */
+	seen = g_hash_table_new (NULL, NULL);
+	for (len = 0; len <= sizeof (buf); len++) {
+		h = _test_hash_fast (1, 5, 24, 100, buf, len);
+		g_assert (!g_hash_table_contains (seen, GUINT_TO_POINTER (h)));
+		g_hash_table_add (seen, GUINT_TO_POINTER (h));
+	}
+	for (i = 0; i < 100; i++) {
+		h = _test_hash_fast (1, i, 24, 100, NULL, 0);
+		g_assert (!g_hash_table_contains (seen, GUINT_TO_POINTER (h)));
+		g_hash_table_add (seen, GUINT_TO_POINTER (h));
+	}
+	g_hash_table_unref (seen);
+}
+
 /*****************************************************************************/
 
 static void
@@ -6882,6 +6930,7 @@ int main (int argc, char **argv)
 	nmtst_init (&argc, &argv, TRUE);
 
 	g_test_add_func ("/core/general/test_nm_hash", test_nm_hash);
+	g_test_add_func ("/core/general/test_nm_hash_fast", test_nm_hash_fast);
 	g_test_add_func ("/core/general/test_nm_g_slice_free_fcn", test_nm_g_slice_free_fcn);
 	g_test_add_func ("/core/general/test_c_list_sort", test_c_list_sort);
 	g_test_add_func ("/core/general/test_dedup_multi", test_dedup_multi);
@@ -1040,19 +1040,18 @@ init_if (GDBusProxy *proxy, NMObject *self)
 	gchar **props;
 	char **prop;
 	GVariant *val;
-	gchar *str;
 
 	nm_assert (G_IS_DBUS_PROXY (proxy));
 	nm_assert (NM_IS_OBJECT (self));
 
+	/* The properties were already delivered by the object manager's
+	 * GetManagedObjects() reply; take them from the proxy cache. */
 	props = g_dbus_proxy_get_cached_property_names (proxy);
 
 	for (prop = props; prop && *prop; prop++) {
 		val = g_dbus_proxy_get_cached_property (proxy, *prop);
-		str = g_variant_print (val, TRUE);
 		handle_property_changed (self, *prop, val);
 		g_variant_unref (val);
-		g_free (str);
 	}
 
 	g_strfreev (props);
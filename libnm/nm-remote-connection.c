@@ -679,25 +679,274 @@ replace_settings (NMRemoteConnection *self, GVariant *new_settings)
 		g_clear_error (&error);
 }
 
+/*****************************************************************************/
+
+/* The GetSettings requests of all connections that get initialized or updated
+ * in the same main loop iteration are combined into GetAllSettings calls on
+ * the Settings object. This saves one round trip per connection when there
+ * are many of them. Requests are only combined with others of the same
+ * thread default main context, because that is where their D-Bus calls
+ * complete. */
+
+#define GET_SETTINGS_BATCH_MAX 500
+
+/* @settings is %NULL if the connection is not visible to the user.
+ * @error is only set if the request was cancelled. */
+typedef void (*GetSettingsCallback) (NMRemoteConnection *self,
+                                     GVariant *settings,
+                                     GError *error,
+                                     gpointer user_data);
+
+typedef struct {
+	NMRemoteConnection *self;
+	GCancellable *cancellable;
+	GetSettingsCallback callback;
+	gpointer user_data;
+} GetSettingsRequest;
+
+typedef struct {
+	GMainContext *context;
+	GPtrArray *requests;
+} GetSettingsQueue;
+
+static struct {
+	GMutex lock;
+
+	/* GMainContext -> GetSettingsQueue, for the contexts with a
+	 * pending dispatch. */
+	GHashTable *queues;
+
+	/* the daemon doesn't implement GetAllSettings. */
+	volatile gint unsupported;
+} _get_settings;
+
+static void
+_get_settings_request_complete (GetSettingsRequest *request, GVariant *settings)
+{
+	gs_free_error GError *error = NULL;
+
+	if (g_cancellable_set_error_if_cancelled (request->cancellable, &error))
+		settings = NULL;
+
+	request->callback (request->self, settings, error, request->user_data);
+	g_object_unref (request->self);
+	g_clear_object (&request->cancellable);
+	g_slice_free (GetSettingsRequest, request);
+}
+
 static void
-updated_get_settings_cb (GObject *proxy,
+_get_settings_single_cb (GObject *proxy,
                          GAsyncResult *result,
                          gpointer user_data)
 {
-	NMRemoteConnection *self = user_data;
+	GetSettingsRequest *request = user_data;
+	gs_unref_variant GVariant *settings = NULL;
+
+	/* on failure, @settings stays %NULL: the connection is not visible,
+	 * unless the request was cancelled. */
+	nmdbus_settings_connection_call_get_settings_finish (NMDBUS_SETTINGS_CONNECTION (proxy),
+	                                                     &settings,
+	                                                     result,
+	                                                     NULL);
+	_get_settings_request_complete (request, settings);
+}
+
+static void
+_get_settings_single (GetSettingsRequest *request)
+{
+	nmdbus_settings_connection_call_get_settings (NM_REMOTE_CONNECTION_GET_PRIVATE (request->self)->proxy,
+	                                              request->cancellable,
+	                                              _get_settings_single_cb,
+	                                              request);
+}
+
+static void
+_get_all_settings_cb (GObject *source,
+                      GAsyncResult *result,
+                      gpointer user_data)
+{
+	gs_unref_ptrarray GPtrArray *requests = user_data;
+	gs_unref_variant GVariant *ret = NULL;
+	gs_unref_variant GVariant *all_settings = NULL;
+	gs_unref_hashtable GHashTable *by_path = NULL;
+	gs_free_error GError *error = NULL;
+	GVariantIter iter;
+	const char *path;
+	GVariant *settings;
+	guint i;
+
+	ret = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &error);
+	if (!ret) {
+		if (g_error_matches (error, G_DBUS_ERROR, G_DBUS_ERROR_UNKNOWN_METHOD))
+			g_atomic_int_set (&_get_settings.unsupported, TRUE);
+		for (i = 0; i < requests->len; i++) {
+			GetSettingsRequest *request = requests->pdata[i];
+
+			if (g_cancellable_is_cancelled (request->cancellable))
+				_get_settings_request_complete (request, NULL);
+			else
+				_get_settings_single (request);
+		}
+		return;
+	}
+
+	by_path = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+	all_settings = g_variant_get_child_value (ret, 0);
+	g_variant_iter_init (&iter, all_settings);
+	while (g_variant_iter_next (&iter, "{&o@a{sa{sv}}}", &path, &settings))
+		g_hash_table_insert (by_path, (gpointer) path, settings);
+
+	for (i = 0; i < requests->len; i++) {
+		GetSettingsRequest *request = requests->pdata[i];
+
+		path = nm_object_get_path (NM_OBJECT (request->self));
+		_get_settings_request_complete (request, g_hash_table_lookup (by_path, path));
+	}
+}
+
+static void
+_get_all_settings_call (GPtrArray *requests)
+{
+	GDBusProxy *proxy = G_DBUS_PROXY (NM_REMOTE_CONNECTION_GET_PRIVATE (((GetSettingsRequest *) requests->pdata[0])->self)->proxy);
+	gs_free const char **paths = NULL;
+	guint i;
+
+	paths = g_new (const char *, requests->len);
+	for (i = 0; i < requests->len; i++)
+		paths[i] = nm_object_get_path (NM_OBJECT (((GetSettingsRequest *) requests->pdata[i])->self));
+
+	/* the requests have their own cancellables, so the call itself is not
+	 * cancelled. A cancelled request completes when the reply arrives. */
+	g_dbus_connection_call (g_dbus_proxy_get_connection (proxy),
+	                        g_dbus_proxy_get_name (proxy),
+	                        NM_DBUS_PATH_SETTINGS,
+	                        NM_DBUS_INTERFACE_SETTINGS,
+	                        "GetAllSettings",
+	                        g_variant_new ("(@ao)", g_variant_new_objv (paths, requests->len)),
+	                        G_VARIANT_TYPE ("(a{oa{sa{sv}}})"),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        -1,
+	                        NULL,
+	                        _get_all_settings_cb,
+	                        requests);
+}
+
+static gboolean
+_get_settings_dispatch (gpointer user_data)
+{
+	GetSettingsQueue *queue = user_data;
+	gs_unref_ptrarray GPtrArray *requests = NULL;
+	GPtrArray *batch = NULL;
+	GDBusConnection *batch_dbus_connection = NULL;
+	guint i;
+
+	g_mutex_lock (&_get_settings.lock);
+	g_hash_table_remove (_get_settings.queues, queue->context);
+	g_mutex_unlock (&_get_settings.lock);
+
+	requests = queue->requests;
+	g_main_context_unref (queue->context);
+	g_slice_free (GetSettingsQueue, queue);
+
+	for (i = 0; i < requests->len; i++) {
+		GetSettingsRequest *request = requests->pdata[i];
+		GDBusConnection *dbus_connection;
+
+		if (g_cancellable_is_cancelled (request->cancellable)) {
+			_get_settings_request_complete (request, NULL);
+			continue;
+		}
+
+		if (g_atomic_int_get (&_get_settings.unsupported)) {
+			_get_settings_single (request);
+			continue;
+		}
+
+		/* connections of different clients might use different buses. */
+		dbus_connection = g_dbus_proxy_get_connection (G_DBUS_PROXY (NM_REMOTE_CONNECTION_GET_PRIVATE (request->self)->proxy));
+		if (   batch
+		    && (   batch_dbus_connection != dbus_connection
+		        || batch->len >= GET_SETTINGS_BATCH_MAX))
+			_get_all_settings_call (g_steal_pointer (&batch));
+		if (!batch) {
+			batch = g_ptr_array_new ();
+			batch_dbus_connection = dbus_connection;
+		}
+		g_ptr_array_add (batch, request);
+	}
+	if (batch)
+		_get_all_settings_call (batch);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_get_settings_request (NMRemoteConnection *self,
+                       GCancellable *cancellable,
+                       GetSettingsCallback callback,
+                       gpointer user_data)
+{
+	GetSettingsRequest *request;
+	GetSettingsQueue *queue;
+	GMainContext *context;
+
+	request = g_slice_new (GetSettingsRequest);
+	*request = (GetSettingsRequest) {
+		.self = g_object_ref (self),
+		.cancellable = cancellable ? g_object_ref (cancellable) : NULL,
+		.callback = callback,
+		.user_data = user_data,
+	};
+
+	if (g_atomic_int_get (&_get_settings.unsupported)) {
+		_get_settings_single (request);
+		return;
+	}
+
+	context = g_main_context_get_thread_default () ?: g_main_context_default ();
+
+	g_mutex_lock (&_get_settings.lock);
+
+	if (!_get_settings.queues)
+		_get_settings.queues = g_hash_table_new (nm_direct_hash, NULL);
+
+	queue = g_hash_table_lookup (_get_settings.queues, context);
+	if (!queue) {
+		GSource *source;
+
+		queue = g_slice_new (GetSettingsQueue);
+		queue->context = g_main_context_ref (context);
+		queue->requests = g_ptr_array_new ();
+		g_hash_table_insert (_get_settings.queues, context, queue);
+
+		source = g_idle_source_new ();
+		g_source_set_callback (source, _get_settings_dispatch, queue, NULL);
+		g_source_attach (source, context);
+		g_source_unref (source);
+	}
+	g_ptr_array_add (queue->requests, request);
+
+	g_mutex_unlock (&_get_settings.lock);
+}
+
+/*****************************************************************************/
+
+static void
+updated_get_settings_cb (NMRemoteConnection *self,
+                         GVariant *new_settings,
+                         GError *error,
+                         gpointer user_data)
+{
 	NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE (self);
-	GVariant *new_settings;
 	gboolean visible;
 
-	if (!nmdbus_settings_connection_call_get_settings_finish (priv->proxy, &new_settings,
-	                                                          result, NULL)) {
+	if (!new_settings) {
 		/* Connection is no longer visible to this user. */
 		nm_connection_clear_settings (NM_CONNECTION (self));
 
 		visible = FALSE;
 	} else {
 		replace_settings (self, new_settings);
-		g_variant_unref (new_settings);
 
 		visible = TRUE;
 	}
@@ -706,21 +955,15 @@ updated_get_settings_cb (GObject *proxy,
 		priv->visible = visible;
 		g_object_notify (G_OBJECT (self), NM_REMOTE_CONNECTION_VISIBLE);
 	}
-
-	g_object_unref (self);
 }
 
 static void
 updated_cb (NMDBusSettingsConnection *proxy, gpointer user_data)
 {
 	NMRemoteConnection *self = NM_REMOTE_CONNECTION (user_data);
-	NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE (self);
 
 	/* The connection got updated; request the replacement settings */
-	nmdbus_settings_connection_call_get_settings (priv->proxy,
-	                                              NULL,
-	                                              updated_get_settings_cb,
-	                                              g_object_ref (self));
+	_get_settings_request (self, NULL, updated_get_settings_cb, NULL);
 }
 
 /*****************************************************************************/
@@ -798,22 +1041,22 @@ init_async_parent_inited (GObject *source, GAsyncResult *result, gpointer user_d
 }
 
 static void
-init_get_settings_cb (GObject *proxy,
-                      GAsyncResult *result,
+init_get_settings_cb (NMRemoteConnection *self,
+                      GVariant *settings,
+                      GError *error,
                       gpointer user_data)
 {
 	NMRemoteConnectionInitData *init_data = user_data;
-	NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE (init_data->initable);
-	GVariant *settings;
-	GError *error = NULL;
+	NMRemoteConnectionPrivate *priv = NM_REMOTE_CONNECTION_GET_PRIVATE (self);
 
-	if (!nmdbus_settings_connection_call_get_settings_finish (priv->proxy, &settings,
-	                                                          result, &error)) {
-		g_error_free (error);
-	} else {
+	if (error) {
+		init_async_complete (init_data, g_error_copy (error));
+		return;
+	}
+
+	if (settings) {
 		priv->visible = TRUE;
-		replace_settings (NM_REMOTE_CONNECTION (init_data->initable), settings);
-		g_variant_unref (settings);
+		replace_settings (self, settings);
 	}
 
 	nm_remote_connection_parent_async_initable_iface->
@@ -841,9 +1084,8 @@ init_async (GAsyncInitable *initable, int io_priority,
 	g_signal_connect_object (priv->proxy, "updated",
 	                         G_CALLBACK (updated_cb), initable, 0);
 
-	nmdbus_settings_connection_call_get_settings (NM_REMOTE_CONNECTION_GET_PRIVATE (init_data->initable)->proxy,
-	                                              init_data->cancellable,
-	                                              init_get_settings_cb, init_data);
+	_get_settings_request (NM_REMOTE_CONNECTION (initable), init_data->cancellable,
+	                       init_get_settings_cb, init_data);
 }
 
 static void
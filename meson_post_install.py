@@ -22,6 +22,7 @@ if not os.environ.get('DESTDIR'):
     os.path.join(pkgconfdir, 'conf.d'),
     os.path.join(pkgconfdir, 'system-connections'),
     os.path.join(pkgconfdir, 'dispatcher.d', 'no-wait.d'),
+    os.path.join(pkgconfdir, 'dispatcher.d', 'parallel.d'),
     os.path.join(pkgconfdir, 'dispatcher.d', 'pre-down.d'),
     os.path.join(pkgconfdir, 'dispatcher.d', 'pre-up.d'),
     os.path.join(pkgconfdir, 'dnsmasq.d'),
@@ -180,7 +180,10 @@ _dict_idx_entries_hash (const NMDedupMultiEntry *entry)
 
 	_entry_unpack (entry, &idx_type, &obj, &lookup_head);
 
-	nm_hash_init (&h, 1914869417u);
+	if (idx_type->fixed_width_keys)
+		nm_hash_init_fast (&h, 1914869417u);
+	else
+		nm_hash_init (&h, 1914869417u);
 	if (idx_type->klass->idx_obj_partition_hash_update) {
 		nm_assert (obj);
 		idx_type->klass->idx_obj_partition_hash_update (idx_type, obj, &h);
@@ -147,6 +147,10 @@ struct _NMDedupMultiIdxType {
 	CList lst_idx_head;
 
 	guint len;
+
+	/* if set, the index only hashes fixed-width binary keys (no strings).
+	 * Then a faster hash function is used. See nm_hash_init_fast(). */
+	bool fixed_width_keys;
 };
 
 void nm_dedup_multi_idx_type_init (NMDedupMultiIdxType *idx_type,
@@ -122,6 +122,21 @@ nm_hash_init (NMHashState *state, guint static_seed)
 	memcpy (seed, g, HASH_KEY_SIZE);
 	seed[0] ^= static_seed;
 	siphash24_init (&state->_state, (const guint8 *) seed);
+	state->_is_fast = FALSE;
+}
+
+void
+nm_hash_init_fast (NMHashState *state, guint static_seed)
+{
+	const guint8 *g;
+	guint64 seed;
+
+	nm_assert (state);
+
+	g = _get_hash_key ();
+	memcpy (&seed, g, sizeof (seed));
+	state->_fast_state = (seed ^ static_seed) * _NM_HASH_FAST_MUL;
+	state->_is_fast = TRUE;
 }
 
 guint
@@ -26,7 +26,11 @@
 #include "nm-macros-internal.h"
 
 struct _NMHashState {
-	struct siphash _state;
+	union {
+		struct siphash _state;
+		guint64 _fast_state;
+	};
+	bool _is_fast;
 };
 
 typedef struct _NMHashState NMHashState;
@@ -35,6 +39,45 @@ guint nm_hash_static (guint static_seed);
 
 void nm_hash_init (NMHashState *state, guint static_seed);
 
+/* nm_hash_init_fast() initializes a hash state that uses a cheap, keyed
+ * multiply-xorshift hash instead of SipHash-2-4. It is much faster for
+ * short keys, but it is not resistant against hash-flooding. Only use it
+ * for fixed-width binary keys that an attacker cannot choose freely (like
+ * ifindex, plen, table or metric), never for strings.
+ *
+ * Contrary to SipHash, the result depends on how the data is split
+ * into nm_hash_update() calls. That is fine, as long as equal keys are
+ * always hashed the same way. */
+void nm_hash_init_fast (NMHashState *state, guint static_seed);
+
+#define _NM_HASH_FAST_MUL 0x9E3779B97F4A7C15ull
+
+static inline void
+_nm_hash_fast_update (NMHashState *state, const void *ptr, gsize n)
+{
+	const guint8 *p = ptr;
+	guint64 h = state->_fast_state;
+	guint64 v;
+
+	while (n >= sizeof (v)) {
+		memcpy (&v, p, sizeof (v));
+		h = (h ^ v) * _NM_HASH_FAST_MUL;
+		h ^= h >> 29;
+		p += sizeof (v);
+		n -= sizeof (v);
+	}
+	if (n > 0) {
+		/* load the tail bytes explicitly. A memcpy() into @v would put
+		 * them into the top byte on big endian, overwriting the length. */
+		v = ((guint64) n) << 56;
+		while (n-- > 0)
+			v |= ((guint64) p[n]) << (8 * n);
+		h = (h ^ v) * _NM_HASH_FAST_MUL;
+		h ^= h >> 29;
+	}
+	state->_fast_state = h;
+}
+
 static inline guint
 nm_hash_complete (NMHashState *state)
 {
@@ -42,7 +85,16 @@ nm_hash_complete (NMHashState *state)
 
 	nm_assert (state);
 
-	h = siphash24_finalize (&state->_state);
+	if (state->_is_fast) {
+		/* the finalizer of MurmurHash3, to avalanche the remaining bits. */
+		h = state->_fast_state;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdull;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ull;
+		h ^= h >> 33;
+	} else
+		h = siphash24_finalize (&state->_state);
 
 	/* we don't ever want to return a zero hash.
 	 *
@@ -57,7 +109,10 @@ nm_hash_update (NMHashState *state, const void *ptr, gsize n)
 	nm_assert (ptr);
 	nm_assert (n > 0);
 
-	siphash24_compress (ptr, n, &state->_state);
+	if (state->_is_fast)
+		_nm_hash_fast_update (state, ptr, n);
+	else
+		siphash24_compress (ptr, n, &state->_state);
 }
 
 #define nm_hash_update_val(state, val) \
@@ -168,7 +223,7 @@ nm_hash_update_mem (NMHashState *state, const void *ptr, gsize n)
 	 * instead. */
 	nm_hash_update (state, &n, sizeof (n));
 	if (n > 0)
-		siphash24_compress (ptr, n, &state->_state);
+		nm_hash_update (state, ptr, n);
 }
 
 static inline void
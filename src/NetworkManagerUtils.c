@@ -880,6 +880,85 @@ nm_utils_match_connection (NMConnection *const*connections,
 
 /*****************************************************************************/
 
+static void
+_connections_index_free (gpointer data)
+{
+	g_ptr_array_free (data, TRUE);
+}
+
+/**
+ * nm_utils_connections_index_by_ifname:
+ * @connections: a %NULL terminated list of connections
+ *
+ * A connection with interface-name set can only be activated on the
+ * device with that name. Group @connections by their interface-name,
+ * so that the candidates for a device can be looked up with
+ * nm_utils_connections_index_lookup() without checking every connection.
+ *
+ * Returns: (transfer full): the index. The connections are not referenced
+ *   and must outlive it.
+ */
+GHashTable *
+nm_utils_connections_index_by_ifname (NMConnection *const*connections)
+{
+	GHashTable *index;
+	GHashTableIter iter;
+	GPtrArray *arr;
+	guint i;
+
+	index = g_hash_table_new_full (nm_str_hash, g_str_equal,
+	                               g_free, _connections_index_free);
+
+	for (i = 0; connections[i]; i++) {
+		const char *ifname;
+
+		/* connections without interface-name are indexed by "". */
+		ifname = nm_connection_get_interface_name (connections[i]) ?: "";
+		arr = g_hash_table_lookup (index, ifname);
+		if (!arr) {
+			arr = g_ptr_array_new ();
+			g_hash_table_insert (index, g_strdup (ifname), arr);
+		}
+		g_ptr_array_add (arr, connections[i]);
+	}
+
+	g_hash_table_iter_init (&iter, index);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &arr))
+		g_ptr_array_add (arr, NULL);
+
+	return index;
+}
+
+/**
+ * nm_utils_connections_index_lookup:
+ * @index: the index created by nm_utils_connections_index_by_ifname()
+ * @ifname: (allow-none): the interface name
+ * @out_len: (allow-none): the number of returned connections
+ *
+ * Returns: (transfer none): the %NULL terminated list of connections
+ *   with interface-name @ifname, or of connections without interface-name
+ *   if @ifname is %NULL. Never %NULL.
+ */
+NMConnection *const*
+nm_utils_connections_index_lookup (GHashTable *index,
+                                   const char *ifname,
+                                   guint *out_len)
+{
+	static NMConnection *const empty[] = { NULL };
+	GPtrArray *arr;
+
+	arr = g_hash_table_lookup (index, ifname ?: "");
+	if (!arr) {
+		NM_SET_OUT (out_len, 0);
+		return empty;
+	}
+
+	NM_SET_OUT (out_len, arr->len - 1);
+	return (NMConnection *const*) arr->pdata;
+}
+
+/*****************************************************************************/
+
 /**
  * nm_utils_g_value_set_object_path:
  * @value: a #GValue, initialized to store an object path
@@ -48,6 +48,12 @@ NMConnection *nm_utils_match_connection (NMConnection *const*connections,
                                          NMUtilsMatchFilterFunc match_filter_func,
                                          gpointer match_filter_data);
 
+GHashTable *nm_utils_connections_index_by_ifname (NMConnection *const*connections);
+
+NMConnection *const*nm_utils_connections_index_lookup (GHashTable *index,
+                                                       const char *ifname,
+                                                       guint *out_len);
+
 void nm_utils_g_value_set_object_path (GValue *value, gpointer object);
 
 /**
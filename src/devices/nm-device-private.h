@@ -94,6 +94,14 @@ gboolean nm_device_dhcp6_renew (NMDevice *device, gboolean release);
 
 void nm_device_recheck_available_connections (NMDevice *device);
 
+typedef gboolean (*NMDeviceConnectionFilterFunc) (NMDevice *device,
+                                                  NMConnection *connection,
+                                                  gpointer user_data);
+
+void nm_device_recheck_available_connections_filtered (NMDevice *device,
+                                                       NMDeviceConnectionFilterFunc filter,
+                                                       gpointer user_data);
+
 void nm_device_master_check_slave_physical_port (NMDevice *self, NMDevice *slave,
                                                  NMLogDomain log_domain);
 
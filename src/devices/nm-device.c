@@ -161,6 +161,10 @@ typedef struct {
 	                          that the original configuration didn't change. */
 } AppliedConfig;
 
+/* Above this many pending route changes, recapturing the external
+ * configuration is cheaper than applying the changes one by one. */
+#define EXT_ROUTE_DELTAS_MAX 1024
+
 /*****************************************************************************/
 
 enum {
@@ -243,6 +247,12 @@ typedef struct _NMDevicePrivate {
 	GSList *pending_actions;
 	GSList *dad6_failed_addrs;
 
+	/* Routes of the IP interface that changed since ext_ip4_config/ext_ip6_config
+	 * were last captured. %NULL means that the next update needs to recapture
+	 * the full configuration. */
+	GPtrArray *ext_ip4_route_deltas;
+	GPtrArray *ext_ip6_route_deltas;
+
 	NMDevice *parent_device;
 
 	char *        udi;
@@ -515,6 +525,7 @@ G_DEFINE_ABSTRACT_TYPE (NMDevice, nm_device, NM_TYPE_EXPORTED_OBJECT)
 static void nm_device_set_proxy_config (NMDevice *self, const char *pac_url);
 
 static gboolean update_ext_ip_config (NMDevice *self, int addr_family, gboolean initial, gboolean intersect_configs);
+static void ext_route_deltas_reset (NMDevice *self, int addr_family, gboolean track);
 
 static gboolean nm_device_set_ip4_config (NMDevice *self,
                                           NMIP4Config *config,
@@ -742,6 +753,30 @@ applied_config_get_current (AppliedConfig *config)
 	return config->current ?: config->orig;
 }
 
+static void
+applied_config_remove_obj (AppliedConfig *config, const NMPObject *obj)
+{
+	if (!config->orig)
+		return;
+
+	if (!config->current) {
+		if (!nm_ip_config_nmpobj_lookup (config->orig, obj))
+			return;
+		config->current = NM_IS_IP4_CONFIG (config->orig)
+		                  ? (NMIPConfig *) nm_ip4_config_clone ((NMIP4Config *) config->orig)
+		                  : (NMIPConfig *) nm_ip6_config_clone ((NMIP6Config *) config->orig);
+	}
+	nm_ip_config_nmpobj_remove (config->current, obj);
+}
+
+static gboolean
+applied_config_has_obj (AppliedConfig *config, const NMPObject *obj)
+{
+	NMIPConfig *current = applied_config_get_current (config);
+
+	return current && nm_ip_config_nmpobj_lookup (current, obj);
+}
+
 static void
 applied_config_add_address (AppliedConfig *config, const NMPlatformIPAddress *address)
 {
@@ -6126,6 +6161,9 @@ ip4_config_merge_and_apply (NMDevice *self,
 	init_ip4_config_dns_priority (self, composite);
 
 	if (commit) {
+		/* the internal configurations change. The next external update must
+		 * redo the intersect/subtract steps for all routes. */
+		ext_route_deltas_reset (self, AF_INET, FALSE);
 		if (priv->queued_ip4_config_id)
 			update_ext_ip_config (self, AF_INET, FALSE, FALSE);
 		ensure_con_ip4_config (self);
@@ -6885,6 +6923,7 @@ ip6_config_merge_and_apply (NMDevice *self,
 	init_ip6_config_dns_priority (self, composite);
 
 	if (commit) {
+		ext_route_deltas_reset (self, AF_INET6, FALSE);
 		if (priv->queued_ip6_config_id)
 			update_ext_ip_config (self, AF_INET6, FALSE, FALSE);
 		ensure_con_ip6_config (self);
@@ -9395,6 +9434,7 @@ _cleanup_ip4_pre (NMDevice *self, CleanupType cleanup_type)
 	if (nm_clear_g_source (&priv->queued_ip4_config_id))
 		_LOGD (LOGD_DEVICE, "clearing queued IP4 config change");
 	priv->queued_ip4_config_pending = FALSE;
+	ext_route_deltas_reset (self, AF_INET, FALSE);
 
 	dhcp4_cleanup (self, cleanup_type, FALSE);
 	arp_cleanup (self);
@@ -9412,6 +9452,7 @@ _cleanup_ip6_pre (NMDevice *self, CleanupType cleanup_type)
 	if (nm_clear_g_source (&priv->queued_ip6_config_id))
 		_LOGD (LOGD_DEVICE, "clearing queued IP6 config change");
 	priv->queued_ip6_config_pending = FALSE;
+	ext_route_deltas_reset (self, AF_INET6, FALSE);
 
 	g_clear_object (&priv->dad6_ip6_config);
 	dhcp6_cleanup (self, cleanup_type, FALSE);
@@ -11387,6 +11428,129 @@ intersect_ext_config (NMDevice *self, AppliedConfig *config)
 	}
 }
 
+static GPtrArray **
+_ext_route_deltas (NMDevicePrivate *priv, int addr_family)
+{
+	return addr_family == AF_INET
+	       ? &priv->ext_ip4_route_deltas
+	       : &priv->ext_ip6_route_deltas;
+}
+
+static void
+ext_route_deltas_reset (NMDevice *self, int addr_family, gboolean track)
+{
+	GPtrArray **p_deltas = _ext_route_deltas (NM_DEVICE_GET_PRIVATE (self), addr_family);
+
+	if (!track)
+		g_clear_pointer (p_deltas, g_ptr_array_unref);
+	else if (*p_deltas)
+		g_ptr_array_set_size (*p_deltas, 0);
+	else
+		*p_deltas = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+}
+
+static void
+ext_route_deltas_add (NMDevice *self, int addr_family, const NMPObject *obj)
+{
+	GPtrArray **p_deltas = _ext_route_deltas (NM_DEVICE_GET_PRIVATE (self), addr_family);
+
+	if (!*p_deltas)
+		return;
+
+	/* The default route determines the gateway and is compared with a metric
+	 * penalty against the internal configurations. Leave it to the full
+	 * capture. */
+	if (   (*p_deltas)->len >= EXT_ROUTE_DELTAS_MAX
+	    || NM_PLATFORM_IP_ROUTE_IS_DEFAULT (NMP_OBJECT_CAST_IP_ROUTE (obj))) {
+		g_clear_pointer (p_deltas, g_ptr_array_unref);
+		return;
+	}
+
+	g_ptr_array_add (*p_deltas, (gpointer) nmp_object_ref (obj));
+}
+
+/* Bring ext_ip4_config (ext_ip6_config) up to date with the routes that
+ * changed since the last capture. This has the same effect as recapturing
+ * and redoing the intersect/subtract steps in update_ext_ip_config(), but
+ * only looks at the changed routes. */
+static gboolean
+update_ext_ip_config_incremental (NMDevice *self, int addr_family)
+{
+	NMDevicePrivate *priv = NM_DEVICE_GET_PRIVATE (self);
+	GPtrArray *deltas = *_ext_route_deltas (priv, addr_family);
+	NMPlatform *platform = nm_device_get_platform (self);
+	NMIPConfig *ext;
+	NMIPConfig *ext_captured;
+	NMIPConfig *con;
+	AppliedConfig *applied[3];
+	GSList *vpn_configs;
+	GSList *iter;
+	gs_unref_ptrarray GPtrArray *internal = NULL;
+	guint i, j;
+
+	if (addr_family == AF_INET) {
+		ext = (NMIPConfig *) priv->ext_ip4_config;
+		ext_captured = NULL;
+		con = (NMIPConfig *) priv->con_ip4_config;
+		applied[0] = &priv->dev_ip4_config;
+		applied[1] = &priv->wwan_ip4_config;
+		applied[2] = NULL;
+		vpn_configs = priv->vpn4_configs;
+	} else {
+		ext = (NMIPConfig *) priv->ext_ip6_config;
+		ext_captured = (NMIPConfig *) priv->ext_ip6_config_captured;
+		con = (NMIPConfig *) priv->con_ip6_config;
+		applied[0] = &priv->ac_ip6_config;
+		applied[1] = &priv->dhcp6.ip6_config;
+		applied[2] = &priv->wwan_ip6_config;
+		vpn_configs = priv->vpn6_configs;
+		if (!ext_captured)
+			ext = NULL;
+	}
+
+	if (!deltas || !ext)
+		return FALSE;
+
+	/* slaves have no IP configuration, see nm_ip4_config_capture(). */
+	if (nm_platform_link_get_master (platform, nm_device_get_ip_ifindex (self)) > 0)
+		return FALSE;
+
+	internal = g_ptr_array_new ();
+	for (i = 0; i < deltas->len; i++) {
+		const NMPObject *obj = deltas->pdata[i];
+
+		/* the applied configs are copied on write, collect the current ones
+		 * for each route. */
+		g_ptr_array_set_size (internal, 0);
+		if (con)
+			g_ptr_array_add (internal, con);
+		for (j = 0; j < G_N_ELEMENTS (applied) && applied[j]; j++) {
+			if (applied_config_get_current (applied[j]))
+				g_ptr_array_add (internal, applied_config_get_current (applied[j]));
+		}
+		for (iter = vpn_configs; iter; iter = iter->next)
+			g_ptr_array_add (internal, iter->data);
+		g_ptr_array_add (internal, NULL);
+
+		if (nm_ip_config_update_ext_route (ext, ext_captured, platform, obj,
+		                                   (NMIPConfig *const *) internal->pdata))
+			continue;
+
+		/* the route was removed externally, don't re-add it. */
+		if (con)
+			nm_ip_config_nmpobj_remove (con, obj);
+		for (j = 0; j < G_N_ELEMENTS (applied) && applied[j]; j++)
+			applied_config_remove_obj (applied[j], obj);
+		for (iter = vpn_configs; iter; iter = iter->next)
+			nm_ip_config_nmpobj_remove (iter->data, obj);
+	}
+
+	_LOGT (LOGD_DEVICE, "ip%c: updated %u external routes",
+	       nm_utils_addr_family_to_char (addr_family), deltas->len);
+	g_ptr_array_set_size (deltas, 0);
+	return TRUE;
+}
+
 static gboolean
 update_ext_ip_config (NMDevice *self, int addr_family, gboolean initial, gboolean intersect_configs)
 {
@@ -11401,6 +11565,11 @@ update_ext_ip_config (NMDevice *self, int addr_family, gboolean initial, gboolea
 	if (!ifindex)
 		return FALSE;
 
+	if (   !initial
+	    && intersect_configs
+	    && update_ext_ip_config_incremental (self, addr_family))
+		return TRUE;
+
 	capture_resolv_conf =    initial
 	                      && nm_dns_manager_get_resolv_conf_explicit (nm_dns_manager_get ());
 
@@ -11517,6 +11686,14 @@ update_ext_ip_config (NMDevice *self, int addr_family, gboolean initial, gboolea
 		}
 	}
 
+	/* Only a capture that also intersected the internal configurations can
+	 * serve as base for incremental updates. */
+	ext_route_deltas_reset (self,
+	                        addr_family,
+	                           intersect_configs
+	                        && (addr_family == AF_INET
+	                            ? !!priv->ext_ip4_config
+	                            : !!priv->ext_ip6_config_captured));
 	return TRUE;
 }
 
@@ -11589,7 +11766,7 @@ queued_ip4_config_change (gpointer user_data)
 	set_unmanaged_external_down (self, TRUE);
 
 	if (!nm_device_sys_iface_state_is_external_or_assume (self)) {
-		priv->v4_has_shadowed_routes = _v4_has_shadowed_routes_detect (self);;
+		priv->v4_has_shadowed_routes = _v4_has_shadowed_routes_detect (self);
 		ip4_rp_filter_update (self);
 	}
 
@@ -11714,6 +11891,12 @@ device_ipx_changed (NMPlatform *platform,
 	switch (obj_type) {
 	case NMP_OBJECT_TYPE_IP4_ADDRESS:
 	case NMP_OBJECT_TYPE_IP4_ROUTE:
+		if (obj_type == NMP_OBJECT_TYPE_IP4_ROUTE)
+			ext_route_deltas_add (self, AF_INET, NMP_OBJECT_UP_CAST (platform_object));
+		else {
+			/* captured addresses are sorted, recapture them. */
+			ext_route_deltas_reset (self, AF_INET, FALSE);
+		}
 		if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
 			priv->queued_ip4_config_pending = TRUE;
 			nm_assert_se (!nm_clear_g_source (&priv->queued_ip4_config_id));
@@ -11726,6 +11909,9 @@ device_ipx_changed (NMPlatform *platform,
 	case NMP_OBJECT_TYPE_IP6_ADDRESS:
 		addr = platform_object;
 
+		/* captured addresses are sorted, recapture them. */
+		ext_route_deltas_reset (self, AF_INET6, FALSE);
+
 		if (   !NM_FLAGS_HAS (addr->n_ifa_flags, IFA_F_TEMPORARY)
 		    && priv->state > NM_DEVICE_STATE_DISCONNECTED
 		    && priv->state < NM_DEVICE_STATE_DEACTIVATING
@@ -11736,6 +11922,8 @@ device_ipx_changed (NMPlatform *platform,
 		}
 		/* fall through */
 	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		if (obj_type == NMP_OBJECT_TYPE_IP6_ROUTE)
+			ext_route_deltas_add (self, AF_INET6, NMP_OBJECT_UP_CAST (platform_object));
 		if (nm_device_get_unmanaged_flags (self, NM_UNMANAGED_PLATFORM_INIT)) {
 			priv->queued_ip6_config_pending = TRUE;
 			nm_assert_se (!nm_clear_g_source (&priv->queued_ip6_config_id));
@@ -12514,15 +12702,17 @@ check_connection_available (NMDevice *self,
 	return FALSE;
 }
 
-void
-nm_device_recheck_available_connections (NMDevice *self)
+static void
+_recheck_available_connections (NMDevice *self,
+                                NMDeviceConnectionFilterFunc filter,
+                                gpointer user_data)
 {
 	NMDevicePrivate *priv;
 	NMSettingsConnection *const*connections;
 	gboolean changed = FALSE;
 	GHashTableIter h_iter;
 	NMConnection *connection;
-	guint i;
+	guint i, k;
 	gs_unref_hashtable GHashTable *prune_list = NULL;
 
 	g_return_if_fail (NM_IS_DEVICE (self));
@@ -12532,22 +12722,38 @@ nm_device_recheck_available_connections (NMDevice *self)
 	if (g_hash_table_size (priv->available_connections) > 0) {
 		prune_list = g_hash_table_new (nm_direct_hash, NULL);
 		g_hash_table_iter_init (&h_iter, priv->available_connections);
-		while (g_hash_table_iter_next (&h_iter, (gpointer *) &connection, NULL))
-			g_hash_table_add (prune_list, connection);
+		while (g_hash_table_iter_next (&h_iter, (gpointer *) &connection, NULL)) {
+			if (!filter || filter (self, connection, user_data))
+				g_hash_table_add (prune_list, connection);
+		}
 	}
 
-	connections = nm_settings_get_connections (priv->settings, NULL);
-	for (i = 0; connections[i]; i++) {
-		connection = (NMConnection *) connections[i];
+	/* Connections bound to another interface name are never available,
+	 * only check the connections without interface-name and the ones
+	 * for our interface. */
+	for (k = 0; k < 2; k++) {
+		if (k == 0)
+			connections = nm_settings_get_connections_by_ifname (priv->settings, NULL, NULL);
+		else if (priv->iface)
+			connections = nm_settings_get_connections_by_ifname (priv->settings, priv->iface, NULL);
+		else
+			break;
 
-		if (nm_device_check_connection_available (self,
-		                                          connection,
-		                                          NM_DEVICE_CHECK_CON_AVAILABLE_NONE,
-		                                          NULL)) {
-			if (available_connections_add (self, connection))
-				changed = TRUE;
-			if (prune_list)
-				g_hash_table_remove (prune_list, connection);
+		for (i = 0; connections[i]; i++) {
+			connection = (NMConnection *) connections[i];
+
+			if (filter && !filter (self, connection, user_data))
+				continue;
+
+			if (nm_device_check_connection_available (self,
+			                                          connection,
+			                                          NM_DEVICE_CHECK_CON_AVAILABLE_NONE,
+			                                          NULL)) {
+				if (available_connections_add (self, connection))
+					changed = TRUE;
+				if (prune_list)
+					g_hash_table_remove (prune_list, connection);
+			}
 		}
 	}
 
@@ -12564,6 +12770,32 @@ nm_device_recheck_available_connections (NMDevice *self)
 	available_connections_check_delete_unrealized (self);
 }
 
+void
+nm_device_recheck_available_connections (NMDevice *self)
+{
+	_recheck_available_connections (self, NULL, NULL);
+}
+
+/**
+ * nm_device_recheck_available_connections_filtered:
+ * @self: the #NMDevice
+ * @filter: selects the connections to check
+ * @user_data: data for @filter
+ *
+ * Like nm_device_recheck_available_connections(), but only for the
+ * connections that pass @filter. The others keep their availability,
+ * so the caller must know that nothing else changed for them.
+ */
+void
+nm_device_recheck_available_connections_filtered (NMDevice *self,
+                                                  NMDeviceConnectionFilterFunc filter,
+                                                  gpointer user_data)
+{
+	g_return_if_fail (filter);
+
+	_recheck_available_connections (self, filter, user_data);
+}
+
 /**
  * nm_device_get_best_connection:
  * @self: the #NMDevice
@@ -14789,6 +15021,8 @@ finalize (GObject *object)
 	g_free (priv->hw_addr_initial);
 	g_slist_free (priv->pending_actions);
 	g_slist_free_full (priv->dad6_failed_addrs, (GDestroyNotify) nmp_object_unref);
+	g_clear_pointer (&priv->ext_ip4_route_deltas, g_ptr_array_unref);
+	g_clear_pointer (&priv->ext_ip6_route_deltas, g_ptr_array_unref);
 	g_clear_pointer (&priv->physical_port_id, g_free);
 	g_free (priv->udi);
 	g_free (priv->iface);
@@ -15463,4 +15697,10 @@ nm_device_class_init (NMDeviceClass *klass)
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (klass),
 	                                        NMDBUS_TYPE_DEVICE_STATISTICS_SKELETON,
 	                                        NULL);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (klass),
+	                                             NM_DEVICE_STATISTICS_TX_BYTES,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_STATISTICS);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (klass),
+	                                             NM_DEVICE_STATISTICS_RX_BYTES,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_STATISTICS);
 }
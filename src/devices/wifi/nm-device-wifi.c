@@ -102,6 +102,11 @@ typedef struct {
 	guint             pending_scan_id;
 	guint             ap_dump_id;
 
+	/* SSIDs (GBytes) of APs that appeared, vanished or changed their
+	 * SSID since the last recheck of the available connections. */
+	GHashTable       *ap_changed_ssids;
+	guint             ap_changed_id;
+
 	NMSupplicantManager   *sup_mgr;
 	NMSupplicantInterface *sup_iface;
 	guint                  sup_timeout_id; /* supplicant association timeout */
@@ -514,6 +519,58 @@ ap_add_remove (NMDeviceWifi *self,
 		nm_device_recheck_available_connections (NM_DEVICE (self));
 }
 
+static gboolean
+ap_changed_filter (NMDevice *device,
+                   NMConnection *connection,
+                   gpointer user_data)
+{
+	return nm_wifi_utils_connection_ssid_in (connection, user_data);
+}
+
+static gboolean
+ap_changed_cb (gpointer user_data)
+{
+	NMDeviceWifi *self = user_data;
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
+	priv->ap_changed_id = 0;
+
+	_LOGT (LOGD_WIFI_SCAN, "recheck available connections for %u changed SSIDs",
+	       g_hash_table_size (priv->ap_changed_ssids));
+
+	nm_device_recheck_available_connections_filtered (NM_DEVICE (self),
+	                                                  ap_changed_filter,
+	                                                  priv->ap_changed_ssids);
+	g_hash_table_remove_all (priv->ap_changed_ssids);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+ap_changed_clear (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
+	nm_clear_g_source (&priv->ap_changed_id);
+	g_hash_table_remove_all (priv->ap_changed_ssids);
+}
+
+/* Only connections for the SSID of an AP can change their availability
+ * when that AP comes or goes. Instead of rechecking all connections for
+ * every scan result, remember the SSID and recheck the affected
+ * connections once the supplicant is done with the current batch. */
+static void
+ap_changed_schedule (NMDeviceWifi *self, const guint8 *ssid, gsize len)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
+	if (!ssid || nm_utils_is_empty_ssid (ssid, len))
+		return;
+
+	g_hash_table_add (priv->ap_changed_ssids, nm_wifi_utils_ssid_key_new (ssid, len));
+	if (!priv->ap_changed_id)
+		priv->ap_changed_id = g_idle_add (ap_changed_cb, self);
+}
+
 static void
 remove_all_aps (NMDeviceWifi *self)
 {
@@ -521,6 +578,9 @@ remove_all_aps (NMDeviceWifi *self)
 	GHashTableIter iter;
 	NMWifiAP *ap;
 
+	/* the full recheck below supersedes any pending partial one. */
+	ap_changed_clear (self);
+
 	if (!g_hash_table_size (priv->aps))
 		return;
 
@@ -1551,6 +1611,18 @@ try_fill_ssid_for_hidden_ap (NMDeviceWifi *self,
 	}
 }
 
+static guint
+get_strength_hysteresis (NMDeviceWifi *self)
+{
+	gs_free char *value = NULL;
+
+	value = nm_config_data_get_device_config (NM_CONFIG_GET_DATA,
+	                                          NM_CONFIG_KEYFILE_KEY_DEVICE_WIFI_STRENGTH_HYSTERESIS,
+	                                          NM_DEVICE (self),
+	                                          NULL);
+	return _nm_utils_ascii_str_to_int64 (value, 10, 0, 100, 0);
+}
+
 static void
 supplicant_iface_bss_updated_cb (NMSupplicantInterface *iface,
                                  const char *object_path,
@@ -1561,6 +1633,7 @@ supplicant_iface_bss_updated_cb (NMSupplicantInterface *iface,
 	NMDeviceState state;
 	NMWifiAP *found_ap = NULL;
 	const GByteArray *ssid;
+	guint strength_hysteresis;
 
 	g_return_if_fail (self != NULL);
 	g_return_if_fail (properties != NULL);
@@ -1575,9 +1648,34 @@ supplicant_iface_bss_updated_cb (NMSupplicantInterface *iface,
 
 	found_ap = get_ap_by_supplicant_path (self, object_path);
 	if (found_ap) {
-		if (!nm_wifi_ap_update_from_properties (found_ap, object_path, properties))
+		gs_unref_bytes GBytes *old_ssid = NULL;
+
+		ssid = nm_wifi_ap_get_ssid (found_ap);
+		if (ssid)
+			old_ssid = g_bytes_new (ssid->data, ssid->len);
+
+		strength_hysteresis = found_ap == priv->current_ap
+		                      ? 0
+		                      : get_strength_hysteresis (self);
+		if (!nm_wifi_ap_update_from_properties (found_ap, object_path, properties, strength_hysteresis))
 			return;
 		_ap_dump (self, LOGL_DEBUG, found_ap, "updated", 0);
+
+		/* a hidden AP may have revealed its SSID. */
+		ssid = nm_wifi_ap_get_ssid (found_ap);
+		if (!nm_utils_same_ssid (old_ssid ? g_bytes_get_data (old_ssid, NULL) : NULL,
+		                         old_ssid ? g_bytes_get_size (old_ssid) : 0,
+		                         ssid ? ssid->data : NULL,
+		                         ssid ? ssid->len : 0,
+		                         FALSE)) {
+			if (old_ssid) {
+				ap_changed_schedule (self,
+				                     g_bytes_get_data (old_ssid, NULL),
+				                     g_bytes_get_size (old_ssid));
+			}
+			if (ssid)
+				ap_changed_schedule (self, ssid->data, ssid->len);
+		}
 	} else {
 		gs_unref_object NMWifiAP *ap = NULL;
 
@@ -1605,7 +1703,9 @@ supplicant_iface_bss_updated_cb (NMSupplicantInterface *iface,
 			}
 		}
 
-		ap_add_remove (self, ACCESS_POINT_ADDED, ap, TRUE);
+		ap_add_remove (self, ACCESS_POINT_ADDED, ap, FALSE);
+		if (ssid)
+			ap_changed_schedule (self, ssid->data, ssid->len);
 	}
 
 	/* Update the current AP if the supplicant notified a current BSS change
@@ -1642,7 +1742,11 @@ supplicant_iface_bss_removed_cb (NMSupplicantInterface *iface,
 		if (nm_wifi_ap_set_fake (ap, TRUE))
 			_ap_dump (self, LOGL_DEBUG, ap, "updated", 0);
 	} else {
-		ap_add_remove (self, ACCESS_POINT_REMOVED, ap, TRUE);
+		const GByteArray *ssid = nm_wifi_ap_get_ssid (ap);
+
+		if (ssid)
+			ap_changed_schedule (self, ssid->data, ssid->len);
+		ap_add_remove (self, ACCESS_POINT_REMOVED, ap, FALSE);
 		schedule_ap_list_dump (self);
 	}
 }
@@ -3212,6 +3316,8 @@ nm_device_wifi_init (NMDeviceWifi *self)
 
 	priv->mode = NM_802_11_MODE_INFRA;
 	priv->aps = g_hash_table_new (nm_str_hash, g_str_equal);
+	priv->ap_changed_ssids = g_hash_table_new_full (g_bytes_hash, g_bytes_equal,
+	                                                (GDestroyNotify) g_bytes_unref, NULL);
 }
 
 static void
@@ -3270,8 +3376,10 @@ finalize (GObject *object)
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
 
 	nm_assert (g_hash_table_size (priv->aps) == 0);
+	nm_assert (priv->ap_changed_id == 0);
 
 	g_hash_table_unref (priv->aps);
+	g_hash_table_unref (priv->ap_changed_ssids);
 
 	G_OBJECT_CLASS (nm_device_wifi_parent_class)->finalize (object);
 }
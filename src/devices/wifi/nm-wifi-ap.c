@@ -767,7 +767,8 @@ get_max_rate (const guint8 *bytes, gsize len)
 gboolean
 nm_wifi_ap_update_from_properties (NMWifiAP *ap,
                                    const char *supplicant_path,
-                                   GVariant *properties)
+                                   GVariant *properties,
+                                   guint strength_hysteresis)
 {
 	NMWifiAPPrivate *priv;
 	const guint8 *bytes;
@@ -810,8 +811,14 @@ nm_wifi_ap_update_from_properties (NMWifiAP *ap,
 			changed |= nm_wifi_ap_set_mode (ap, NM_802_11_MODE_ADHOC);
 	}
 
-	if (g_variant_lookup (properties, "Signal", "n", &i16))
-		changed |= nm_wifi_ap_set_strength (ap, nm_wifi_utils_level_to_quality (i16));
+	if (g_variant_lookup (properties, "Signal", "n", &i16)) {
+		int strength = nm_wifi_utils_level_to_quality (i16);
+
+		/* the signal of a BSS jitters with every scan. Ignore small
+		 * changes, they only cause property notifications. */
+		if (ABS (strength - priv->strength) >= (int) strength_hysteresis)
+			changed |= nm_wifi_ap_set_strength (ap, strength);
+	}
 
 	if (g_variant_lookup (properties, "Frequency", "q", &u16))
 		changed |= nm_wifi_ap_set_freq (ap, u16);
@@ -1191,7 +1198,7 @@ nm_wifi_ap_new_from_properties (const char *supplicant_path, GVariant *propertie
 	g_return_val_if_fail (properties != NULL, NULL);
 
 	ap = (NMWifiAP *) g_object_new (NM_TYPE_WIFI_AP, NULL);
-	nm_wifi_ap_update_from_properties (ap, supplicant_path, properties);
+	nm_wifi_ap_update_from_properties (ap, supplicant_path, properties, 0);
 
 	/* ignore APs with invalid or missing BSSIDs */
 	if (!nm_wifi_ap_get_address (ap)) {
@@ -1429,6 +1436,9 @@ nm_wifi_ap_class_init (NMWifiAPClass *ap_class)
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (ap_class),
 	                                        NMDBUS_TYPE_ACCESS_POINT_SKELETON,
 	                                        NULL);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (ap_class),
+	                                             NM_WIFI_AP_STRENGTH,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_SIGNAL);
 }
 
 /*****************************************************************************/
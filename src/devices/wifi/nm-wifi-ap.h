@@ -55,7 +55,8 @@ NMWifiAP *   nm_wifi_ap_new_fake_from_connection (NMConnection *connection);
 
 gboolean          nm_wifi_ap_update_from_properties   (NMWifiAP *ap,
                                                        const char *supplicant_path,
-                                                       GVariant *properties);
+                                                       GVariant *properties,
+                                                       guint strength_hysteresis);
 
 gboolean          nm_wifi_ap_check_compatible         (NMWifiAP *self,
                                                        NMConnection *connection);
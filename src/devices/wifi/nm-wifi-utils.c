@@ -814,3 +814,46 @@ nm_wifi_utils_is_manf_default_ssid (const GByteArray *ssid)
 	}
 	return FALSE;
 }
+
+/**
+ * nm_wifi_utils_ssid_key_new:
+ * @ssid: the SSID
+ * @len: the length of @ssid
+ *
+ * Returns: (transfer full): a key for a hash table of #GBytes with
+ *   g_bytes_hash() and g_bytes_equal(). Like nm_wifi_ap_check_compatible(),
+ *   it ignores a trailing NUL of the SSID.
+ */
+GBytes *
+nm_wifi_utils_ssid_key_new (const guint8 *ssid, gsize len)
+{
+	if (len && ssid[len - 1] == '\0')
+		len--;
+	return g_bytes_new (ssid, len);
+}
+
+/**
+ * nm_wifi_utils_connection_ssid_in:
+ * @connection: the connection
+ * @ssid_keys: a set of keys from nm_wifi_utils_ssid_key_new()
+ *
+ * Returns: %TRUE if @connection is for one of the SSIDs in @ssid_keys,
+ *   that is, if an access point with such an SSID could be compatible
+ *   with @connection.
+ */
+gboolean
+nm_wifi_utils_connection_ssid_in (NMConnection *connection, GHashTable *ssid_keys)
+{
+	NMSettingWireless *s_wifi;
+	GBytes *ssid;
+	gs_unref_bytes GBytes *key = NULL;
+
+	s_wifi = nm_connection_get_setting_wireless (connection);
+	if (!s_wifi)
+		return FALSE;
+	ssid = nm_setting_wireless_get_ssid (s_wifi);
+	if (!ssid)
+		return FALSE;
+	key = nm_wifi_utils_ssid_key_new (g_bytes_get_data (ssid, NULL), g_bytes_get_size (ssid));
+	return g_hash_table_contains (ssid_keys, key);
+}
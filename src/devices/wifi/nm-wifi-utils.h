@@ -41,4 +41,8 @@ guint32 nm_wifi_utils_level_to_quality (gint val);
 
 gboolean nm_wifi_utils_is_manf_default_ssid (const GByteArray *ssid);
 
+GBytes *nm_wifi_utils_ssid_key_new (const guint8 *ssid, gsize len);
+
+gboolean nm_wifi_utils_connection_ssid_in (NMConnection *connection, GHashTable *ssid_keys);
+
 #endif  /* __NM_WIFI_UTILS_H__ */
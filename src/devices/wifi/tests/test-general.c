@@ -23,8 +23,13 @@
 #include <string.h>
 
 #include "devices/wifi/nm-wifi-utils.h"
+#include "devices/wifi/nm-wifi-ap.h"
 
 #include "nm-core-internal.h"
+#include "nm-bus-manager.h"
+#include "nm-exported-object.h"
+
+#include "introspection/org.freedesktop.NetworkManager.AccessPoint.h"
 
 #include "nm-test-utils-core.h"
 
@@ -1358,6 +1363,317 @@ test_strength_all (void)
 
 /*****************************************************************************/
 
+#define RATE_LIMIT_MSEC 300
+
+static NMWifiAP *
+_ap_new (const char *bssid, const char *ssid, gsize ssid_len, gint16 signal)
+{
+	gs_unref_variant GVariant *properties = NULL;
+	GVariantBuilder builder;
+	guint8 addr[ETH_ALEN];
+	NMWifiAP *ap;
+
+	nm_utils_hwaddr_aton (bssid, addr, ETH_ALEN);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add (&builder, "{sv}", "BSSID",
+	                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, addr, ETH_ALEN, 1));
+	if (ssid) {
+		g_variant_builder_add (&builder, "{sv}", "SSID",
+		                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, ssid, ssid_len, 1));
+	}
+	g_variant_builder_add (&builder, "{sv}", "Signal", g_variant_new_int16 (signal));
+	properties = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+	ap = nm_wifi_ap_new_from_properties ("/fi/w1/wpa_supplicant1/Interfaces/0/BSSs/0", properties);
+	g_assert (NM_IS_WIFI_AP (ap));
+	return ap;
+}
+
+typedef struct {
+	GMainLoop *loop;
+	guint timeout_id;
+	guint n_emitted;
+	gint64 last_emit_msec;
+	/* the values of the last emission, or -1 if they were not contained. */
+	int strength;
+	int frequency;
+} PropertiesChangedData;
+
+static void
+_properties_changed_cb (GDBusInterfaceSkeleton *skeleton, GVariant *properties, gpointer user_data)
+{
+	PropertiesChangedData *data = user_data;
+	guint8 strength;
+	guint32 frequency;
+
+	data->n_emitted++;
+	data->last_emit_msec = nm_utils_get_monotonic_timestamp_ms ();
+	data->strength = g_variant_lookup (properties, "Strength", "y", &strength) ? strength : -1;
+	data->frequency = g_variant_lookup (properties, "Frequency", "u", &frequency) ? (int) frequency : -1;
+	g_main_loop_quit (data->loop);
+}
+
+static gboolean
+_wait_timeout_cb (gpointer user_data)
+{
+	PropertiesChangedData *data = user_data;
+
+	data->timeout_id = 0;
+	g_main_loop_quit (data->loop);
+	return G_SOURCE_REMOVE;
+}
+
+/* returns TRUE if the signal was emitted before @timeout_msec passed. */
+static gboolean
+_wait_for_emission (PropertiesChangedData *data, guint timeout_msec)
+{
+	guint n_emitted = data->n_emitted;
+
+	data->timeout_id = g_timeout_add (timeout_msec, _wait_timeout_cb, data);
+	g_main_loop_run (data->loop);
+	nm_clear_g_source (&data->timeout_id);
+	g_assert_cmpint (data->n_emitted, <=, n_emitted + 1);
+	return data->n_emitted != n_emitted;
+}
+
+static guint8
+_skeleton_get_strength (GDBusInterfaceSkeleton *skeleton)
+{
+	guint8 strength;
+
+	g_object_get (skeleton, NM_WIFI_AP_STRENGTH, &strength, NULL);
+	return strength;
+}
+
+static void
+test_strength_rate_limit (void)
+{
+	gs_unref_object NMWifiAP *ap = NULL;
+	GDBusInterfaceSkeleton *skeleton;
+	PropertiesChangedData data = {
+		.strength = -1,
+		.frequency = -1,
+	};
+	gint64 start_msec;
+
+	nm_exported_object_set_property_class_interval (NM_EXPORTED_OBJECT_PROPERTY_CLASS_SIGNAL,
+	                                                RATE_LIMIT_MSEC);
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+
+	ap = _ap_new ("00:11:22:33:44:55", NULL, 0, 10);
+	nm_exported_object_export ((NMExportedObject *) ap);
+	skeleton = nm_exported_object_get_interface_by_type ((NMExportedObject *) ap,
+	                                                     NMDBUS_TYPE_ACCESS_POINT_SKELETON);
+	g_assert (skeleton);
+	g_signal_connect (skeleton, "properties-changed", G_CALLBACK (_properties_changed_cb), &data);
+
+	/* several changes until the emission are coalesced into one signal,
+	 * which carries the last value. */
+	g_assert (nm_wifi_ap_set_strength (ap, 20));
+	g_assert (nm_wifi_ap_set_strength (ap, 30));
+	g_assert (nm_wifi_ap_set_strength (ap, 40));
+	start_msec = nm_utils_get_monotonic_timestamp_ms ();
+	g_assert (_wait_for_emission (&data, RATE_LIMIT_MSEC / 2));
+	g_assert_cmpint (data.n_emitted, ==, 1);
+	g_assert_cmpint (data.strength, ==, 40);
+	g_assert_cmpint (_skeleton_get_strength (skeleton), ==, 40);
+
+	/* within the interval, a change of the strength is held back... */
+	g_assert (nm_wifi_ap_set_strength (ap, 50));
+	g_assert (!_wait_for_emission (&data, RATE_LIMIT_MSEC / 3));
+	g_assert_cmpint (data.n_emitted, ==, 1);
+	g_assert_cmpint (_skeleton_get_strength (skeleton), ==, 40);
+
+	/* ... but properties of the default class are not rate-limited. */
+	g_assert (nm_wifi_ap_set_freq (ap, 2412));
+	g_assert (_wait_for_emission (&data, RATE_LIMIT_MSEC / 3));
+	g_assert_cmpint (data.n_emitted, ==, 2);
+	g_assert_cmpint (data.frequency, ==, 2412);
+	g_assert_cmpint (data.strength, ==, -1);
+	g_assert_cmpint (_skeleton_get_strength (skeleton), ==, 40);
+
+	/* the held back change is emitted once the interval passed, with
+	 * the latest value. */
+	g_assert (nm_wifi_ap_set_strength (ap, 60));
+	g_assert (_wait_for_emission (&data, RATE_LIMIT_MSEC * 3));
+	g_assert_cmpint (data.n_emitted, ==, 3);
+	g_assert_cmpint (data.strength, ==, 60);
+	g_assert_cmpint (data.frequency, ==, -1);
+	g_assert_cmpint (data.last_emit_msec - start_msec, >=, RATE_LIMIT_MSEC);
+	g_assert_cmpint (_skeleton_get_strength (skeleton), ==, 60);
+
+	/* and there is nothing left pending. */
+	g_assert (!_wait_for_emission (&data, RATE_LIMIT_MSEC * 2));
+	g_assert_cmpint (data.n_emitted, ==, 3);
+
+	nm_exported_object_unexport ((NMExportedObject *) ap);
+	g_main_loop_unref (data.loop);
+}
+
+/*****************************************************************************/
+
+static void
+_ap_update_signal (NMWifiAP *ap, gint16 signal, guint strength_hysteresis)
+{
+	gs_unref_variant GVariant *properties = NULL;
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add (&builder, "{sv}", "Signal", g_variant_new_int16 (signal));
+	properties = g_variant_ref_sink (g_variant_builder_end (&builder));
+
+	nm_wifi_ap_update_from_properties (ap, "/fi/w1/wpa_supplicant1/Interfaces/0/BSSs/0",
+	                                   properties, strength_hysteresis);
+}
+
+static void
+_notify_count_cb (GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+	(*((guint *) user_data))++;
+}
+
+static void
+test_strength_hysteresis (void)
+{
+	gs_unref_object NMWifiAP *ap = NULL;
+	guint n_notify = 0;
+
+	ap = _ap_new ("00:11:22:33:44:55", NULL, 0, 50);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 50);
+	g_signal_connect (ap, "notify::" NM_WIFI_AP_STRENGTH, G_CALLBACK (_notify_count_cb), &n_notify);
+
+	/* changes below the hysteresis are ignored, in both directions. */
+	_ap_update_signal (ap, 54, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 50);
+	_ap_update_signal (ap, 46, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 50);
+	g_assert_cmpint (n_notify, ==, 0);
+
+	/* ... and they don't accumulate: the difference is always to the
+	 * last accepted value. */
+	_ap_update_signal (ap, 53, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 50);
+	g_assert_cmpint (n_notify, ==, 0);
+
+	/* a difference of exactly the hysteresis is taken. */
+	_ap_update_signal (ap, 55, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 55);
+	g_assert_cmpint (n_notify, ==, 1);
+	_ap_update_signal (ap, 50, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 50);
+	g_assert_cmpint (n_notify, ==, 2);
+
+	/* without hysteresis (as for the current AP), every change is taken. */
+	_ap_update_signal (ap, 51, 0);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 51);
+	g_assert_cmpint (n_notify, ==, 3);
+	_ap_update_signal (ap, 51, 0);
+	g_assert_cmpint (n_notify, ==, 3);
+
+	/* the hysteresis applies to the strength in percent, not to the dBm. */
+	_ap_update_signal (ap, -61, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 65);
+	g_assert_cmpint (n_notify, ==, 4);
+	_ap_update_signal (ap, -63, 5);
+	g_assert_cmpint (nm_wifi_ap_get_strength (ap), ==, 65);
+	g_assert_cmpint (n_notify, ==, 4);
+}
+
+/*****************************************************************************/
+
+static NMConnection *
+_wifi_connection_new (const char *ssid, gsize ssid_len)
+{
+	NMConnection *connection;
+	NMSettingWireless *s_wifi;
+	gs_unref_bytes GBytes *bytes = NULL;
+
+	connection = nmtst_create_minimal_connection ("test-wifi", NULL, NM_SETTING_WIRELESS_SETTING_NAME, NULL);
+	s_wifi = nm_connection_get_setting_wireless (connection);
+	bytes = g_bytes_new (ssid, ssid_len);
+	g_object_set (s_wifi,
+	              NM_SETTING_WIRELESS_SSID, bytes,
+	              NM_SETTING_WIRELESS_MODE, NM_SETTING_WIRELESS_MODE_INFRA,
+	              NULL);
+	return connection;
+}
+
+static void
+test_ssid_filter (void)
+{
+	static const struct {
+		const char *ssid;
+		gsize len;
+	} ssids[] = {
+#define _SSID(s) { s, NM_STRLEN (s) }
+		_SSID ("foo"),
+		_SSID ("foo\0"),
+		_SSID ("Foo"),
+		_SSID ("foo "),
+		_SSID ("foobar"),
+		_SSID ("f\0o"),
+		_SSID ("\xff\x01\x02"),
+		_SSID ("a-32-character-long-ssid-abcdefg"),
+#undef _SSID
+	};
+	gs_unref_hashtable GHashTable *ssid_keys = NULL;
+	gs_unref_object NMConnection *wired = NULL;
+	guint i, j;
+
+	ssid_keys = g_hash_table_new_full (g_bytes_hash, g_bytes_equal, (GDestroyNotify) g_bytes_unref, NULL);
+
+	/* a connection is rechecked for a changed AP exactly when the
+	 * AP could be compatible with it, as far as the SSID goes. */
+	for (i = 0; i < G_N_ELEMENTS (ssids); i++) {
+		gs_unref_object NMWifiAP *ap = NULL;
+
+		ap = _ap_new ("00:11:22:33:44:55", ssids[i].ssid, ssids[i].len, 50);
+
+		g_hash_table_remove_all (ssid_keys);
+		g_hash_table_add (ssid_keys, nm_wifi_utils_ssid_key_new ((const guint8 *) ssids[i].ssid, ssids[i].len));
+
+		for (j = 0; j < G_N_ELEMENTS (ssids); j++) {
+			gs_unref_object NMConnection *connection = NULL;
+
+			connection = _wifi_connection_new (ssids[j].ssid, ssids[j].len);
+			g_assert_cmpint (nm_wifi_utils_connection_ssid_in (connection, ssid_keys),
+			                 ==,
+			                 nm_wifi_ap_check_compatible (ap, connection));
+			g_assert_cmpint (nm_wifi_utils_connection_ssid_in (connection, ssid_keys),
+			                 ==,
+			                 nm_utils_same_ssid ((const guint8 *) ssids[i].ssid, ssids[i].len,
+			                                     (const guint8 *) ssids[j].ssid, ssids[j].len,
+			                                     TRUE));
+		}
+	}
+
+	/* several changed SSIDs. */
+	g_hash_table_remove_all (ssid_keys);
+	g_hash_table_add (ssid_keys, nm_wifi_utils_ssid_key_new ((const guint8 *) "foo", 3));
+	g_hash_table_add (ssid_keys, nm_wifi_utils_ssid_key_new ((const guint8 *) "bar\0", 4));
+	for (j = 0; j < G_N_ELEMENTS (ssids); j++) {
+		gs_unref_object NMConnection *connection = NULL;
+
+		connection = _wifi_connection_new (ssids[j].ssid, ssids[j].len);
+		g_assert_cmpint (nm_wifi_utils_connection_ssid_in (connection, ssid_keys),
+		                 ==,
+		                 j <= 1);
+	}
+	{
+		gs_unref_object NMConnection *connection = _wifi_connection_new ("bar", 3);
+
+		g_assert (nm_wifi_utils_connection_ssid_in (connection, ssid_keys));
+	}
+
+	/* connections without SSID are never rechecked. */
+	wired = nmtst_create_minimal_connection ("test-wired", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	g_assert (!nm_wifi_utils_connection_ssid_in (wired, ssid_keys));
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -1367,6 +1683,9 @@ main (int argc, char **argv)
 
 	nmtst_init_assert_logging (&argc, &argv, "INFO", "DEFAULT");
 
+	/* export objects on a bus manager that doesn't connect to the bus. */
+	nm_bus_manager_setup (g_object_new (NM_TYPE_BUS_MANAGER, NULL));
+
 	g_test_add_func ("/wifi/lock_bssid",
 	                 test_lock_bssid);
 
@@ -1521,6 +1840,13 @@ main (int argc, char **argv)
 	                 test_strength_wext);
 	g_test_add_func ("/wifi/strength/all",
 	                 test_strength_all);
+	g_test_add_func ("/wifi/strength/rate-limit",
+	                 test_strength_rate_limit);
+	g_test_add_func ("/wifi/strength/hysteresis",
+	                 test_strength_hysteresis);
+
+	g_test_add_func ("/wifi/ssid-filter",
+	                 test_ssid_filter);
 
 	return g_test_run ();
 }
@@ -31,6 +31,13 @@
 #define NM_DHCP_HELPER_SERVER_INTERFACE_NAME    "org.freedesktop.nm_dhcp_server"
 #define NM_DHCP_HELPER_SERVER_METHOD_NOTIFY     "Notify"
 
+/* Instead of calling NM_DHCP_HELPER_SERVER_METHOD_NOTIFY, the helper first
+ * tries to send the serialized "(a{sv})" parameters of the call as a single
+ * datagram to this socket. That avoids setting up a D-Bus connection for
+ * every DHCP event. The D-Bus call is only the fallback. */
+#define NM_DHCP_HELPER_SOCKET_PATH              NMRUNDIR "/dhcp-helper"
+#define NM_DHCP_HELPER_SOCKET_MSG_MAX           (64 * 1024)
+
 /*****************************************************************************/
 
 #endif /* __NM_DHCP_HELPER_API_H__ */
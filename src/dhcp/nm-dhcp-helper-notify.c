@@ -0,0 +1,203 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2007 - 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nm-dhcp-helper-notify.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "nm-dhcp-helper-api.h"
+
+/*****************************************************************************/
+
+/**
+ * nm_dhcp_helper_notify_socket:
+ * @socket_path: the datagram socket of NetworkManager
+ * @parameters: the "(a{sv})" parameters of the event
+ * @error: the error in case of failure
+ *
+ * Sends @parameters as a single datagram to @socket_path.
+ *
+ * Returns: %TRUE if the datagram was sent.
+ */
+gboolean
+nm_dhcp_helper_notify_socket (const char *socket_path,
+                              GVariant *parameters,
+                              GError **error)
+{
+	nm_auto_close int fd = -1;
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	const struct timeval tv = {
+		.tv_sec = 1,
+	};
+	gsize len;
+	gssize n;
+	int errsv;
+
+	if (g_strlcpy (addr.sun_path, socket_path, sizeof (addr.sun_path)) >= sizeof (addr.sun_path)) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+		             "socket path %s too long", socket_path);
+		return FALSE;
+	}
+
+	len = g_variant_get_size (parameters);
+	if (len > NM_DHCP_HELPER_SOCKET_MSG_MAX) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_MESSAGE_TOO_LARGE,
+		             "message too large (%zu bytes)", len);
+		return FALSE;
+	}
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		errsv = errno;
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+		             "cannot create socket: %s", g_strerror (errsv));
+		return FALSE;
+	}
+
+	/* if NetworkManager is too busy to empty the queue, don't block
+	 * forever. The D-Bus call has the same timeout. */
+	(void) setsockopt (fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof (tv));
+
+again:
+	n = sendto (fd, g_variant_get_data (parameters), len, 0,
+	            (struct sockaddr *) &addr, sizeof (addr));
+	if (n < 0) {
+		errsv = errno;
+		if (errsv == EINTR)
+			goto again;
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+		             "cannot send to %s: %s", socket_path, g_strerror (errsv));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * nm_dhcp_helper_notify_dbus:
+ * @dbus_address: the address of NetworkManager's private D-Bus server
+ * @parameters: the "(a{sv})" parameters of the event
+ * @out_notify_error: (allow-none): if the "Notify" call failed, its error.
+ *   In that case, the deprecated "Event" signal is emitted instead.
+ * @error: the error in case of failure
+ *
+ * Connects to @dbus_address and calls "Notify" with @parameters.
+ *
+ * Returns: %TRUE if the event was delivered, either by "Notify"
+ *   or by the "Event" signal.
+ */
+gboolean
+nm_dhcp_helper_notify_dbus (const char *dbus_address,
+                            GVariant *parameters,
+                            GError **out_notify_error,
+                            GError **error)
+{
+	gs_unref_object GDBusConnection *connection = NULL;
+	gs_unref_variant GVariant *result = NULL;
+	GError *local = NULL;
+	guint try_count = 0;
+	gint64 time_end;
+
+	/* FIXME: g_dbus_connection_new_for_address_sync() tries to connect to the socket in
+	 * non-blocking mode, which can easily fail with EAGAIN, causing the creation of the
+	 * socket to fail with "Could not connect: Resource temporarily unavailable".
+	 *
+	 * We should instead create the GIOStream ourself and block on connecting to
+	 * the socket. */
+	connection = g_dbus_connection_new_for_address_sync (dbus_address,
+	                                                     G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT,
+	                                                     NULL, NULL, &local);
+	if (!connection) {
+		g_dbus_error_strip_remote_error (local);
+		g_prefix_error (&local, "could not connect to NetworkManager D-Bus socket: ");
+		g_propagate_error (error, local);
+		return FALSE;
+	}
+
+	time_end = g_get_monotonic_time () + (200 * 1000L); /* retry for at most 200 milliseconds */
+
+do_notify:
+	try_count++;
+	result = g_dbus_connection_call_sync (connection,
+	                                      NULL,
+	                                      NM_DHCP_HELPER_SERVER_OBJECT_PATH,
+	                                      NM_DHCP_HELPER_SERVER_INTERFACE_NAME,
+	                                      NM_DHCP_HELPER_SERVER_METHOD_NOTIFY,
+	                                      parameters,
+	                                      NULL,
+	                                      G_DBUS_CALL_FLAGS_NONE,
+	                                      1000,
+	                                      NULL,
+	                                      &local);
+
+	if (!result) {
+		gs_free char *s_err = NULL;
+
+		s_err = g_dbus_error_get_remote_error (local);
+		if (NM_IN_STRSET (s_err, "org.freedesktop.DBus.Error.UnknownMethod")) {
+			gint64 remaining_time = time_end - g_get_monotonic_time ();
+
+			/* I am not sure that a race can actually happen, as we register the object
+			 * on the server side during GDBusServer:new-connection signal.
+			 *
+			 * However, there was also a race for subscribing to an event, so let's just
+			 * do some retry. */
+			if (remaining_time > 0) {
+				g_usleep (NM_MIN (NM_CLAMP ((gint64) (100L * (1L << try_count)), 5000, 25000), remaining_time));
+				g_clear_error (&local);
+				goto do_notify;
+			}
+		}
+		g_propagate_error (out_notify_error, local);
+		local = NULL;
+
+		/* for backward compatibilty, try to emit the signal. There is no stable
+		 * API between the dhcp-helper and NetworkManager. However, while upgrading
+		 * the NetworkManager package, a newer helper might want to notify an
+		 * older server, which still uses the "Event". */
+		if (!g_dbus_connection_emit_signal (connection,
+		                                    NULL,
+		                                    "/",
+		                                    NM_DHCP_CLIENT_DBUS_IFACE,
+		                                    "Event",
+		                                    parameters,
+		                                    &local)) {
+			g_dbus_error_strip_remote_error (local);
+			g_prefix_error (&local, "could not send DHCP Event signal: ");
+			g_propagate_error (error, local);
+			return FALSE;
+		}
+		/* We were able to send the asynchronous Event. Consider that a success. */
+	}
+
+	if (!g_dbus_connection_flush_sync (connection, NULL, &local)) {
+		g_dbus_error_strip_remote_error (local);
+		g_prefix_error (&local, "could not flush D-Bus connection: ");
+		g_propagate_error (error, local);
+		return FALSE;
+	}
+
+	return TRUE;
+}
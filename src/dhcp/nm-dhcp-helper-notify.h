@@ -0,0 +1,37 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ * (C) Copyright 2018 Red Hat, Inc.
+ */
+
+#ifndef __NM_DHCP_HELPER_NOTIFY_H__
+#define __NM_DHCP_HELPER_NOTIFY_H__
+
+/* How nm-dhcp-helper delivers an event to NetworkManager. This is built
+ * into the helper and into the tests, which pass their own paths. */
+
+gboolean nm_dhcp_helper_notify_socket (const char *socket_path,
+                                       GVariant *parameters,
+                                       GError **error);
+
+gboolean nm_dhcp_helper_notify_dbus (const char *dbus_address,
+                                     GVariant *parameters,
+                                     GError **out_notify_error,
+                                     GError **error);
+
+#endif /* __NM_DHCP_HELPER_NOTIFY_H__ */
@@ -22,6 +22,7 @@
 #include "nm-dhcp-listener.h"
 
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <sys/wait.h>
 #include <signal.h>
 #include <string.h>
@@ -59,11 +60,24 @@ const NMDhcpClientFactory *const _nm_dhcp_manager_factories[4] = {
 
 /*****************************************************************************/
 
+NM_GOBJECT_PROPERTIES_DEFINE_BASE (
+	PROP_SOCKET_PATH,
+	PROP_PRIVATE_SERVER_PATH,
+);
+
 typedef struct {
+	char *              socket_path;
+	char *              private_server_path;
+
 	NMBusManager *      dbus_mgr;
 	gulong              new_conn_id;
 	gulong              dis_conn_id;
 	GHashTable *        connections;
+
+	int                 sock_fd;
+	GIOChannel *        sock_channel;
+	guint               sock_watch_id;
+	guint8 *            sock_buf;
 } NMDhcpListenerPrivate;
 
 struct _NMDhcpListener {
@@ -278,6 +292,167 @@ dis_connection_cb (NMBusManager *mgr,
 
 /*****************************************************************************/
 
+static gboolean
+_socket_event_cb (GIOChannel *source,
+                  GIOCondition condition,
+                  gpointer user_data)
+{
+	NMDhcpListener *self = user_data;
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+
+	/* drain the queue. During a renewal wave, many helpers send their
+	 * event at about the same time. */
+	for (;;) {
+		union {
+			struct cmsghdr cmsghdr;
+			char buf[CMSG_SPACE (sizeof (struct ucred))];
+		} cmsg_buf;
+		struct iovec iov = {
+			.iov_base = priv->sock_buf,
+			.iov_len = NM_DHCP_HELPER_SOCKET_MSG_MAX,
+		};
+		struct msghdr msg = {
+			.msg_iov = &iov,
+			.msg_iovlen = 1,
+			.msg_control = &cmsg_buf,
+			.msg_controllen = sizeof (cmsg_buf),
+		};
+		const struct ucred *creds = NULL;
+		struct cmsghdr *cmsg;
+		gs_unref_variant GVariant *parameters = NULL;
+		GBytes *bytes;
+		gssize n;
+		int errsv;
+
+		n = recvmsg (priv->sock_fd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+		if (n < 0) {
+			errsv = errno;
+			if (errsv == EINTR)
+				continue;
+			if (errsv != EAGAIN)
+				_LOGW ("dhcp-event: failure to receive: %s", g_strerror (errsv));
+			break;
+		}
+
+		for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+			if (   cmsg->cmsg_level == SOL_SOCKET
+			    && cmsg->cmsg_type == SCM_CREDENTIALS) {
+				creds = (const struct ucred *) CMSG_DATA (cmsg);
+				break;
+			}
+		}
+
+		/* like the private D-Bus socket, only accept events from root. */
+		if (!creds || creds->uid != 0) {
+			_LOGW ("dhcp-event: ignore message from unprivileged sender (uid %ld)",
+			       creds ? (long) creds->uid : -1L);
+			continue;
+		}
+		if (NM_FLAGS_HAS (msg.msg_flags, MSG_TRUNC)) {
+			_LOGW ("dhcp-event: (pid %ld) ignore truncated message", (long) creds->pid);
+			continue;
+		}
+
+		bytes = g_bytes_new (priv->sock_buf, n);
+		parameters = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE ("(a{sv})"),
+		                                                           bytes,
+		                                                           FALSE));
+		g_bytes_unref (bytes);
+		if (!g_variant_is_normal_form (parameters)) {
+			_LOGW ("dhcp-event: (pid %ld) ignore malformed message", (long) creds->pid);
+			continue;
+		}
+
+		_method_call_handle (self, parameters);
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static void
+_socket_setup (NMDhcpListener *self)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+	nm_auto_close int fd = -1;
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	const int one = 1;
+	int errsv;
+
+	if (g_strlcpy (addr.sun_path, priv->socket_path, sizeof (addr.sun_path)) >= sizeof (addr.sun_path)) {
+		_LOGW ("socket path %s too long", priv->socket_path);
+		return;
+	}
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+	if (fd < 0) {
+		errsv = errno;
+		_LOGW ("failure to create socket: %s", g_strerror (errsv));
+		return;
+	}
+
+	if (setsockopt (fd, SOL_SOCKET, SO_PASSCRED, &one, sizeof (one)) != 0) {
+		errsv = errno;
+		_LOGW ("failure to set SO_PASSCRED: %s", g_strerror (errsv));
+		return;
+	}
+
+	unlink (priv->socket_path);
+	if (bind (fd, (struct sockaddr *) &addr, sizeof (addr)) != 0) {
+		errsv = errno;
+		_LOGW ("failure to bind %s: %s", priv->socket_path, g_strerror (errsv));
+		return;
+	}
+
+	priv->sock_fd = fd;
+	fd = -1;
+	priv->sock_buf = g_malloc (NM_DHCP_HELPER_SOCKET_MSG_MAX);
+	priv->sock_channel = g_io_channel_unix_new (priv->sock_fd);
+	priv->sock_watch_id = g_io_add_watch (priv->sock_channel, G_IO_IN, _socket_event_cb, self);
+}
+
+static void
+_socket_clear (NMDhcpListener *self)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+
+	if (priv->sock_fd < 0)
+		return;
+
+	nm_clear_g_source (&priv->sock_watch_id);
+	g_clear_pointer (&priv->sock_channel, g_io_channel_unref);
+	nm_close (priv->sock_fd);
+	priv->sock_fd = -1;
+	g_clear_pointer (&priv->sock_buf, g_free);
+	unlink (priv->socket_path);
+}
+
+/*****************************************************************************/
+
+static void
+set_property (GObject *object, guint prop_id,
+              const GValue *value, GParamSpec *pspec)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE ((NMDhcpListener *) object);
+
+	switch (prop_id) {
+	case PROP_SOCKET_PATH:
+		/* construct-only */
+		priv->socket_path = g_value_dup_string (value);
+		break;
+	case PROP_PRIVATE_SERVER_PATH:
+		/* construct-only */
+		priv->private_server_path = g_value_dup_string (value);
+		break;
+	default:
+		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+		break;
+	}
+}
+
+/*****************************************************************************/
+
 static void
 nm_dhcp_listener_init (NMDhcpListener *self)
 {
@@ -286,10 +461,28 @@ nm_dhcp_listener_init (NMDhcpListener *self)
 	/* Maps GDBusConnection :: signal-id */
 	priv->connections = g_hash_table_new (nm_direct_hash, NULL);
 
+	priv->sock_fd = -1;
+}
+
+static void
+constructed (GObject *object)
+{
+	NMDhcpListener *self = NM_DHCP_LISTENER (object);
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE (self);
+
+	G_OBJECT_CLASS (nm_dhcp_listener_parent_class)->constructed (object);
+
+	if (!priv->socket_path)
+		priv->socket_path = g_strdup (NM_DHCP_HELPER_SOCKET_PATH);
+	if (!priv->private_server_path)
+		priv->private_server_path = g_strdup (PRIV_SOCK_PATH);
+
+	_socket_setup (self);
+
 	priv->dbus_mgr = nm_bus_manager_get ();
 
 	/* Register the socket our DHCP clients will return lease info on */
-	nm_bus_manager_private_server_register (priv->dbus_mgr, PRIV_SOCK_PATH, PRIV_SOCK_TAG);
+	nm_bus_manager_private_server_register (priv->dbus_mgr, priv->private_server_path, PRIV_SOCK_TAG);
 	priv->new_conn_id = g_signal_connect (priv->dbus_mgr,
 	                                      NM_BUS_MANAGER_PRIVATE_CONNECTION_NEW "::" PRIV_SOCK_TAG,
 	                                      G_CALLBACK (new_connection_cb),
@@ -311,15 +504,45 @@ dispose (GObject *object)
 
 	g_clear_pointer (&priv->connections, g_hash_table_destroy);
 
+	_socket_clear ((NMDhcpListener *) object);
+
 	G_OBJECT_CLASS (nm_dhcp_listener_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+	NMDhcpListenerPrivate *priv = NM_DHCP_LISTENER_GET_PRIVATE ((NMDhcpListener *) object);
+
+	g_free (priv->socket_path);
+	g_free (priv->private_server_path);
+
+	G_OBJECT_CLASS (nm_dhcp_listener_parent_class)->finalize (object);
+}
+
 static void
 nm_dhcp_listener_class_init (NMDhcpListenerClass *listener_class)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (listener_class);
 
+	object_class->set_property = set_property;
+	object_class->constructed = constructed;
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
+
+	obj_properties[PROP_SOCKET_PATH] =
+	    g_param_spec_string (NM_DHCP_LISTENER_SOCKET_PATH, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	obj_properties[PROP_PRIVATE_SERVER_PATH] =
+	    g_param_spec_string (NM_DHCP_LISTENER_PRIVATE_SERVER_PATH, "", "",
+	                         NULL,
+	                         G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY |
+	                         G_PARAM_STATIC_STRINGS);
+
+	g_object_class_install_properties (object_class, _PROPERTY_ENUMS_LAST, obj_properties);
 
 	signals[EVENT] =
 	    g_signal_new (NM_DHCP_LISTENER_EVENT,
@@ -24,6 +24,9 @@
 #define NM_IS_DHCP_LISTENER(obj)        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), NM_TYPE_DHCP_LISTENER))
 #define NM_DHCP_LISTENER_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), NM_TYPE_DHCP_LISTENER, NMDhcpListenerClass))
 
+#define NM_DHCP_LISTENER_SOCKET_PATH         "socket-path"
+#define NM_DHCP_LISTENER_PRIVATE_SERVER_PATH "private-server-path"
+
 #define NM_DHCP_LISTENER_EVENT "event"
 
 typedef struct _NMDhcpListener NMDhcpListener;
@@ -0,0 +1,277 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+/* Microbenchmark for the delivery of DHCP events from nm-dhcp-helper to
+ * NetworkManager. It compares what one helper invocation does to notify
+ * NetworkManager: connecting to the private D-Bus socket and calling
+ * "Notify", versus sending a single datagram. Both use the helper's code
+ * and are received by a real NMDhcpListener. Forking the helper costs
+ * the same for both and is not measured. It is not run by "make check",
+ * invoke it manually as root, because the listener only accepts events
+ * from root:
+ *
+ *   # ./src/dhcp/tests/bench-dhcp-helper [--events=N]
+ *
+ * Compare the numbers relative to each other; absolute values depend on
+ * the machine. */
+
+#include "nm-default.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "dhcp/nm-dhcp-listener.h"
+#include "dhcp/nm-dhcp-helper-notify.h"
+#include "nm-bus-manager.h"
+#include "NetworkManagerUtils.h"
+
+#include "nm-test-utils-core.h"
+
+NMTST_DEFINE ();
+
+static struct {
+	guint n_events;
+} global_opt = {
+	.n_events = 1000,
+};
+
+/*****************************************************************************/
+
+typedef struct {
+	const char *name;
+	guint n;
+	gint64 start_ns;
+} Bench;
+
+static void
+_bench_start (Bench *bench, const char *name, guint n)
+{
+	*bench = (Bench) {
+		.name = name,
+		.n = n,
+		.start_ns = nm_utils_get_monotonic_timestamp_ns (),
+	};
+}
+
+static void
+_bench_end (Bench *bench)
+{
+	gint64 duration_ns = nm_utils_get_monotonic_timestamp_ns () - bench->start_ns;
+
+	g_print ("%-28s %8u events: %9.1f us/event\n",
+	         bench->name,
+	         bench->n,
+	         (double) duration_ns / bench->n / 1000.0);
+}
+
+/*****************************************************************************/
+
+/* roughly what dhclient passes to the helper for a BOUND event. */
+static GVariant *
+_build_parameters (guint i)
+{
+	GVariantBuilder builder;
+	char buf[64];
+	guint j;
+
+#define _add(name, value) \
+	G_STMT_START { \
+		const char *_v = (value); \
+		\
+		g_variant_builder_add (&builder, "{sv}", (name), \
+		                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, _v, strlen (_v), 1)); \
+	} G_STMT_END
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	_add ("interface", nm_sprintf_buf (buf, "mv%u", i));
+	_add ("pid", nm_sprintf_buf (buf, "%u", 10000 + i));
+	_add ("reason", "BOUND");
+	_add ("new_ip_address", "192.168.122.89");
+	_add ("new_subnet_mask", "255.255.255.0");
+	_add ("new_broadcast_address", "192.168.122.255");
+	_add ("new_routers", "192.168.122.1");
+	_add ("new_domain_name_servers", "192.168.122.1 192.168.122.2");
+	_add ("new_domain_name", "example.com");
+	_add ("new_host_name", "host");
+	_add ("new_dhcp_lease_time", "3600");
+	_add ("new_dhcp_server_identifier", "192.168.122.1");
+	_add ("new_dhcp_message_type", "5");
+	_add ("new_network_number", "192.168.122.0");
+	_add ("new_expiry", "1519912345");
+	for (j = 0; j < 16; j++) {
+		char name[32];
+
+		_add (nm_sprintf_buf (name, "requested_option_%u", j), "1");
+	}
+#undef _add
+
+	return g_variant_ref_sink (g_variant_new ("(a{sv})", &builder));
+}
+
+/*****************************************************************************/
+
+static guint n_received;
+
+static gboolean
+_event_cb (NMDhcpListener *listener,
+           const char *iface,
+           int pid,
+           GVariant *options,
+           const char *reason,
+           gpointer user_data)
+{
+	n_received++;
+	return TRUE;
+}
+
+typedef struct {
+	const char *socket_path;
+	const char *dbus_address;
+	guint n;
+	GError *error;
+	volatile gint done;
+} SendData;
+
+/* the listener runs in the main context, so the helper's blocking
+ * calls are made from another thread. */
+static gpointer
+_send_thread (gpointer user_data)
+{
+	SendData *data = user_data;
+	guint i;
+
+	for (i = 0; i < data->n; i++) {
+		gs_unref_variant GVariant *parameters = NULL;
+		gboolean success;
+
+		parameters = _build_parameters (i);
+		if (data->socket_path)
+			success = nm_dhcp_helper_notify_socket (data->socket_path, parameters, &data->error);
+		else
+			success = nm_dhcp_helper_notify_dbus (data->dbus_address, parameters, NULL, &data->error);
+		if (!success)
+			break;
+	}
+
+	g_atomic_int_set (&data->done, 1);
+	g_main_context_wakeup (NULL);
+	return NULL;
+}
+
+static void
+_bench_run (const char *name, const char *socket_path, const char *dbus_address, guint n)
+{
+	SendData data = {
+		.socket_path = socket_path,
+		.dbus_address = dbus_address,
+		.n = n,
+	};
+	GThread *thread;
+	Bench bench;
+
+	n_received = 0;
+
+	_bench_start (&bench, name, n);
+	thread = g_thread_new ("bench-dhcp-helper", _send_thread, &data);
+	while (n_received < n) {
+		if (g_atomic_int_get (&data.done) && data.error)
+			break;
+		g_main_context_iteration (NULL, TRUE);
+	}
+	g_thread_join (thread);
+	_bench_end (&bench);
+
+	if (data.error)
+		g_error ("%s: failure to send event: %s", name, data.error->message);
+	if (n_received != n)
+		g_error ("%s: received %u of %u events", name, n_received, n);
+}
+
+/*****************************************************************************/
+
+static gboolean
+read_argv (int *argc, char ***argv)
+{
+	GOptionContext *context;
+	int n_events = global_opt.n_events;
+	GOptionEntry options[] = {
+		{ "events", 'n', 0, G_OPTION_ARG_INT, &n_events, "Number of events to deliver", "N" },
+		{ 0 },
+	};
+	gs_free_error GError *error = NULL;
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, "Benchmark the delivery of DHCP events.");
+	g_option_context_add_main_entries (context, options, NULL);
+
+	if (!g_option_context_parse (context, argc, argv, &error)) {
+		g_warning ("Error parsing command line arguments: %s", error->message);
+		g_option_context_free (context);
+		return FALSE;
+	}
+
+	g_option_context_free (context);
+	global_opt.n_events = MAX (n_events, 1);
+	return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+	gs_free char *dir = NULL;
+	gs_free char *socket_path = NULL;
+	gs_free char *private_server_path = NULL;
+	gs_free char *dbus_address = NULL;
+	NMDhcpListener *listener;
+
+	nmtst_init_with_logging (&argc, &argv, "WARN", "DEFAULT");
+
+	if (!read_argv (&argc, &argv))
+		return 2;
+
+	if (getuid () != 0) {
+		g_print ("Missing permission: must run as root\n");
+		return EXIT_FAILURE;
+	}
+
+	nm_bus_manager_setup (g_object_new (NM_TYPE_BUS_MANAGER, NULL));
+
+	dir = g_dir_make_tmp ("bench-dhcp-helper-XXXXXX", NULL);
+	if (!dir)
+		g_error ("failure to create temporary directory");
+	socket_path = g_build_filename (dir, "dhcp-helper", NULL);
+	private_server_path = g_build_filename (dir, "private-dhcp", NULL);
+	dbus_address = g_strdup_printf ("unix:path=%s", private_server_path);
+
+	listener = g_object_new (NM_TYPE_DHCP_LISTENER,
+	                         NM_DHCP_LISTENER_SOCKET_PATH, socket_path,
+	                         NM_DHCP_LISTENER_PRIVATE_SERVER_PATH, private_server_path,
+	                         NULL);
+	g_signal_connect (listener, NM_DHCP_LISTENER_EVENT, G_CALLBACK (_event_cb), NULL);
+
+	_bench_run ("D-Bus connect + Notify", NULL, dbus_address, global_opt.n_events);
+	_bench_run ("datagram", socket_path, NULL, global_opt.n_events);
+
+	g_signal_handlers_disconnect_by_func (listener, G_CALLBACK (_event_cb), NULL);
+	g_object_unref (listener);
+	unlink (socket_path);
+	unlink (private_server_path);
+	rmdir (dir);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,385 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "dhcp/nm-dhcp-listener.h"
+#include "dhcp/nm-dhcp-helper-api.h"
+#include "dhcp/nm-dhcp-helper-notify.h"
+#include "nm-bus-manager.h"
+
+#include "nm-test-utils-core.h"
+
+/* The listener and the private D-Bus server only accept events from
+ * root. Without it, only the rejection of unprivileged senders is
+ * tested. */
+
+static struct {
+	NMDhcpListener *listener;
+	GMainLoop *loop;
+	char *dir;
+	char *socket_path;
+	char *dbus_address;
+
+	guint n_events;
+	char *iface;
+	int pid;
+	char *reason;
+} gl;
+
+/*****************************************************************************/
+
+static GVariant *
+_build_parameters (const char *iface, int pid, const char *reason)
+{
+	GVariantBuilder builder;
+	char buf[64];
+
+#define _add(name, value) \
+	G_STMT_START { \
+		const char *_v = (value); \
+		\
+		g_variant_builder_add (&builder, "{sv}", (name), \
+		                       g_variant_new_fixed_array (G_VARIANT_TYPE_BYTE, _v, strlen (_v), 1)); \
+	} G_STMT_END
+
+	/* what nm-dhcp-helper builds from its environment. */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE_VARDICT);
+	_add ("interface", iface);
+	_add ("pid", nm_sprintf_buf (buf, "%d", pid));
+	_add ("reason", reason);
+	_add ("new_ip_address", "192.168.122.89");
+#undef _add
+
+	return g_variant_ref_sink (g_variant_new ("(a{sv})", &builder));
+}
+
+static gboolean
+_event_cb (NMDhcpListener *listener,
+           const char *iface,
+           int pid,
+           GVariant *options,
+           const char *reason,
+           gpointer user_data)
+{
+	gl.n_events++;
+	g_free (gl.iface);
+	gl.iface = g_strdup (iface);
+	gl.pid = pid;
+	g_free (gl.reason);
+	gl.reason = g_strdup (reason);
+
+	g_main_loop_quit (gl.loop);
+	return TRUE;
+}
+
+static gboolean
+_wait_timeout_cb (gpointer user_data)
+{
+	*((guint *) user_data) = 0;
+	g_main_loop_quit (gl.loop);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_wait_for_event (guint n_events)
+{
+	guint timeout_id;
+
+	timeout_id = g_timeout_add (5000, _wait_timeout_cb, &timeout_id);
+	while (gl.n_events < n_events && timeout_id)
+		g_main_loop_run (gl.loop);
+	nm_clear_g_source (&timeout_id);
+
+	g_assert_cmpint (gl.n_events, ==, n_events);
+}
+
+/* the listener reads the socket from the main context. When this returns,
+ * every datagram that was sent before was handled. */
+static void
+_dispatch_pending (void)
+{
+	while (g_main_context_iteration (NULL, FALSE)) {
+	}
+}
+
+/* sends @len bytes to the listener. If @uid is not -1, the datagram
+ * claims to come from that user, which requires CAP_SETUID. */
+static gboolean
+_send_raw (const void *data, gsize len, uid_t uid, int *out_errno)
+{
+	nm_auto_close int fd = -1;
+	struct sockaddr_un addr = {
+		.sun_family = AF_UNIX,
+	};
+	union {
+		struct cmsghdr cmsghdr;
+		char buf[CMSG_SPACE (sizeof (struct ucred))];
+	} cmsg_buf;
+	struct iovec iov = {
+		.iov_base = (void *) data,
+		.iov_len = len,
+	};
+	struct msghdr msg = {
+		.msg_name = &addr,
+		.msg_namelen = sizeof (addr),
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	struct cmsghdr *cmsg;
+	struct ucred creds;
+
+	g_assert_cmpint (strlen (gl.socket_path), <, sizeof (addr.sun_path));
+	strcpy (addr.sun_path, gl.socket_path);
+
+	if (uid != (uid_t) -1) {
+		creds = (struct ucred) {
+			.pid = getpid (),
+			.uid = uid,
+			.gid = getgid (),
+		};
+		memset (&cmsg_buf, 0, sizeof (cmsg_buf));
+		msg.msg_control = &cmsg_buf;
+		msg.msg_controllen = sizeof (cmsg_buf);
+		cmsg = CMSG_FIRSTHDR (&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_CREDENTIALS;
+		cmsg->cmsg_len = CMSG_LEN (sizeof (struct ucred));
+		memcpy (CMSG_DATA (cmsg), &creds, sizeof (creds));
+	}
+
+	fd = socket (AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	g_assert_cmpint (fd, >=, 0);
+
+	if (sendmsg (fd, &msg, 0) != (gssize) len) {
+		*out_errno = errno;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*****************************************************************************/
+
+typedef struct {
+	GVariant *parameters;
+	gboolean success;
+	GError *notify_error;
+	GError *error;
+	volatile gint done;
+} NotifyDBusData;
+
+static gpointer
+_notify_dbus_thread (gpointer user_data)
+{
+	NotifyDBusData *data = user_data;
+
+	data->success = nm_dhcp_helper_notify_dbus (gl.dbus_address,
+	                                            data->parameters,
+	                                            &data->notify_error,
+	                                            &data->error);
+	g_atomic_int_set (&data->done, 1);
+	g_main_context_wakeup (NULL);
+	return NULL;
+}
+
+/* the D-Bus server runs in the main context, so the helper's
+ * blocking calls must be made from another thread. */
+static void
+_notify_dbus (NotifyDBusData *data)
+{
+	GThread *thread;
+
+	thread = g_thread_new ("test-notify-dbus", _notify_dbus_thread, data);
+	while (!g_atomic_int_get (&data->done))
+		g_main_context_iteration (NULL, TRUE);
+	g_thread_join (thread);
+}
+
+/*****************************************************************************/
+
+static void
+test_unprivileged_sender (void)
+{
+	gs_unref_variant GVariant *parameters = NULL;
+	gs_free_error GError *error = NULL;
+	guint n_events = gl.n_events;
+	int errsv;
+
+	parameters = _build_parameters ("eth0", 4711, "BOUND");
+
+	if (getuid () == 0) {
+		if (!_send_raw (g_variant_get_data (parameters), g_variant_get_size (parameters), 65534, &errsv)) {
+			g_assert_cmpint (errsv, ==, EPERM);
+			g_test_skip ("cannot send with the credentials of another user");
+			return;
+		}
+	} else {
+		/* the kernel attaches our own credentials. */
+		nmtst_assert_success (nm_dhcp_helper_notify_socket (gl.socket_path, parameters, &error), error);
+	}
+	NMTST_EXPECT_NM_WARN ("*ignore message from unprivileged sender*");
+	_dispatch_pending ();
+	g_test_assert_expected_messages ();
+
+	g_assert_cmpint (gl.n_events, ==, n_events);
+}
+
+static void
+test_event (void)
+{
+	gs_unref_variant GVariant *parameters = NULL;
+	gs_free_error GError *error = NULL;
+	guint n_events = gl.n_events;
+
+	if (getuid () != 0) {
+		g_test_skip ("requires root");
+		return;
+	}
+
+	parameters = _build_parameters ("eth1", 4712, "BOUND");
+	nmtst_assert_success (nm_dhcp_helper_notify_socket (gl.socket_path, parameters, &error), error);
+	_wait_for_event (n_events + 1);
+
+	g_assert_cmpstr (gl.iface, ==, "eth1");
+	g_assert_cmpint (gl.pid, ==, 4712);
+	g_assert_cmpstr (gl.reason, ==, "BOUND");
+}
+
+static void
+test_truncated (void)
+{
+	gs_free guint8 *buf = NULL;
+	gs_unref_variant GVariant *parameters = NULL;
+	gs_free_error GError *error = NULL;
+	guint n_events = gl.n_events;
+	int errsv;
+
+	if (getuid () != 0) {
+		g_test_skip ("requires root");
+		return;
+	}
+
+	/* the helper refuses to send this, the listener must drop it. */
+	buf = g_malloc0 (NM_DHCP_HELPER_SOCKET_MSG_MAX + 1);
+	if (!_send_raw (buf, NM_DHCP_HELPER_SOCKET_MSG_MAX + 1, (uid_t) -1, &errsv))
+		g_error ("failure to send %d bytes: %s", NM_DHCP_HELPER_SOCKET_MSG_MAX + 1, g_strerror (errsv));
+	NMTST_EXPECT_NM_WARN ("*ignore truncated message*");
+	_dispatch_pending ();
+	g_test_assert_expected_messages ();
+
+	g_assert_cmpint (gl.n_events, ==, n_events);
+
+	/* the socket still works afterwards. */
+	parameters = _build_parameters ("eth2", 4713, "RENEW");
+	nmtst_assert_success (nm_dhcp_helper_notify_socket (gl.socket_path, parameters, &error), error);
+	_wait_for_event (n_events + 1);
+	g_assert_cmpstr (gl.iface, ==, "eth2");
+	g_assert_cmpstr (gl.reason, ==, "RENEW");
+}
+
+static void
+test_dbus_fallback (void)
+{
+	gs_unref_variant GVariant *parameters = NULL;
+	gs_free char *no_listener_path = NULL;
+	NotifyDBusData data = { 0 };
+	GError *error = NULL;
+	guint n_events = gl.n_events;
+
+	if (getuid () != 0) {
+		g_test_skip ("requires root");
+		return;
+	}
+
+	parameters = _build_parameters ("eth3", 4714, "BOUND");
+
+	/* like nm-dhcp-helper talking to a NetworkManager without the socket. */
+	no_listener_path = g_build_filename (gl.dir, "no-listener", NULL);
+	g_assert (!nm_dhcp_helper_notify_socket (no_listener_path, parameters, &error));
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND);
+	g_clear_error (&error);
+
+	data.parameters = parameters;
+	_notify_dbus (&data);
+	nmtst_assert_success (data.success, data.error);
+	g_assert_no_error (data.notify_error);
+
+	_dispatch_pending ();
+	g_assert_cmpint (gl.n_events, ==, n_events + 1);
+	g_assert_cmpstr (gl.iface, ==, "eth3");
+	g_assert_cmpint (gl.pid, ==, 4714);
+	g_assert_cmpstr (gl.reason, ==, "BOUND");
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	gs_free char *private_server_path = NULL;
+	int result;
+
+	nmtst_init_assert_logging (&argc, &argv, "INFO", "DEFAULT");
+
+	nm_bus_manager_setup (g_object_new (NM_TYPE_BUS_MANAGER, NULL));
+
+	gl.dir = g_dir_make_tmp ("test-dhcp-listener-XXXXXX", NULL);
+	if (!gl.dir)
+		g_error ("failure to create temporary directory");
+	gl.socket_path = g_build_filename (gl.dir, "dhcp-helper", NULL);
+	private_server_path = g_build_filename (gl.dir, "private-dhcp", NULL);
+	gl.dbus_address = g_strdup_printf ("unix:path=%s", private_server_path);
+	gl.loop = g_main_loop_new (NULL, FALSE);
+
+	/* the private server can only be registered once per process, so
+	 * all tests share one listener. */
+	gl.listener = g_object_new (NM_TYPE_DHCP_LISTENER,
+	                            NM_DHCP_LISTENER_SOCKET_PATH, gl.socket_path,
+	                            NM_DHCP_LISTENER_PRIVATE_SERVER_PATH, private_server_path,
+	                            NULL);
+	g_signal_connect (gl.listener, NM_DHCP_LISTENER_EVENT, G_CALLBACK (_event_cb), NULL);
+
+	g_test_add_func ("/dhcp/listener/unprivileged-sender", test_unprivileged_sender);
+	g_test_add_func ("/dhcp/listener/event", test_event);
+	g_test_add_func ("/dhcp/listener/truncated", test_truncated);
+	g_test_add_func ("/dhcp/listener/dbus-fallback", test_dbus_fallback);
+
+	result = g_test_run ();
+
+	g_signal_handlers_disconnect_by_func (gl.listener, G_CALLBACK (_event_cb), NULL);
+	g_clear_object (&gl.listener);
+	g_main_loop_unref (gl.loop);
+	unlink (gl.socket_path);
+	unlink (private_server_path);
+	rmdir (gl.dir);
+	g_free (gl.dir);
+	g_free (gl.socket_path);
+	g_free (gl.dbus_address);
+	g_free (gl.iface);
+	g_free (gl.reason);
+
+	return result;
+}
@@ -26,6 +26,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <resolv.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/ioctl.h>
@@ -66,6 +67,37 @@
 #define NETCONFIG_PATH "/sbin/netconfig"
 #endif
 
+#define MY_RESOLV_CONF NMRUNDIR "/resolv.conf"
+#define MY_RESOLV_CONF_TMP MY_RESOLV_CONF ".tmp"
+
+/* the files that the manager writes and the resolvconf helper
+ * it calls. Tests change them, see _nm_dns_manager_set_paths_for_testing(). */
+static struct {
+	const char *resolvconf;
+	const char *my_resolv_conf;
+	const char *my_resolv_conf_tmp;
+} _paths = {
+	.resolvconf         = RESOLVCONF_PATH,
+	.my_resolv_conf     = MY_RESOLV_CONF,
+	.my_resolv_conf_tmp = MY_RESOLV_CONF_TMP,
+};
+
+void
+_nm_dns_manager_set_paths_for_testing (const char *resolvconf_path,
+                                       const char *my_resolv_conf)
+{
+	static char *my_resolv_conf_tmp;
+
+	g_return_if_fail (resolvconf_path && my_resolv_conf);
+
+	g_free (my_resolv_conf_tmp);
+	my_resolv_conf_tmp = g_strconcat (my_resolv_conf, ".tmp", NULL);
+
+	_paths.resolvconf = resolvconf_path;
+	_paths.my_resolv_conf = my_resolv_conf;
+	_paths.my_resolv_conf_tmp = my_resolv_conf_tmp;
+}
+
 #define PLUGIN_RATELIMIT_INTERVAL    30
 #define PLUGIN_RATELIMIT_BURST       5
 #define PLUGIN_RATELIMIT_DELAY       300
@@ -118,6 +150,13 @@ typedef struct {
 	char *hostname;
 	guint updates_queue;
 
+	/* coalesces the updates from the main loop into one. */
+	guint update_idle_id;
+
+	/* the running update of resolv.conf, and the one that waits for it. */
+	struct _RcJob *rc_job;
+	struct _RcJob *rc_job_next;
+
 	guint8 hash[HASH_LEN];  /* SHA1 hash of current DNS config */
 	guint8 prev_hash[HASH_LEN];  /* Hash when begin_updates() was called */
 
@@ -479,6 +518,38 @@ merge_one_ip_config (NMResolvConfData *rc,
 	}
 }
 
+static gboolean
+_write_to_child (int fd, const char *str, gsize len)
+{
+	gssize l;
+
+	while (len > 0) {
+		l = write (fd, str, len);
+		if (l < 0) {
+			if (errno == EINTR)
+				continue;
+			return FALSE;
+		}
+		str += l;
+		len -= l;
+	}
+	return TRUE;
+}
+
+static gboolean
+_child_status_check (const char *name, int status, GError **error)
+{
+	if (WIFEXITED (status) && WEXITSTATUS (status) == EXIT_SUCCESS)
+		return TRUE;
+
+	g_set_error (error, NM_MANAGER_ERROR, NM_MANAGER_ERROR_FAILED,
+	             "Error calling %s: %s %d",
+	             name,
+	             WIFEXITED (status) ? "exited with status" : (WIFSIGNALED (status) ? "exited with signal" : "exited with unknown reason"),
+	             WIFEXITED (status) ? WEXITSTATUS (status) : (WIFSIGNALED (status) ? WTERMSIG (status) : status));
+	return FALSE;
+}
+
 static GPid
 run_netconfig (NMDnsManager *self, GError **error, gint *stdin_fd)
 {
@@ -522,18 +593,19 @@ netconfig_construct_strv (NMDnsManager *self, GString *str, const char *key, con
 	}
 }
 
+/* Spawns netconfig and passes the configuration on its stdin. The
+ * caller is responsible to wait for @out_pid to exit. */
 static SpawnResult
 dispatch_netconfig (NMDnsManager *self,
                     const char *const*searches,
                     const char *const*nameservers,
                     const char *nis_domain,
                     const char *const*nis_servers,
+                    GPid *out_pid,
                     GError **error)
 {
 	GPid pid;
 	gint fd;
-	int status;
-	gssize l;
 	nm_auto_free_gstring GString *str = NULL;
 
 	pid = run_netconfig (self, error, &fd);
@@ -551,31 +623,11 @@ dispatch_netconfig (NMDnsManager *self,
 	netconfig_construct_str (self, str, "NISDOMAIN", nis_domain);
 	netconfig_construct_strv (self, str, "NISSERVERS", nis_servers);
 
-again:
-	l = write (fd, str->str, str->len);
-	if (l == -1)  {
-		if (errno == EINTR)
-			goto again;
-	}
-
+	/* netconfig reads the input until EOF, errors show up in its exit status. */
+	_write_to_child (fd, str->str, str->len);
 	nm_close (fd);
 
-	/* Wait until the process exits */
-	if (!nm_utils_kill_child_sync (pid, 0, LOGD_DNS, "netconfig", &status, 1000, 0)) {
-		int errsv = errno;
-
-		g_set_error (error, NM_MANAGER_ERROR, NM_MANAGER_ERROR_FAILED,
-		             "Error waiting for netconfig to exit: %s",
-		             strerror (errsv));
-		return SR_ERROR;
-	}
-	if (!WIFEXITED (status) || WEXITSTATUS (status) != EXIT_SUCCESS) {
-		g_set_error (error, NM_MANAGER_ERROR, NM_MANAGER_ERROR_FAILED,
-		             "Error calling netconfig: %s %d",
-		             WIFEXITED (status) ? "exited with status" : (WIFSIGNALED (status) ? "exited with signal" : "exited with unknown reason"),
-		             WIFEXITED (status) ? WEXITSTATUS (status) : (WIFSIGNALED (status) ? WTERMSIG (status) : status));
-		return SR_ERROR;
-	}
+	*out_pid = pid;
 	return SR_SUCCESS;
 }
 
@@ -650,89 +702,56 @@ write_resolv_conf_contents (FILE *f,
 	return TRUE;
 }
 
-static gboolean
-write_resolv_conf (FILE *f,
-                   char **searches,
-                   char **nameservers,
-                   char **options,
-                   GError **error)
-{
-	gs_free char *content = NULL;
-
-	content = create_resolv_conf (searches, nameservers, options);
-	return write_resolv_conf_contents (f, content, error);
-}
-
+/* Spawns resolvconf and passes the configuration on its stdin. The
+ * caller is responsible to wait for @out_pid to exit. */
 static SpawnResult
 dispatch_resolvconf (NMDnsManager *self,
                      char **searches,
                      char **nameservers,
                      char **options,
+                     GPid *out_pid,
                      GError **error)
 {
-	gs_free char *cmd = NULL;
-	FILE *f;
-	gboolean success = FALSE;
-	int errnosv, err;
-	char *argv[] = { RESOLVCONF_PATH, "-d", "NetworkManager", NULL };
-	int status;
+	gs_free char *content = NULL;
+	char *argv[] = { (char *) _paths.resolvconf, NULL, "NetworkManager", NULL };
+	GPid pid;
+	gint fd;
 
-	if (!g_file_test (RESOLVCONF_PATH, G_FILE_TEST_IS_EXECUTABLE)) {
-		g_set_error_literal (error,
-		                     NM_MANAGER_ERROR,
-		                     NM_MANAGER_ERROR_FAILED,
-		                     RESOLVCONF_PATH " is not executable");
+	if (!g_file_test (_paths.resolvconf, G_FILE_TEST_IS_EXECUTABLE)) {
+		g_set_error (error,
+		             NM_MANAGER_ERROR,
+		             NM_MANAGER_ERROR_FAILED,
+		             "%s is not executable",
+		             _paths.resolvconf);
 		return SR_NOTFOUND;
 	}
 
 	if (!searches && !nameservers) {
-		_LOGI ("Removing DNS information from %s", RESOLVCONF_PATH);
+		_LOGI ("Removing DNS information from %s", _paths.resolvconf);
 
-		if (!g_spawn_sync ("/", argv, NULL, 0, NULL, NULL, NULL, NULL, &status, error))
+		argv[1] = "-d";
+		if (!g_spawn_async ("/", argv, NULL, G_SPAWN_DO_NOT_REAP_CHILD, NULL, NULL, &pid, error))
 			return SR_ERROR;
 
-		if (status != 0) {
-			g_set_error (error,
-			             NM_MANAGER_ERROR,
-			             NM_MANAGER_ERROR_FAILED,
-			             "%s returned error code",
-			             RESOLVCONF_PATH);
-			return SR_ERROR;
-		}
-
+		*out_pid = pid;
 		return SR_SUCCESS;
 	}
 
-	_LOGI ("Writing DNS information to %s", RESOLVCONF_PATH);
+	_LOGI ("Writing DNS information to %s", _paths.resolvconf);
 
-	cmd = g_strconcat (RESOLVCONF_PATH, " -a ", "NetworkManager", NULL);
-	if ((f = popen (cmd, "w")) == NULL) {
-		g_set_error (error,
-		             NM_MANAGER_ERROR,
-		             NM_MANAGER_ERROR_FAILED,
-		             "Could not write to %s: %s",
-		             RESOLVCONF_PATH,
-		             g_strerror (errno));
+	argv[1] = "-a";
+	if (!g_spawn_async_with_pipes ("/", argv, NULL, G_SPAWN_DO_NOT_REAP_CHILD, NULL,
+	                               NULL, &pid, &fd, NULL, NULL, error))
 		return SR_ERROR;
-	}
 
-	success = write_resolv_conf (f, searches, nameservers, options, error);
-	err = pclose (f);
-	if (err < 0) {
-		errnosv = errno;
-		g_clear_error (error);
-		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errnosv),
-		             "Failed to close pipe to resolvconf: %d", errnosv);
-		return SR_ERROR;
-	} else if (err > 0) {
-		_LOGW ("resolvconf failed with status %d", err);
-		g_clear_error (error);
-		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
-		             "resolvconf failed with status %d", err);
-		return SR_ERROR;
-	}
+	content = create_resolv_conf (searches, nameservers, options);
 
-	return success ? SR_SUCCESS : SR_ERROR;
+	/* resolvconf reads the input until EOF, errors show up in its exit status. */
+	_write_to_child (fd, content, strlen (content));
+	nm_close (fd);
+
+	*out_pid = pid;
+	return SR_SUCCESS;
 }
 
 static const char *
@@ -749,8 +768,6 @@ _read_link_cached (const char *path, gboolean *is_cached, char **cached)
 	return (*cached = g_file_read_link (path, NULL));
 }
 
-#define MY_RESOLV_CONF NMRUNDIR "/resolv.conf"
-#define MY_RESOLV_CONF_TMP MY_RESOLV_CONF ".tmp"
 #define RESOLV_CONF_TMP "/etc/.resolv.conf.NetworkManager"
 
 static SpawnResult
@@ -780,9 +797,9 @@ update_resolv_conf (NMDnsManager *self,
 	 * internal resolv.conf file. */
 	if (rc_manager == NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED) {
 		if (nm_streq0 (_read_link_cached (_PATH_RESCONF, &resconf_link_cached, &resconf_link),
-		               MY_RESOLV_CONF)) {
+		               _paths.my_resolv_conf)) {
 			_LOGD ("update-resolv-conf: not updating " _PATH_RESCONF
-			       " since it points to " MY_RESOLV_CONF);
+			       " since it points to %s", _paths.my_resolv_conf);
 			return SR_SUCCESS;
 		}
 	}
@@ -815,16 +832,16 @@ update_resolv_conf (NMDnsManager *self,
 		}
 	}
 
-	if ((f = fopen (MY_RESOLV_CONF_TMP, "we")) == NULL) {
+	if ((f = fopen (_paths.my_resolv_conf_tmp, "we")) == NULL) {
 		errsv = errno;
 		g_set_error (error,
 		             NM_MANAGER_ERROR,
 		             NM_MANAGER_ERROR_FAILED,
 		             "Could not open %s: %s",
-		             MY_RESOLV_CONF_TMP,
+		             _paths.my_resolv_conf_tmp,
 		             g_strerror (errsv));
 		_LOGT ("update-resolv-conf: open temporary file %s failed (%s)",
-		       MY_RESOLV_CONF_TMP, g_strerror (errsv));
+		       _paths.my_resolv_conf_tmp, g_strerror (errsv));
 		return SR_ERROR;
 	}
 
@@ -832,7 +849,7 @@ update_resolv_conf (NMDnsManager *self,
 	if (!success) {
 		errsv = errno;
 		_LOGT ("update-resolv-conf: write temporary file %s failed (%s)",
-		       MY_RESOLV_CONF_TMP, g_strerror (errsv));
+		       _paths.my_resolv_conf_tmp, g_strerror (errsv));
 	}
 
 	if (fclose (f) < 0) {
@@ -845,25 +862,25 @@ update_resolv_conf (NMDnsManager *self,
 			             NM_MANAGER_ERROR,
 			             NM_MANAGER_ERROR_FAILED,
 			             "Could not close %s: %s",
-			             MY_RESOLV_CONF_TMP,
+			             _paths.my_resolv_conf_tmp,
 			             g_strerror (errsv));
 			_LOGT ("update-resolv-conf: close temporary file %s failed (%s)",
-			       MY_RESOLV_CONF_TMP, g_strerror (errsv));
+			       _paths.my_resolv_conf_tmp, g_strerror (errsv));
 		}
 		return SR_ERROR;
 	} else if (!success)
 		return SR_ERROR;
 
-	if (rename (MY_RESOLV_CONF_TMP, MY_RESOLV_CONF) < 0) {
+	if (rename (_paths.my_resolv_conf_tmp, _paths.my_resolv_conf) < 0) {
 		errsv = errno;
 		g_set_error (error,
 		             NM_MANAGER_ERROR,
 		             NM_MANAGER_ERROR_FAILED,
 		             "Could not replace %s: %s",
-		             MY_RESOLV_CONF,
+		             _paths.my_resolv_conf,
 		             g_strerror (errno));
 		_LOGT ("update-resolv-conf: failed to rename temporary file %s to %s (%s)",
-		       MY_RESOLV_CONF_TMP, MY_RESOLV_CONF, g_strerror (errsv));
+		       _paths.my_resolv_conf_tmp, _paths.my_resolv_conf, g_strerror (errsv));
 		return SR_ERROR;
 	}
 
@@ -875,14 +892,14 @@ update_resolv_conf (NMDnsManager *self,
 
 	if (   rc_manager != NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK
 	    || !_read_link_cached (_PATH_RESCONF, &resconf_link_cached, &resconf_link)) {
-		_LOGT ("update-resolv-conf: write internal file %s succeeded", MY_RESOLV_CONF);
+		_LOGT ("update-resolv-conf: write internal file %s succeeded", _paths.my_resolv_conf);
 		return SR_SUCCESS;
 	}
 
 	if (!nm_streq0 (_read_link_cached (_PATH_RESCONF, &resconf_link_cached, &resconf_link),
-	                MY_RESOLV_CONF)) {
+	                _paths.my_resolv_conf)) {
 		_LOGT ("update-resolv-conf: write internal file %s succeeded (don't touch symlink %s linking to %s)",
-		       MY_RESOLV_CONF, _PATH_RESCONF,
+		       _paths.my_resolv_conf, _PATH_RESCONF,
 		       _read_link_cached (_PATH_RESCONF, &resconf_link_cached, &resconf_link));
 		return SR_SUCCESS;
 	}
@@ -901,22 +918,22 @@ update_resolv_conf (NMDnsManager *self,
 		             g_strerror (errsv));
 		_LOGT ("update-resolv-conf: write internal file %s succeeded "
 		       "but canot delete temporary file %s: %s",
-		       MY_RESOLV_CONF, RESOLV_CONF_TMP, g_strerror (errsv));
+		       _paths.my_resolv_conf, RESOLV_CONF_TMP, g_strerror (errsv));
 		return SR_ERROR;
 	}
 
-	if (symlink (MY_RESOLV_CONF, RESOLV_CONF_TMP) == -1) {
+	if (symlink (_paths.my_resolv_conf, RESOLV_CONF_TMP) == -1) {
 		errsv = errno;
 		g_set_error (error,
 		             NM_MANAGER_ERROR,
 		             NM_MANAGER_ERROR_FAILED,
 		             "Could not create symlink %s pointing to %s: %s",
 		             RESOLV_CONF_TMP,
-		             MY_RESOLV_CONF,
+		             _paths.my_resolv_conf,
 		             g_strerror (errsv));
 		_LOGT ("update-resolv-conf: write internal file %s succeeded "
 		       "but failed to symlink %s: %s",
-		       MY_RESOLV_CONF, RESOLV_CONF_TMP, g_strerror (errsv));
+		       _paths.my_resolv_conf, RESOLV_CONF_TMP, g_strerror (errsv));
 		return SR_ERROR;
 	}
 
@@ -931,15 +948,260 @@ update_resolv_conf (NMDnsManager *self,
 		             g_strerror (errsv));
 		_LOGT ("update-resolv-conf: write internal file %s succeeded "
 		       "but failed to rename temporary symlink %s to %s: %s",
-		       MY_RESOLV_CONF, RESOLV_CONF_TMP, _PATH_RESCONF, g_strerror (errsv));
+		       _paths.my_resolv_conf, RESOLV_CONF_TMP, _PATH_RESCONF, g_strerror (errsv));
 		return SR_ERROR;
 	}
 
 	_LOGT ("update-resolv-conf: write internal file %s succeeded and update symlink %s",
-	       MY_RESOLV_CONF, _PATH_RESCONF);
+	       _paths.my_resolv_conf, _PATH_RESCONF);
 	return SR_SUCCESS;
 }
 
+/*****************************************************************************/
+
+/* Writing resolv.conf and calling resolvconf or netconfig can block
+ * for a long time. It is done in a RcJob, outside of the main loop:
+ * the files are written in a worker thread and the helper programs
+ * are reaped by a child watch. Only one job runs at a time; while it
+ * runs, only the latest configuration is kept for the next job. */
+typedef struct _RcJob {
+	NMDnsManager *self;
+	guint64 serial;
+
+	/* how update_resolv_conf() writes the files. */
+	NMDnsManagerResolvConfManager file_rc_manager;
+
+	/* resolvconf, netconfig, or unmanaged for no helper. */
+	NMDnsManagerResolvConfManager helper_rc_manager;
+
+	char **searches;
+	char **nameservers;
+	char **options;
+	char **nis_servers;
+	char *nis_domain;
+
+	GError *file_error;
+	GError *helper_error;
+
+	GPid pid;
+	guint pid_timeout_id;
+	guint n_pending;
+
+	/* whether the files are the result of the update, otherwise their
+	 * errors are ignored. */
+	bool file_report:1;
+
+	/* whether resolv.conf is managed, and the result should be signaled. */
+	bool update:1;
+} RcJob;
+
+/* serializes the file writes of the worker threads and of synchronous
+ * jobs. Stale jobs don't overwrite the files of newer ones. */
+static GMutex rc_job_write_lock;
+static guint64 rc_job_write_serial;
+static guint64 rc_job_serial_counter;
+
+/* how long to wait for resolvconf or netconfig before killing it. */
+#define RC_JOB_CHILD_TIMEOUT_MSEC 1000
+
+static void _rc_job_start (NMDnsManager *self, RcJob *job, gboolean sync);
+
+static void
+_rc_job_free (RcJob *job)
+{
+	g_strfreev (job->searches);
+	g_strfreev (job->nameservers);
+	g_strfreev (job->options);
+	g_strfreev (job->nis_servers);
+	g_free (job->nis_domain);
+	g_clear_error (&job->file_error);
+	g_clear_error (&job->helper_error);
+	g_object_unref (job->self);
+	g_slice_free (RcJob, job);
+}
+
+static void
+_rc_job_write (RcJob *job)
+{
+	NMDnsManager *self = job->self;
+
+	g_mutex_lock (&rc_job_write_lock);
+	if (job->serial < rc_job_write_serial)
+		_LOGT ("update-resolv-conf: skip outdated update");
+	else {
+		rc_job_write_serial = job->serial;
+		update_resolv_conf (self, job->searches, job->nameservers, job->options,
+		                    &job->file_error, job->file_rc_manager);
+	}
+	g_mutex_unlock (&rc_job_write_lock);
+}
+
+static void
+_rc_job_complete (RcJob *job, gboolean sync)
+{
+	NMDnsManager *self = job->self;
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+	GError *error;
+	RcJob *next;
+
+	nm_assert (job->n_pending == 0);
+
+	error = job->helper_error ?: (job->file_report ? job->file_error : NULL);
+	if (error && job->update)
+		_LOGW ("could not commit DNS changes: %s", error->message);
+
+	/* signal that resolv.conf was changed */
+	if (job->update && !error)
+		g_signal_emit (self, signals[CONFIG_CHANGED], 0);
+
+	if (!sync) {
+		nm_assert (priv->rc_job == job);
+		priv->rc_job = NULL;
+		next = g_steal_pointer (&priv->rc_job_next);
+		if (next)
+			_rc_job_start (self, next, FALSE);
+	}
+
+	_rc_job_free (job);
+}
+
+static void
+_rc_job_write_thread (GTask *task,
+                      gpointer source_object,
+                      gpointer task_data,
+                      GCancellable *cancellable)
+{
+	_rc_job_write (task_data);
+	g_task_return_boolean (task, TRUE);
+}
+
+static void
+_rc_job_write_cb (GObject *source_object,
+                  GAsyncResult *result,
+                  gpointer user_data)
+{
+	RcJob *job = user_data;
+
+	if (--job->n_pending == 0)
+		_rc_job_complete (job, FALSE);
+}
+
+static void
+_rc_job_child_cb (GPid pid, int status, gpointer user_data)
+{
+	RcJob *job = user_data;
+
+	g_spawn_close_pid (pid);
+	job->pid = 0;
+
+	if (job->pid_timeout_id) {
+		nm_clear_g_source (&job->pid_timeout_id);
+		_child_status_check (_rc_manager_to_string (job->helper_rc_manager), status, &job->helper_error);
+	} else {
+		/* we killed it after the timeout, which already set the error. */
+		nm_assert (job->helper_error);
+	}
+
+	if (--job->n_pending == 0)
+		_rc_job_complete (job, FALSE);
+}
+
+static gboolean
+_rc_job_child_timeout_cb (gpointer user_data)
+{
+	RcJob *job = user_data;
+	NMDnsManager *self = job->self;
+
+	job->pid_timeout_id = 0;
+
+	/* like the synchronous update, don't wait for the helper longer
+	 * than a second. The child watch still reaps it. */
+	_LOGD ("update-dns: %s (%ld) did not exit, killing it",
+	       _rc_manager_to_string (job->helper_rc_manager), (long) job->pid);
+	kill (job->pid, SIGKILL);
+
+	nm_assert (!job->helper_error);
+	g_set_error (&job->helper_error, NM_MANAGER_ERROR, NM_MANAGER_ERROR_FAILED,
+	             "Error waiting for %s to exit",
+	             _rc_manager_to_string (job->helper_rc_manager));
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_rc_job_start (NMDnsManager *self, RcJob *job, gboolean sync)
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+	SpawnResult result = SR_SUCCESS;
+	GTask *task;
+	int status;
+
+	if (!sync) {
+		if (priv->rc_job) {
+			_LOGT ("update-dns: delay update until the previous one completes");
+			if (priv->rc_job_next)
+				_rc_job_free (priv->rc_job_next);
+			priv->rc_job_next = job;
+			return;
+		}
+		priv->rc_job = job;
+	}
+
+	switch (job->helper_rc_manager) {
+	case NM_DNS_MANAGER_RESOLV_CONF_MAN_RESOLVCONF:
+		result = dispatch_resolvconf (self, job->searches, job->nameservers, job->options,
+		                              &job->pid, &job->helper_error);
+		break;
+	case NM_DNS_MANAGER_RESOLV_CONF_MAN_NETCONFIG:
+		result = dispatch_netconfig (self,
+		                             (const char *const*) job->searches,
+		                             (const char *const*) job->nameservers,
+		                             job->nis_domain,
+		                             (const char *const*) job->nis_servers,
+		                             &job->pid,
+		                             &job->helper_error);
+		break;
+	default:
+		break;
+	}
+
+	if (result == SR_NOTFOUND) {
+		_LOGD ("update-dns: program not available, writing to resolv.conf");
+		g_clear_error (&job->helper_error);
+		job->file_rc_manager = NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK;
+		job->file_report = TRUE;
+	}
+
+	if (sync) {
+		if (job->pid > 0) {
+			/* Wait until the process exits */
+			if (!nm_utils_kill_child_sync (job->pid, 0, LOGD_DNS,
+			                               _rc_manager_to_string (job->helper_rc_manager),
+			                               &status, RC_JOB_CHILD_TIMEOUT_MSEC, 0)) {
+				g_set_error (&job->helper_error, NM_MANAGER_ERROR, NM_MANAGER_ERROR_FAILED,
+				             "Error waiting for %s to exit",
+				             _rc_manager_to_string (job->helper_rc_manager));
+			} else
+				_child_status_check (_rc_manager_to_string (job->helper_rc_manager), status, &job->helper_error);
+			job->pid = 0;
+		}
+		_rc_job_write (job);
+		_rc_job_complete (job, TRUE);
+		return;
+	}
+
+	if (job->pid > 0) {
+		job->n_pending++;
+		g_child_watch_add (job->pid, _rc_job_child_cb, job);
+		job->pid_timeout_id = g_timeout_add (RC_JOB_CHILD_TIMEOUT_MSEC, _rc_job_child_timeout_cb, job);
+	}
+
+	job->n_pending++;
+	task = g_task_new (self, NULL, _rc_job_write_cb, job);
+	g_task_set_task_data (task, job, NULL);
+	g_task_run_in_thread (task, _rc_job_write_thread);
+	g_object_unref (task);
+}
+
 static void
 compute_hash (NMDnsManager *self, const NMGlobalDnsConfig *global, guint8 buffer[HASH_LEN])
 {
@@ -1131,10 +1393,12 @@ _collect_resolv_conf_data (NMDnsManager *self,
 	*out_nis_domain = rc.nis_domain;
 }
 
-static gboolean
+/* Collects the configuration and updates the plugin. The result is
+ * written by a RcJob, unless @sync, asynchronously. */
+static void
 update_dns (NMDnsManager *self,
             gboolean no_caching,
-            GError **error)
+            gboolean sync)
 {
 	NMDnsManagerPrivate *priv;
 	const char *nis_domain = NULL;
@@ -1143,18 +1407,17 @@ update_dns (NMDnsManager *self,
 	gs_strfreev char **nameservers = NULL;
 	gs_strfreev char **nis_servers = NULL;
 	gboolean caching = FALSE, update = TRUE;
-	gboolean resolv_conf_updated = FALSE;
-	SpawnResult result = SR_ERROR;
 	NMConfigData *data;
 	NMGlobalDnsConfig *global_config;
-
-	g_return_val_if_fail (!error || !*error, FALSE);
+	RcJob *job;
 
 	priv = NM_DNS_MANAGER_GET_PRIVATE (self);
 
+	nm_clear_g_source (&priv->update_idle_id);
+
 	if (priv->is_stopped) {
 		_LOGD ("update-dns: not updating resolv.conf (is stopped)");
-		return TRUE;
+		return;
 	}
 
 	nm_clear_g_source (&priv->plugin_ratelimit.timer);
@@ -1226,83 +1489,98 @@ update_dns (NMDnsManager *self,
 		nameservers[0] = g_strdup (lladdr);
 	}
 
+	job = g_slice_new0 (RcJob);
+	job->self = g_object_ref (self);
+	job->serial = ++rc_job_serial_counter;
+	job->update = update;
+
+	/* Unless we write resolv.conf, update private resolv.conf in NMRUNDIR
+	 * ignoring any errors */
+	job->file_rc_manager = NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED;
+	job->helper_rc_manager = NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED;
+
 	if (update) {
 		switch (priv->rc_manager) {
 		case NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK:
 		case NM_DNS_MANAGER_RESOLV_CONF_MAN_FILE:
-			result = update_resolv_conf (self, searches, nameservers, options, error, priv->rc_manager);
-			resolv_conf_updated = TRUE;
+			job->file_rc_manager = priv->rc_manager;
+			job->file_report = TRUE;
 			/* If we have ended with no nameservers avoid updating again resolv.conf
 			 * on stop, as some external changes may be applied to it in the meanwhile */
 			if (!nameservers && !options)
 				priv->dns_touched = FALSE;
 			break;
 		case NM_DNS_MANAGER_RESOLV_CONF_MAN_RESOLVCONF:
-			result = dispatch_resolvconf (self, searches, nameservers, options, error);
-			break;
 		case NM_DNS_MANAGER_RESOLV_CONF_MAN_NETCONFIG:
-			result = dispatch_netconfig (self,
-			                             (const char *const*) searches,
-			                             (const char *const*) nameservers,
-			                             nis_domain,
-			                             (const char *const*) nis_servers,
-			                             error);
+			job->helper_rc_manager = priv->rc_manager;
 			break;
 		default:
 			g_assert_not_reached ();
 		}
-
-		if (result == SR_NOTFOUND) {
-			_LOGD ("update-dns: program not available, writing to resolv.conf");
-			g_clear_error (error);
-			result = update_resolv_conf (self, searches, nameservers, options, error, NM_DNS_MANAGER_RESOLV_CONF_MAN_SYMLINK);
-			resolv_conf_updated = TRUE;
-		}
 	}
 
-	/* Unless we've already done it, update private resolv.conf in NMRUNDIR
-	   ignoring any errors */
-	if (!resolv_conf_updated)
-		update_resolv_conf (self, searches, nameservers, options, NULL, NM_DNS_MANAGER_RESOLV_CONF_MAN_UNMANAGED);
+	job->searches = g_steal_pointer (&searches);
+	job->nameservers = g_steal_pointer (&nameservers);
+	job->options = g_steal_pointer (&options);
+	job->nis_servers = g_steal_pointer (&nis_servers);
+	job->nis_domain = g_strdup (nis_domain);
 
-	/* signal that resolv.conf was changed */
-	if (update && result == SR_SUCCESS)
-		g_signal_emit (self, signals[CONFIG_CHANGED], 0);
+	if (sync && priv->rc_job_next) {
+		/* the synchronous update supersedes the pending one. */
+		g_clear_pointer (&priv->rc_job_next, _rc_job_free);
+	}
+
+	_rc_job_start (self, job, sync);
 
 	g_clear_pointer (&priv->config_variant, g_variant_unref);
 	_notify (self, PROP_CONFIGURATION);
+}
+
+static gboolean
+_update_dns_idle_cb (gpointer user_data)
+{
+	NMDnsManager *self = user_data;
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+
+	priv->update_idle_id = 0;
 
-	return !update || result == SR_SUCCESS;
+	/* nm_dns_manager_end_updates() commits the changes. */
+	if (priv->updates_queue == 0)
+		update_dns (self, FALSE, FALSE);
+	return G_SOURCE_REMOVE;
+}
+
+/* Changes often come in bursts, for example when several devices
+ * activate. Update the DNS configuration once, from an idle handler. */
+static void
+_update_dns_schedule (NMDnsManager *self)
+{
+	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
+
+	if (!priv->update_idle_id)
+		priv->update_idle_id = g_idle_add (_update_dns_idle_cb, self);
 }
 
 static void
 plugin_failed (NMDnsPlugin *plugin, gpointer user_data)
 {
 	NMDnsManager *self = NM_DNS_MANAGER (user_data);
-	GError *error = NULL;
 
 	/* Errors with non-caching plugins aren't fatal */
 	if (!nm_dns_plugin_is_caching (plugin))
 		return;
 
 	/* Disable caching until the next DNS update */
-	if (!update_dns (self, TRUE, &error)) {
-		_LOGW ("could not commit DNS changes: %s", error->message);
-		g_clear_error (&error);
-	}
+	update_dns (self, TRUE, FALSE);
 }
 
 static gboolean
 plugin_child_quit_update_dns (gpointer user_data)
 {
-	GError *error = NULL;
 	NMDnsManager *self = NM_DNS_MANAGER (user_data);
 
 	/* Let the plugin try to spawn the child again */
-	if (!update_dns (self, FALSE, &error)) {
-		_LOGW ("could not commit DNS changes: %s", error->message);
-		g_clear_error (&error);
-	}
+	update_dns (self, FALSE, FALSE);
 
 	return G_SOURCE_REMOVE;
 }
@@ -1351,7 +1629,6 @@ nm_dns_manager_set_ip_config (NMDnsManager *self,
                               NMDnsIPConfigType ip_config_type)
 {
 	NMDnsManagerPrivate *priv;
-	GError *error = NULL;
 	NMDnsIPConfigData *ip_data;
 	NMDnsConfigData *data;
 	int ifindex;
@@ -1424,11 +1701,8 @@ nm_dns_manager_set_ip_config (NMDnsManager *self,
 	}
 
 changed:
-	if (   !priv->updates_queue
-	    && !update_dns (self, FALSE, &error)) {
-		_LOGW ("could not commit DNS changes: %s", error->message);
-		g_clear_error (&error);
-	}
+	if (!priv->updates_queue)
+		_update_dns_schedule (self);
 
 	return TRUE;
 }
@@ -1449,7 +1723,6 @@ nm_dns_manager_set_hostname (NMDnsManager *self,
                              gboolean skip_update)
 {
 	NMDnsManagerPrivate *priv = NM_DNS_MANAGER_GET_PRIVATE (self);
-	GError *error = NULL;
 	const char *filtered = NULL;
 
 	/* Certain hostnames we don't want to include in resolv.conf 'searches' */
@@ -1469,10 +1742,8 @@ nm_dns_manager_set_hostname (NMDnsManager *self,
 
 	if (skip_update)
 		return;
-	if (!priv->updates_queue && !update_dns (self, FALSE, &error)) {
-		_LOGW ("could not commit DNS changes: %s", error->message);
-		g_clear_error (&error);
-	}
+	if (!priv->updates_queue)
+		_update_dns_schedule (self);
 }
 
 gboolean
@@ -1513,7 +1784,6 @@ void
 nm_dns_manager_end_updates (NMDnsManager *self, const char *func)
 {
 	NMDnsManagerPrivate *priv;
-	GError *error = NULL;
 	gboolean changed;
 	guint8 new[HASH_LEN];
 
@@ -1534,10 +1804,7 @@ nm_dns_manager_end_updates (NMDnsManager *self, const char *func)
 
 	/* Commit all the outstanding changes */
 	_LOGD ("(%s): committing DNS changes (%d)", func, priv->updates_queue);
-	if (!update_dns (self, FALSE, &error)) {
-		_LOGW ("could not commit DNS changes: %s", error->message);
-		g_clear_error (&error);
-	}
+	_update_dns_schedule (self);
 
 	memset (priv->prev_hash, 0, sizeof (priv->prev_hash));
 }
@@ -1546,7 +1813,6 @@ void
 nm_dns_manager_stop (NMDnsManager *self)
 {
 	NMDnsManagerPrivate *priv;
-	GError *error = NULL;
 
 	priv = NM_DNS_MANAGER_GET_PRIVATE (self);
 
@@ -1563,13 +1829,13 @@ nm_dns_manager_stop (NMDnsManager *self)
 	if (   priv->dns_touched
 	    && priv->plugin
 	    && NM_IS_DNS_DNSMASQ (priv->plugin)) {
-		if (!update_dns (self, TRUE, &error)) {
-			_LOGW ("could not commit DNS changes on shutdown: %s", error->message);
-			g_clear_error (&error);
-		}
+		update_dns (self, TRUE, TRUE);
 		priv->dns_touched = FALSE;
 	}
 
+	nm_clear_g_source (&priv->update_idle_id);
+	g_clear_pointer (&priv->rc_job_next, _rc_job_free);
+
 	priv->is_stopped = TRUE;
 }
 
@@ -1829,7 +2095,6 @@ config_changed_cb (NMConfig *config,
                    NMConfigData *old_data,
                    NMDnsManager *self)
 {
-	GError *error = NULL;
 
 	if (NM_FLAGS_ANY (changes, NM_CONFIG_CHANGE_DNS_MODE |
 	                           NM_CONFIG_CHANGE_RC_MANAGER |
@@ -1850,12 +2115,8 @@ config_changed_cb (NMConfig *config,
 	                           NM_CONFIG_CHANGE_CAUSE_DNS_FULL |
 	                           NM_CONFIG_CHANGE_DNS_MODE |
 	                           NM_CONFIG_CHANGE_RC_MANAGER |
-	                           NM_CONFIG_CHANGE_GLOBAL_DNS_CONFIG)) {
-		if (!update_dns (self, FALSE, &error)) {
-			_LOGW ("could not commit DNS changes: %s", error->message);
-			g_clear_error (&error);
-		}
-	}
+	                           NM_CONFIG_CHANGE_GLOBAL_DNS_CONFIG))
+		_update_dns_schedule (self);
 }
 
 static GVariant *
@@ -2087,6 +2348,8 @@ dispose (GObject *object)
 	g_clear_pointer (&priv->configs, g_hash_table_destroy);
 
 	nm_clear_g_source (&priv->plugin_ratelimit.timer);
+	nm_clear_g_source (&priv->update_idle_id);
+	g_clear_pointer (&priv->rc_job_next, _rc_job_free);
 
 	g_clear_object (&priv->config);
 
@@ -127,4 +127,8 @@ gboolean nm_dns_manager_get_resolv_conf_explicit (NMDnsManager *self);
 
 void nm_dns_manager_stop (NMDnsManager *self);
 
+/* the strings must stay valid while the manager is used. */
+void _nm_dns_manager_set_paths_for_testing (const char *resolvconf_path,
+                                            const char *my_resolv_conf);
+
 #endif /* __NETWORKMANAGER_DNS_MANAGER_H__ */
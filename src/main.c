@@ -150,6 +150,9 @@ nm_main_config_reload (int signal)
 
 	nm_log_info (LOGD_CORE, "reload configuration (signal %s)...", strsignal (signal));
 
+	if (signal == SIGUSR2)
+		nm_logging_ring_flush ();
+
 	/* The signal handler thread is only installed after
 	 * creating NMConfig instance, and on shut down we
 	 * no longer run the mainloop (to reach this point).
@@ -231,6 +234,7 @@ main (int argc, char *argv[])
 	char *bad_domains = NULL;
 	NMConfigCmdLineOptions *config_cli;
 	guint sd_id = 0;
+	gint64 netlink_rcvbuf;
 
 	/* Known to cause a possible deadlock upon GDBus initialization:
 	 * https://bugzilla.gnome.org/show_bug.cgi?id=674885 */
@@ -367,6 +371,11 @@ main (int argc, char *argv[])
 		nm_logging_syslog_openlog (v, nm_config_get_is_debug (config));
 	}
 
+	nm_logging_ring_setup (nm_config_data_get_value_int64 (NM_CONFIG_GET_DATA_ORIG,
+	                                                       NM_CONFIG_KEYFILE_GROUP_LOGGING,
+	                                                       NM_CONFIG_KEYFILE_KEY_LOGGING_RING_SIZE,
+	                                                       10, 0, NM_LOGGING_RING_SIZE_MAX, 0));
+
 	nm_log_info (LOGD_CORE, "NetworkManager (version " NM_DIST_VERSION ") is starting... (%s)",
 	             nm_config_get_first_start (config) ? "for the first time" : "after a restart");
 
@@ -387,6 +396,24 @@ main (int argc, char *argv[])
 	/* Set up platform interaction layer */
 	nm_linux_platform_setup ();
 
+	netlink_rcvbuf = nm_config_data_get_value_int64 (nm_config_get_data_orig (config),
+	                                                 NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                                 NM_CONFIG_KEYFILE_KEY_MAIN_NETLINK_RCVBUF,
+	                                                 10, 0, G_MAXINT, 0);
+	if (netlink_rcvbuf > 0)
+		nm_platform_netlink_set_rcvbuf (NM_PLATFORM_GET, netlink_rcvbuf);
+
+	nm_exported_object_set_property_class_interval (NM_EXPORTED_OBJECT_PROPERTY_CLASS_STATISTICS,
+	                                                nm_config_data_get_value_int64 (nm_config_get_data_orig (config),
+	                                                                                NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                                                                NM_CONFIG_KEYFILE_KEY_MAIN_DBUS_RATE_LIMIT_STATISTICS,
+	                                                                                10, 0, G_MAXINT, 0));
+	nm_exported_object_set_property_class_interval (NM_EXPORTED_OBJECT_PROPERTY_CLASS_SIGNAL,
+	                                                nm_config_data_get_value_int64 (nm_config_get_data_orig (config),
+	                                                                                NM_CONFIG_KEYFILE_GROUP_MAIN,
+	                                                                                NM_CONFIG_KEYFILE_KEY_MAIN_DBUS_RATE_LIMIT_SIGNAL,
+	                                                                                10, 0, G_MAXINT, 1000));
+
 	NM_UTILS_KEEP_ALIVE (config, nm_netns_get (), "NMConfig-depends-on-NMNetns");
 
 	nm_auth_manager_setup (nm_config_data_get_value_boolean (nm_config_get_data_orig (config),
@@ -30,6 +30,13 @@
 #define POLKIT_OBJECT_PATH                  "/org/freedesktop/PolicyKit1/Authority"
 #define POLKIT_INTERFACE                    "org.freedesktop.PolicyKit1.Authority"
 
+/* How long a CheckAuthorization result is reused for the same subject
+ * and action. polkit emits "Changed" when its configuration changes,
+ * but not when the subject's session becomes active or inactive, so
+ * don't keep results for long. */
+#define AUTH_CACHE_TIMEOUT_MSEC             5000
+#define AUTH_CACHE_MAX_ENTRIES              512
+
 /*****************************************************************************/
 
 NM_GOBJECT_PROPERTIES_DEFINE_BASE (
@@ -50,6 +57,8 @@ typedef struct {
 	GCancellable *new_proxy_cancellable;
 	GSList *queued_calls;
 	GDBusProxy *proxy;
+	GHashTable *auth_cache;
+	guint auth_cache_generation;
 #endif
 } NMAuthManagerPrivate;
 
@@ -111,8 +120,20 @@ typedef struct {
 	gchar *cancellation_id;
 	GVariant *dbus_parameters;
 	GCancellable *cancellable;
+	char *cache_key;
+	guint cache_generation;
 } CheckAuthData;
 
+typedef struct {
+	gboolean is_authorized;
+	gboolean is_challenge;
+} CheckAuthorizationResult;
+
+typedef struct {
+	CheckAuthorizationResult result;
+	gint64 expiry_msec;
+} AuthCacheEntry;
+
 static void
 _check_auth_data_free (CheckAuthData *data)
 {
@@ -122,9 +143,119 @@ _check_auth_data_free (CheckAuthData *data)
 	g_object_unref (data->simple);
 	g_clear_object (&data->cancellable);
 	g_free (data->cancellation_id);
+	g_free (data->cache_key);
 	g_free (data);
 }
 
+/*****************************************************************************/
+
+static char *
+_auth_cache_key (NMAuthSubject *subject,
+                 const char *action_id,
+                 PolkitCheckAuthorizationFlags flags)
+{
+	nm_assert (nm_auth_subject_is_unix_process (subject));
+
+	/* the start time of the process is part of the key, so a recycled
+	 * pid does not hit the cache. */
+	return g_strdup_printf ("%lu|%lu|%" G_GUINT64_FORMAT "|%x|%s",
+	                        nm_auth_subject_get_unix_process_pid (subject),
+	                        nm_auth_subject_get_unix_process_uid (subject),
+	                        nm_auth_subject_get_unix_process_start_time (subject),
+	                        (guint) flags,
+	                        action_id);
+}
+
+static const CheckAuthorizationResult *
+_auth_cache_lookup (NMAuthManager *self, const char *key)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	AuthCacheEntry *entry;
+
+	if (!priv->auth_cache)
+		return NULL;
+
+	entry = g_hash_table_lookup (priv->auth_cache, key);
+	if (!entry)
+		return NULL;
+	if (entry->expiry_msec <= nm_utils_get_monotonic_timestamp_ms ()) {
+		g_hash_table_remove (priv->auth_cache, key);
+		return NULL;
+	}
+	return &entry->result;
+}
+
+static void
+_auth_cache_prune (NMAuthManager *self)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	GHashTableIter iter;
+	AuthCacheEntry *entry;
+	gint64 now;
+
+	now = nm_utils_get_monotonic_timestamp_ms ();
+	g_hash_table_iter_init (&iter, priv->auth_cache);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &entry)) {
+		if (entry->expiry_msec <= now)
+			g_hash_table_iter_remove (&iter);
+	}
+
+	/* many short-lived clients. Just start over. */
+	if (g_hash_table_size (priv->auth_cache) >= AUTH_CACHE_MAX_ENTRIES)
+		g_hash_table_remove_all (priv->auth_cache);
+}
+
+static void
+_auth_cache_add (NMAuthManager *self,
+                 CheckAuthData *data,
+                 const CheckAuthorizationResult *result,
+                 GVariant *details)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+	AuthCacheEntry *entry;
+
+	if (!priv->auth_cache)
+		return;
+
+	/* polkit changed in the meantime, the result might be outdated. */
+	if (data->cache_generation != priv->auth_cache_generation)
+		return;
+
+	/* a challenge can be answered by the user at any time, and a
+	 * temporary authorization expires without notice. Both must be
+	 * asked again. */
+	if (result->is_challenge)
+		return;
+	if (g_variant_lookup (details, "polkit.temporary_authorization_id", "&s", NULL))
+		return;
+
+	if (g_hash_table_size (priv->auth_cache) >= AUTH_CACHE_MAX_ENTRIES)
+		_auth_cache_prune (self);
+
+	entry = g_slice_new (AuthCacheEntry);
+	entry->result = *result;
+	entry->expiry_msec = nm_utils_get_monotonic_timestamp_ms () + AUTH_CACHE_TIMEOUT_MSEC;
+	g_hash_table_insert (priv->auth_cache, g_strdup (data->cache_key), entry);
+}
+
+static void
+_auth_cache_entry_free (gpointer data)
+{
+	g_slice_free (AuthCacheEntry, data);
+}
+
+static void
+_auth_cache_invalidate (NMAuthManager *self)
+{
+	NMAuthManagerPrivate *priv = NM_AUTH_MANAGER_GET_PRIVATE (self);
+
+	priv->auth_cache_generation++;
+	if (priv->auth_cache)
+		g_hash_table_remove_all (priv->auth_cache);
+}
+
+/*****************************************************************************/
+
 static void
 _call_check_authorization_complete_with_error (CheckAuthData *data,
                                                const char *error_message)
@@ -163,11 +294,6 @@ cancel_check_authorization_cb (GDBusProxy *proxy,
 	g_object_unref (self);
 }
 
-typedef struct {
-	gboolean is_authorized;
-	gboolean is_challenge;
-} CheckAuthorizationResult;
-
 static void
 check_authorization_cb (GDBusProxy *proxy,
                         GAsyncResult *res,
@@ -204,6 +330,7 @@ check_authorization_cb (GDBusProxy *proxy,
 		g_error_free (error);
 	} else {
 		CheckAuthorizationResult *result;
+		gs_unref_variant GVariant *details = NULL;
 
 		result = g_new0 (CheckAuthorizationResult, 1);
 
@@ -211,10 +338,11 @@ check_authorization_cb (GDBusProxy *proxy,
 		               "((bb@a{ss}))",
 		               &result->is_authorized,
 		               &result->is_challenge,
-		               NULL);
+		               &details);
 		g_variant_unref (value);
 
 		_LOGD ("call[%u]: CheckAuthorization succeeded: (is_authorized=%d, is_challenge=%d)", data->call_id, result->is_authorized, result->is_challenge);
+		_auth_cache_add (self, data, result, details);
 		g_simple_async_result_set_op_res_gpointer (data->simple, result, g_free);
 	}
 
@@ -256,6 +384,7 @@ nm_auth_manager_polkit_authority_check_authorization (NMAuthManager *self,
 	GVariant *subject_value;
 	GVariant *details_value;
 	CheckAuthData *data;
+	const CheckAuthorizationResult *cached;
 
 	g_return_if_fail (NM_IS_AUTH_MANAGER (self));
 	g_return_if_fail (NM_IS_AUTH_SUBJECT (subject));
@@ -271,13 +400,6 @@ nm_auth_manager_polkit_authority_check_authorization (NMAuthManager *self,
 	    ? POLKIT_CHECK_AUTHORIZATION_FLAGS_ALLOW_USER_INTERACTION
 	    : POLKIT_CHECK_AUTHORIZATION_FLAGS_NONE;
 
-	subject_value = nm_auth_subject_unix_process_to_polkit_gvariant (subject);
-	nm_assert (g_variant_is_floating (subject_value));
-
-	/* ((PolkitDetails *)NULL) */
-	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{ss}"));
-	details_value = g_variant_builder_end (&builder);
-
 	data = g_new0 (CheckAuthData, 1);
 	data->call_id = ++priv->call_id_counter;
 	data->self = g_object_ref (self);
@@ -285,6 +407,30 @@ nm_auth_manager_polkit_authority_check_authorization (NMAuthManager *self,
 	                                          callback,
 	                                          user_data,
 	                                          nm_auth_manager_polkit_authority_check_authorization);
+	data->cache_key = _auth_cache_key (subject, action_id, flags);
+	data->cache_generation = priv->auth_cache_generation;
+
+	cached = _auth_cache_lookup (self, data->cache_key);
+	if (cached) {
+		_LOGD ("call[%u]: CheckAuthorization(%s), subject=%s (cached: is_authorized=%d, is_challenge=%d)",
+		       data->call_id, action_id,
+		       nm_auth_subject_to_string (subject, subject_buf, sizeof (subject_buf)),
+		       cached->is_authorized, cached->is_challenge);
+		g_simple_async_result_set_op_res_gpointer (data->simple,
+		                                           g_memdup (cached, sizeof (*cached)),
+		                                           g_free);
+		g_simple_async_result_complete_in_idle (data->simple);
+		_check_auth_data_free (data);
+		return;
+	}
+
+	subject_value = nm_auth_subject_unix_process_to_polkit_gvariant (subject);
+	nm_assert (g_variant_is_floating (subject_value));
+
+	/* ((PolkitDetails *)NULL) */
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{ss}"));
+	details_value = g_variant_builder_end (&builder);
+
 	if (cancellable != NULL) {
 		data->cancellation_id = g_strdup_printf ("cancellation-id-%u", data->call_id);
 		data->cancellable = g_object_ref (cancellable);
@@ -387,6 +533,7 @@ _dbus_on_name_owner_notify_cb (GObject    *object,
 	if (!name_owner) {
 		/* when the name disappears, we also want to raise a emit signal.
 		 * When it appears, we raise one already. */
+		_auth_cache_invalidate (self);
 		_emit_changed_signal (self);
 	}
 
@@ -403,6 +550,7 @@ _dbus_on_changed_signal_cb (GDBusProxy *proxy,
 	g_return_if_fail (priv->proxy == proxy);
 
 	_LOGD ("dbus signal: \"Changed\"");
+	_auth_cache_invalidate (self);
 	_emit_changed_signal (self);
 }
 
@@ -539,6 +687,9 @@ constructed (GObject *object)
 	if (priv->polkit_enabled) {
 		NMAuthManager **p_self;
 
+		priv->auth_cache = g_hash_table_new_full (nm_str_hash, g_str_equal,
+		                                          g_free, _auth_cache_entry_free);
+
 		priv->new_proxy_cancellable = g_cancellable_new ();
 		p_self = g_new (NMAuthManager *, 1);
 		*p_self = self;
@@ -601,6 +752,8 @@ dispose (GObject *object)
 		g_signal_handlers_disconnect_by_data (priv->proxy, self);
 		g_clear_object (&priv->proxy);
 	}
+
+	g_clear_pointer (&priv->auth_cache, g_hash_table_unref);
 #endif
 
 	G_OBJECT_CLASS (nm_auth_manager_parent_class)->dispose (object);
@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include "nm-bus-manager.h"
+#include "nm-core-utils.h"
 
 #include "devices/nm-device.h"
 #include "nm-active-connection.h"
@@ -52,13 +53,21 @@ typedef struct {
 } InterfaceData;
 
 typedef struct _NMExportedObjectPrivate {
+	NMExportedObject *self;
 	NMBusManager *bus_mgr;
 	char *path;
 
 	InterfaceData *interfaces;
 	guint num_interfaces;
 
-	guint notify_idle_id;
+	/* linked in _pending.lst_head while notifications are pending. */
+	CList pending_lst;
+
+	/* when the pending notifications are due, 0 means immediately. */
+	gint64 pending_due_msec;
+
+	/* the last time properties of a rate-limited class were emitted. */
+	gint64 last_emit_msec[_NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM];
 
 #ifdef _ASSERT_NO_EARLY_EXPORT
 	bool _constructed:1;
@@ -73,12 +82,35 @@ G_DEFINE_ABSTRACT_TYPE (NMExportedObject, nm_exported_object, G_TYPE_DBUS_OBJECT
 
 typedef struct {
 	GHashTable *properties;
+	GHashTable *property_classes;
 	GSList *skeleton_types;
 	GArray *methods;
 } NMExportedObjectClassInfo;
 
 static NM_CACHED_QUARK_FCN ("NMExportedObjectClassInfo", nm_exported_object_class_info_quark)
 
+/* All objects with pending property notifications. They are emitted together
+ * from one source, instead of one idle source per object. */
+static struct {
+	CList lst_head;
+	guint source_id;
+
+	/* when @source_id fires. 0 for an idle source. */
+	gint64 source_due_msec;
+
+	/* the minimum interval between emissions of a property class. */
+	guint interval_msec[_NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM];
+} _pending = {
+	.lst_head = C_LIST_INIT (_pending.lst_head),
+	.interval_msec = {
+		[NM_EXPORTED_OBJECT_PROPERTY_CLASS_SIGNAL] = 1000,
+	},
+};
+
+static void _pending_notify_free (gpointer data);
+static void _pending_clear (NMExportedObject *self);
+static void _skeleton_class_hook (GType dbus_skeleton_type);
+
 /*****************************************************************************/
 
 #define _NMLOG_DOMAIN      LOGD_CORE
@@ -273,6 +305,7 @@ nm_exported_object_class_add_interface (NMExportedObjectClass *object_class,
 		classinfo->skeleton_types = NULL;
 		classinfo->methods = g_array_new (FALSE, FALSE, sizeof (NMExportedObjectDBusMethodImpl));
 		classinfo->properties = g_hash_table_new (nm_str_hash, g_str_equal);
+		classinfo->property_classes = NULL;
 		g_type_set_qdata (G_TYPE_FROM_CLASS (object_class),
 		                  nm_exported_object_class_info_quark (), classinfo);
 	}
@@ -280,6 +313,8 @@ nm_exported_object_class_add_interface (NMExportedObjectClass *object_class,
 	classinfo->skeleton_types = g_slist_prepend (classinfo->skeleton_types,
 	                                             GSIZE_TO_POINTER (dbus_skeleton_type));
 
+	_skeleton_class_hook (dbus_skeleton_type);
+
 	/* Ensure @dbus_skeleton_type's class_init has run, so its signals/properties
 	 * will be defined.
 	 */
@@ -358,6 +393,81 @@ nm_exported_object_class_add_interface (NMExportedObjectClass *object_class,
 	g_type_class_unref (dbus_object_class);
 }
 
+/**
+ * nm_exported_object_class_set_property_class:
+ * @object_class: an #NMExportedObjectClass
+ * @property_name: the name of a property of an interface added with
+ *   nm_exported_object_class_add_interface()
+ * @property_class: the class of the property
+ *
+ * Changes of properties of a class other than the default are emitted on
+ * D-Bus at most once per interval, see nm_exported_object_set_property_class_interval().
+ * The value of a property of %NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED is
+ * only read when its change gets emitted, or when the property is read on D-Bus.
+ * Must be called from class_init(), after nm_exported_object_class_add_interface().
+ */
+void
+nm_exported_object_class_set_property_class (NMExportedObjectClass *object_class,
+                                             const char *property_name,
+                                             NMExportedObjectPropertyClass property_class)
+{
+	NMExportedObjectClassInfo *classinfo;
+	GParamSpec *pspec;
+
+	g_return_if_fail (NM_IS_EXPORTED_OBJECT_CLASS (object_class));
+	g_return_if_fail (property_class > NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT);
+	g_return_if_fail (property_class < _NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM);
+
+	classinfo = g_type_get_qdata (G_TYPE_FROM_CLASS (object_class),
+	                              nm_exported_object_class_info_quark ());
+	g_return_if_fail (classinfo);
+	g_return_if_fail (g_hash_table_contains (classinfo->properties, property_name));
+
+	/* the skeleton's property gets updated when the change is emitted.
+	 * Hence, it cannot be written via D-Bus. */
+	pspec = g_object_class_find_property (G_OBJECT_CLASS (object_class), property_name);
+	g_return_if_fail (pspec && !(pspec->flags & G_PARAM_WRITABLE));
+
+	if (!classinfo->property_classes)
+		classinfo->property_classes = g_hash_table_new (nm_str_hash, g_str_equal);
+	g_hash_table_insert (classinfo->property_classes,
+	                     (gpointer) pspec->name,
+	                     GUINT_TO_POINTER (property_class));
+}
+
+static NMExportedObjectPropertyClass
+_property_class_lookup (GType type, const char *property_name)
+{
+	NMExportedObjectClassInfo *classinfo;
+	gpointer property_class;
+
+	for (; type; type = g_type_parent (type)) {
+		classinfo = g_type_get_qdata (type, nm_exported_object_class_info_quark ());
+		if (   classinfo
+		    && classinfo->property_classes
+		    && g_hash_table_lookup_extended (classinfo->property_classes, property_name, NULL, &property_class))
+			return GPOINTER_TO_UINT (property_class);
+	}
+	return NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT;
+}
+
+/**
+ * nm_exported_object_set_property_class_interval:
+ * @property_class: the property class
+ * @interval_msec: the minimum interval in milliseconds between two
+ *   emissions of changes of properties of this class on the same object.
+ *   Zero disables rate-limiting.
+ */
+void
+nm_exported_object_set_property_class_interval (NMExportedObjectPropertyClass property_class,
+                                                guint interval_msec)
+{
+	g_return_if_fail (property_class > NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT);
+	g_return_if_fail (property_class < _NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM);
+
+	_pending.interval_msec[property_class] = interval_msec;
+}
+
 /*****************************************************************************/
 
 /* "meta-marshaller" that receives the skeleton "handle-foo" signal, replaces
@@ -423,6 +533,19 @@ nm_exported_object_skeleton_create (GType dbus_skeleton_type,
 		if (!nm_property)
 			continue;
 
+		if (_property_class_lookup (G_OBJECT_TYPE (target), nm_property->name) != NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT) {
+			GValue value = G_VALUE_INIT;
+
+			/* rate-limited properties are not bound. Instead, the skeleton
+			 * is updated when the change gets emitted, or before the
+			 * property is read on D-Bus. */
+			g_value_init (&value, nm_property->value_type);
+			g_object_get_property (target, nm_property->name, &value);
+			g_object_set_property ((GObject *) interface, properties[i]->name, &value);
+			g_value_unset (&value);
+			continue;
+		}
+
 		flags = G_BINDING_SYNC_CREATE;
 		if (   (nm_property->flags & G_PARAM_WRITABLE)
 			&& !(nm_property->flags & G_PARAM_CONSTRUCT_ONLY))
@@ -504,7 +627,7 @@ nm_exported_object_create_skeletons (NMExportedObject *self,
 		ifdata->pending_notifies = g_hash_table_new_full (nm_direct_hash,
 		                                                  NULL,
 		                                                  NULL,
-		                                                  (GDestroyNotify) g_variant_unref);
+		                                                  _pending_notify_free);
 	}
 	nm_assert (i == 0);
 
@@ -722,7 +845,7 @@ nm_exported_object_unexport (NMExportedObject *self)
 
 	g_clear_pointer (&priv->path, g_free);
 
-	nm_clear_g_source (&priv->notify_idle_id);
+	_pending_clear (self);
 
 	_notify (self, PROP_PATH);
 }
@@ -788,8 +911,33 @@ nm_exported_object_class_set_quitting (void)
 /*****************************************************************************/
 
 typedef struct {
-	const char *property_name;
+	/* the value for the deprecated PropertiesChanged signal, or %NULL. */
 	GVariant *variant;
+
+	/* for rate-limited properties, the name of the property to copy to
+	 * the skeleton when emitting. Otherwise %NULL. */
+	const char *skeleton_property_name;
+
+	/* for deferred properties that have a deprecated PropertiesChanged
+	 * signal, the type of @variant, which is only set when emitting. */
+	const GVariantType *deferred_vtype;
+
+	NMExportedObjectPropertyClass property_class;
+} PendingNotify;
+
+static void
+_pending_notify_free (gpointer data)
+{
+	PendingNotify *pn = data;
+
+	if (pn->variant)
+		g_variant_unref (pn->variant);
+	g_slice_free (PendingNotify, pn);
+}
+
+typedef struct {
+	const char *property_name;
+	PendingNotify *pn;
 } PendingNotifiesItem;
 
 static int
@@ -799,13 +947,53 @@ _sort_pending_notifies (gconstpointer a, gconstpointer b, gpointer       user_da
 	               ((const PendingNotifiesItem *) b)->property_name);
 }
 
-static gboolean
-idle_emit_properties_changed (gpointer self)
+static gboolean _pending_dispatch (gpointer user_data);
+
+static void
+_pending_reschedule (gint64 due_msec, gint64 now_msec)
 {
-	NMExportedObjectPrivate *priv = NM_EXPORTED_OBJECT_GET_PRIVATE (NM_EXPORTED_OBJECT (self));
-	guint k;
+	if (   _pending.source_id
+	    && _pending.source_due_msec <= due_msec)
+		return;
+
+	nm_clear_g_source (&_pending.source_id);
+	if (due_msec <= now_msec) {
+		_pending.source_due_msec = 0;
+		_pending.source_id = g_idle_add (_pending_dispatch, NULL);
+	} else {
+		_pending.source_due_msec = due_msec;
+		_pending.source_id = g_timeout_add (due_msec - now_msec, _pending_dispatch, NULL);
+	}
+}
+
+static void
+_pending_schedule (NMExportedObject *self, gint64 due_msec)
+{
+	NMExportedObjectPrivate *priv = NM_EXPORTED_OBJECT_GET_PRIVATE (self);
+	gint64 now_msec;
+
+	if (c_list_is_empty (&priv->pending_lst)) {
+		c_list_link_tail (&_pending.lst_head, &priv->pending_lst);
+		priv->pending_due_msec = due_msec;
+	} else if (priv->pending_due_msec > due_msec)
+		priv->pending_due_msec = due_msec;
+	else
+		return;
+
+	now_msec = due_msec ? nm_utils_get_monotonic_timestamp_ms () : 0;
+	_pending_reschedule (due_msec, now_msec);
+}
 
-	priv->notify_idle_id = 0;
+/* Emit the pending notifications of @self that are due at @now_msec.
+ * Returns the time when the remaining (rate-limited) notifications
+ * become due, or 0 if none remain. */
+static gint64
+_emit_properties_changed (NMExportedObject *self, gint64 now_msec)
+{
+	NMExportedObjectPrivate *priv = NM_EXPORTED_OBJECT_GET_PRIVATE (self);
+	gboolean class_emitted[_NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM] = { FALSE, };
+	gint64 next_due_msec = 0;
+	guint k;
 
 	for (k = 0; k < priv->num_interfaces; k++) {
 		InterfaceData *ifdata = &priv->interfaces[k];
@@ -813,14 +1001,12 @@ idle_emit_properties_changed (gpointer self)
 		PendingNotifiesItem *values;
 		GVariantBuilder notifies;
 		GHashTableIter hash_iter;
-		guint i, n;
+		guint i, n, n_variants;
 
 		n = g_hash_table_size (ifdata->pending_notifies);
 		if (n == 0)
 			continue;
 
-		nm_assert (ifdata->property_changed_signal_id);
-
 		/* We use here alloca in a loop, something that is usually avoided.
 		 * But the number of interfaces "priv->num_interfaces" is small (determined by
 		 * the depth of the type inheritance) and the number of possible pending_notifies
@@ -829,17 +1015,64 @@ idle_emit_properties_changed (gpointer self)
 
 		i = 0;
 		g_hash_table_iter_init (&hash_iter, ifdata->pending_notifies);
-		while (g_hash_table_iter_next (&hash_iter, (gpointer) &values[i].property_name, (gpointer) &values[i].variant))
+		while (g_hash_table_iter_next (&hash_iter, (gpointer) &values[i].property_name, (gpointer) &values[i].pn)) {
+			NMExportedObjectPropertyClass property_class = values[i].pn->property_class;
+
+			if (property_class != NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT) {
+				gint64 due_msec;
+
+				due_msec = priv->last_emit_msec[property_class] + _pending.interval_msec[property_class];
+				if (   priv->last_emit_msec[property_class]
+				    && due_msec > now_msec) {
+					/* too early. Keep it pending. */
+					if (!next_due_msec || due_msec < next_due_msec)
+						next_due_msec = due_msec;
+					continue;
+				}
+				class_emitted[property_class] = TRUE;
+			}
+			g_hash_table_iter_steal (&hash_iter);
 			i++;
-		nm_assert (i == n);
+		}
+		n = i;
+		if (n == 0)
+			continue;
 
 		g_qsort_with_data (values, n, sizeof (values[0]), _sort_pending_notifies, NULL);
 
+		n_variants = 0;
 		g_variant_builder_init (&notifies, G_VARIANT_TYPE_VARDICT);
-		for (i = 0; i < n; i++)
-			g_variant_builder_add (&notifies, "{sv}", values[i].property_name, values[i].variant);
+		for (i = 0; i < n; i++) {
+			PendingNotify *pn = values[i].pn;
+
+			if (pn->skeleton_property_name) {
+				GValue value = G_VALUE_INIT;
+				GParamSpec *pspec;
+
+				pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (self), pn->skeleton_property_name);
+				g_value_init (&value, pspec->value_type);
+				g_object_get_property ((GObject *) self, pn->skeleton_property_name, &value);
+				g_object_set_property ((GObject *) ifdata->interface, pn->skeleton_property_name, &value);
+				if (pn->deferred_vtype) {
+					nm_assert (!pn->variant);
+					pn->variant = g_dbus_gvalue_to_gvariant (&value, pn->deferred_vtype);
+				}
+				g_value_unset (&value);
+			}
+			if (pn->variant) {
+				g_variant_builder_add (&notifies, "{sv}", values[i].property_name, pn->variant);
+				n_variants++;
+			}
+		}
 		variant = g_variant_ref_sink (g_variant_builder_end (&notifies));
 
+		for (i = 0; i < n; i++)
+			_pending_notify_free (values[i].pn);
+
+		if (n_variants == 0)
+			continue;
+
+		nm_assert (ifdata->property_changed_signal_id);
 
 		if (_LOG2D_ENABLED ()) {
 			gs_free char *notification = g_variant_print (variant, TRUE);
@@ -850,13 +1083,234 @@ idle_emit_properties_changed (gpointer self)
 		}
 
 		g_signal_emit (ifdata->interface, ifdata->property_changed_signal_id, 0, variant);
+	}
 
-		g_hash_table_remove_all (ifdata->pending_notifies);
+	for (k = 0; k < _NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM; k++) {
+		if (class_emitted[k])
+			priv->last_emit_msec[k] = now_msec;
 	}
 
+	return next_due_msec;
+}
+
+static gboolean
+_pending_dispatch (gpointer user_data)
+{
+	CList lst_todo;
+	NMExportedObjectPrivate *priv;
+	gint64 now_msec;
+	gint64 next_due_msec = 0;
+
+	_pending.source_id = 0;
+
+	now_msec = nm_utils_get_monotonic_timestamp_ms ();
+
+	c_list_init (&lst_todo);
+	c_list_splice (&lst_todo, &_pending.lst_head);
+
+	/* emitting signals may schedule new notifications and may even
+	 * unexport objects in @lst_todo. Hence, always take the first entry. */
+	while ((priv = c_list_first_entry (&lst_todo, NMExportedObjectPrivate, pending_lst))) {
+		gs_unref_object NMExportedObject *self = NULL;
+		gint64 due_msec = priv->pending_due_msec;
+
+		c_list_unlink (&priv->pending_lst);
+
+		if (due_msec > now_msec) {
+			c_list_link_tail (&_pending.lst_head, &priv->pending_lst);
+			if (!next_due_msec || due_msec < next_due_msec)
+				next_due_msec = due_msec;
+			continue;
+		}
+
+		self = g_object_ref (priv->self);
+		due_msec = _emit_properties_changed (self, now_msec);
+		if (due_msec) {
+			if (c_list_is_empty (&priv->pending_lst)) {
+				c_list_link_tail (&_pending.lst_head, &priv->pending_lst);
+				priv->pending_due_msec = due_msec;
+			} else
+				priv->pending_due_msec = MIN (priv->pending_due_msec, due_msec);
+			if (!next_due_msec || due_msec < next_due_msec)
+				next_due_msec = due_msec;
+		}
+	}
+
+	if (next_due_msec)
+		_pending_reschedule (next_due_msec, now_msec);
+
 	return G_SOURCE_REMOVE;
 }
 
+static void
+_pending_clear (NMExportedObject *self)
+{
+	NMExportedObjectPrivate *priv = NM_EXPORTED_OBJECT_GET_PRIVATE (self);
+
+	c_list_unlink (&priv->pending_lst);
+}
+
+static void
+_pending_notify_add (InterfaceData *ifdata,
+                     const char *dbus_property_name,
+                     GVariant *variant_take,
+                     const GVariantType *deferred_vtype,
+                     const char *skeleton_property_name,
+                     NMExportedObjectPropertyClass property_class)
+{
+	PendingNotify *pn;
+
+	pn = g_slice_new (PendingNotify);
+	*pn = (PendingNotify) {
+		.variant = variant_take,
+		.deferred_vtype = deferred_vtype,
+		.skeleton_property_name = skeleton_property_name,
+		.property_class = property_class,
+	};
+
+	/* @dbus_property_name is inside classinfo and never freed, thus we don't clone it.
+	 * Also, we do a pointer, not string comparison. */
+	g_hash_table_insert (ifdata->pending_notifies, (gpointer) dbus_property_name, pn);
+}
+
+/*****************************************************************************/
+
+/* Rate-limited and deferred properties are only copied to the skeleton when
+ * their change gets emitted. A D-Bus property read must not return the
+ * stale value of the skeleton, hence the vtable and the get_properties()
+ * function of the skeleton classes are wrapped to copy the pending values
+ * first. The notifications stay pending, the deprecated PropertiesChanged
+ * signal is still emitted later. */
+
+typedef struct {
+	GDBusInterfaceVTable vtable;
+	GDBusInterfaceVTable *(*get_vtable) (GDBusInterfaceSkeleton *interface);
+	GVariant *(*get_properties) (GDBusInterfaceSkeleton *interface);
+	GDBusInterfaceGetPropertyFunc get_property;
+	bool vtable_initialized:1;
+} SkeletonClassData;
+
+static NM_CACHED_QUARK_FCN ("skeleton-class-data", _skeleton_class_data_quark)
+
+static SkeletonClassData *
+_skeleton_class_data_get (GDBusInterfaceSkeleton *interface)
+{
+	SkeletonClassData *class_data;
+	GType type;
+
+	for (type = G_OBJECT_TYPE (interface); type; type = g_type_parent (type)) {
+		class_data = g_type_get_qdata (type, _skeleton_class_data_quark ());
+		if (class_data)
+			return class_data;
+	}
+	g_return_val_if_reached (NULL);
+}
+
+static void
+_skeleton_sync_pending (GDBusInterfaceSkeleton *interface)
+{
+	gs_unref_object GDBusObject *object = NULL;
+	NMExportedObjectPrivate *priv;
+	GHashTableIter hash_iter;
+	PendingNotify *pn;
+	guint i;
+
+	object = g_dbus_interface_dup_object ((GDBusInterface *) interface);
+	if (!NM_IS_EXPORTED_OBJECT (object))
+		return;
+
+	priv = NM_EXPORTED_OBJECT_GET_PRIVATE ((NMExportedObject *) object);
+	if (c_list_is_empty (&priv->pending_lst))
+		return;
+
+	for (i = 0; i < priv->num_interfaces; i++) {
+		InterfaceData *ifdata = &priv->interfaces[i];
+
+		if (ifdata->interface != interface)
+			continue;
+
+		g_hash_table_iter_init (&hash_iter, ifdata->pending_notifies);
+		while (g_hash_table_iter_next (&hash_iter, NULL, (gpointer *) &pn)) {
+			GValue value = G_VALUE_INIT;
+			GParamSpec *pspec;
+
+			if (!pn->skeleton_property_name)
+				continue;
+
+			pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (object), pn->skeleton_property_name);
+			g_value_init (&value, pspec->value_type);
+			g_object_get_property ((GObject *) object, pn->skeleton_property_name, &value);
+			g_object_set_property ((GObject *) interface, pn->skeleton_property_name, &value);
+			g_value_unset (&value);
+		}
+		return;
+	}
+}
+
+static GVariant *
+_skeleton_get_property (GDBusConnection *connection,
+                        const char *sender,
+                        const char *object_path,
+                        const char *interface_name,
+                        const char *property_name,
+                        GError **error,
+                        gpointer user_data)
+{
+	GDBusInterfaceSkeleton *interface = user_data;
+
+	_skeleton_sync_pending (interface);
+	return _skeleton_class_data_get (interface)->get_property (connection, sender, object_path,
+	                                                          interface_name, property_name,
+	                                                          error, user_data);
+}
+
+static GDBusInterfaceVTable *
+_skeleton_get_vtable (GDBusInterfaceSkeleton *interface)
+{
+	SkeletonClassData *class_data = _skeleton_class_data_get (interface);
+
+	if (!class_data->vtable_initialized) {
+		class_data->vtable = *class_data->get_vtable (interface);
+		class_data->get_property = class_data->vtable.get_property;
+		if (class_data->get_property)
+			class_data->vtable.get_property = _skeleton_get_property;
+		class_data->vtable_initialized = TRUE;
+	}
+	return &class_data->vtable;
+}
+
+static GVariant *
+_skeleton_get_properties (GDBusInterfaceSkeleton *interface)
+{
+	_skeleton_sync_pending (interface);
+	return _skeleton_class_data_get (interface)->get_properties (interface);
+}
+
+static void
+_skeleton_class_hook (GType dbus_skeleton_type)
+{
+	GDBusInterfaceSkeletonClass *skeleton_class;
+	SkeletonClassData *class_data;
+
+	if (g_type_get_qdata (dbus_skeleton_type, _skeleton_class_data_quark ()))
+		return;
+
+	/* the reference is never released, the class stays patched. */
+	skeleton_class = g_type_class_ref (dbus_skeleton_type);
+
+	/* a subclass of a patched class inherits the wrappers already. */
+	if (skeleton_class->get_vtable == _skeleton_get_vtable)
+		return;
+
+	class_data = g_slice_new0 (SkeletonClassData);
+	class_data->get_vtable = skeleton_class->get_vtable;
+	class_data->get_properties = skeleton_class->get_properties;
+	g_type_set_qdata (dbus_skeleton_type, _skeleton_class_data_quark (), class_data);
+
+	skeleton_class->get_vtable = _skeleton_get_vtable;
+	skeleton_class->get_properties = _skeleton_get_properties;
+}
+
 static void
 nm_exported_object_notify (GObject *object, GParamSpec *pspec)
 {
@@ -869,6 +1323,8 @@ nm_exported_object_notify (GObject *object, GParamSpec *pspec)
 	GVariant *value_variant;
 	InterfaceData *ifdata = NULL;
 	const GVariantType *vtype;
+	NMExportedObjectPropertyClass property_class;
+	const char *skeleton_property_name;
 	guint i, j;
 
 	/* Hook to emit deprecated "PropertiesChanged" signal on NetworkManager interfaces.
@@ -908,6 +1364,26 @@ nm_exported_object_notify (GObject *object, GParamSpec *pspec)
 	g_return_if_reached ();
 
 vtype_found:
+	property_class = _property_class_lookup (G_OBJECT_TYPE (self), pspec->name);
+	skeleton_property_name =   property_class != NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT
+	                         ? pspec->name
+	                         : NULL;
+
+	if (property_class == NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED) {
+		/* don't fetch the value now. Any further change until the emission
+		 * replaces this pending notification. */
+		nm_assert (   !NM_IS_DEVICE (self)
+		           && !NM_IS_ACTIVE_CONNECTION (self));
+		_pending_notify_add (ifdata,
+		                     dbus_property_name,
+		                     NULL,
+		                     ifdata->property_changed_signal_id ? vtype : NULL,
+		                     skeleton_property_name,
+		                     property_class);
+		_pending_schedule (self, 0);
+		return;
+	}
+
 	g_value_init (&value, pspec->value_type);
 	g_object_get_property ((GObject *) self, pspec->name, &value);
 	value_variant = g_dbus_gvalue_to_gvariant (&value, vtype);
@@ -941,29 +1417,38 @@ vtype_found:
 		 * The Device.Statistics signal is special, because it was only added with 1.4.0
 		 * and didn't have above behavior. So let's save the overhead of emitting multiple
 		 * deprecated signals for wrong interfaces. */
+		nm_assert (!skeleton_property_name);
 		for (i = 0, j = 0; i < priv->num_interfaces; i++) {
 			ifdata = &priv->interfaces[i];
 			if (   ifdata->property_changed_signal_id
 			    && !NMDBUS_IS_DEVICE_STATISTICS_SKELETON (ifdata->interface)) {
 				j++;
-				g_hash_table_insert (ifdata->pending_notifies,
-				                     (gpointer) dbus_property_name,
-				                     g_variant_ref (value_variant));
+				_pending_notify_add (ifdata,
+				                     dbus_property_name,
+				                     g_variant_ref (value_variant),
+				                     NULL,
+				                     NULL,
+				                     property_class);
 			}
 		}
 		nm_assert (j > 0);
 		g_variant_unref (value_variant);
-	} else if (ifdata->property_changed_signal_id) {
-		/* @dbus_property_name is inside classinfo and never freed, thus we don't clone it.
-		 * Also, we do a pointer, not string comparison. */
-		g_hash_table_insert (ifdata->pending_notifies,
-		                     (gpointer) dbus_property_name,
-		                     value_variant);
-	} else
+	} else if (   ifdata->property_changed_signal_id
+	           || skeleton_property_name) {
+		if (!ifdata->property_changed_signal_id)
+			nm_clear_pointer (&value_variant, g_variant_unref);
+		_pending_notify_add (ifdata,
+		                     dbus_property_name,
+		                     value_variant,
+		                     NULL,
+		                     skeleton_property_name,
+		                     property_class);
+	} else {
 		g_variant_unref (value_variant);
+		return;
+	}
 
-	if (!priv->notify_idle_id)
-		priv->notify_idle_id = g_idle_add (idle_emit_properties_changed, self);
+	_pending_schedule (self, 0);
 }
 
 /*****************************************************************************/
@@ -992,6 +1477,9 @@ nm_exported_object_init (NMExportedObject *self)
 
 	priv = G_TYPE_INSTANCE_GET_PRIVATE (self, NM_TYPE_EXPORTED_OBJECT, NMExportedObjectPrivate);
 	self->_priv = priv;
+
+	priv->self = self;
+	c_list_init (&priv->pending_lst);
 }
 
 static void
@@ -1028,7 +1516,7 @@ dispose (GObject *object)
 	} else if (nm_clear_g_free (&priv->path))
 		_notify (self, PROP_PATH);
 
-	nm_clear_g_source (&priv->notify_idle_id);
+	_pending_clear (self);
 
 	G_OBJECT_CLASS (nm_exported_object_parent_class)->dispose (object);
 }
@@ -65,6 +65,26 @@ typedef struct {
 	char export_on_construction;
 } NMExportedObjectClass;
 
+/* Properties that change frequently can be assigned a class, so that
+ * their change notifications are rate-limited on D-Bus, or that are
+ * expensive to compute, so that their value is only fetched when the
+ * change gets emitted. */
+typedef enum {
+	NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFAULT,
+
+	/* traffic counters, like Device.Statistics.TxBytes. */
+	NM_EXPORTED_OBJECT_PROPERTY_CLASS_STATISTICS,
+
+	/* signal quality, like AccessPoint.Strength. */
+	NM_EXPORTED_OBJECT_PROPERTY_CLASS_SIGNAL,
+
+	/* large values, like IP4Config.RouteData. Not rate-limited, but
+	 * several changes until the emission are serialized only once. */
+	NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED,
+
+	_NM_EXPORTED_OBJECT_PROPERTY_CLASS_NUM,
+} NMExportedObjectPropertyClass;
+
 GType nm_exported_object_get_type (void);
 
 void nm_exported_object_class_set_quitting  (void);
@@ -73,6 +93,13 @@ void nm_exported_object_class_add_interface (NMExportedObjectClass *object_class
                                              GType                  dbus_skeleton_type,
                                              ...) G_GNUC_NULL_TERMINATED;
 
+void nm_exported_object_class_set_property_class (NMExportedObjectClass *object_class,
+                                                  const char *property_name,
+                                                  NMExportedObjectPropertyClass property_class);
+
+void nm_exported_object_set_property_class_interval (NMExportedObjectPropertyClass property_class,
+                                                     guint interval_msec);
+
 const char *nm_exported_object_export      (NMExportedObject *self);
 const char *nm_exported_object_get_path    (NMExportedObject *self);
 gboolean    nm_exported_object_is_exported (NMExportedObject *self);
@@ -85,6 +85,7 @@ nm_ip_config_dedup_multi_idx_type_init (NMIPConfigDedupMultiIdxType *idx_type,
 	nm_dedup_multi_idx_type_init ((NMDedupMultiIdxType *) idx_type,
 	                              &idx_type_class);
 	idx_type->obj_type = obj_type;
+	idx_type->parent.fixed_width_keys = TRUE;
 }
 
 /*****************************************************************************/
@@ -467,6 +468,66 @@ _nm_ip_config_best_default_route_merge (const NMPObject **best_default_route, co
 	return _nm_ip_config_best_default_route_set (best_default_route, new_candidate);
 }
 
+/*****************************************************************************/
+
+/**
+ * nm_ip_config_update_ext_route:
+ * @ext: the external configuration, that is the capture of the interface
+ *   without the routes of the internal configurations.
+ * @ext_captured: (allow-none): the unfiltered capture, if there is one.
+ * @platform: the platform
+ * @route: a route of the interface that changed since @ext was captured.
+ *   It must not be a default route, those are compared with a metric
+ *   penalty.
+ * @internal: %NULL terminated list of the internal configurations.
+ *
+ * Updates @ext and @ext_captured for @route, with the same result as
+ * capturing the interface again and subtracting @internal.
+ *
+ * Returns: %FALSE if @route no longer exists. Then the caller should also
+ *   remove it from the internal configurations, like intersecting them
+ *   with a new capture would.
+ */
+gboolean
+nm_ip_config_update_ext_route (NMIPConfig *ext,
+                               NMIPConfig *ext_captured,
+                               NMPlatform *platform,
+                               const NMPObject *route,
+                               NMIPConfig *const *internal)
+{
+	const NMPObject *obj;
+	gboolean is_internal = FALSE;
+
+	nm_assert (ext);
+	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (route), NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                                  NMP_OBJECT_TYPE_IP6_ROUTE));
+	nm_assert (!NM_PLATFORM_IP_ROUTE_IS_DEFAULT (NMP_OBJECT_CAST_IP_ROUTE (route)));
+
+	/* Only the current state matters, not how we got there. This also
+	 * makes it harmless if a route is passed more than once. */
+	obj = nm_platform_lookup_obj (platform, NMP_CACHE_ID_TYPE_OBJECT_TYPE, route);
+	if (!obj) {
+		if (ext_captured)
+			nm_ip_config_nmpobj_remove (ext_captured, route);
+		nm_ip_config_nmpobj_remove (ext, route);
+		return FALSE;
+	}
+
+	if (ext_captured)
+		nm_ip_config_add_route (ext_captured, NMP_OBJECT_CAST_IP_ROUTE (obj));
+
+	for (; !is_internal && internal && *internal; internal++)
+		is_internal = !!nm_ip_config_nmpobj_lookup (*internal, obj);
+
+	if (is_internal)
+		nm_ip_config_nmpobj_remove (ext, obj);
+	else
+		nm_ip_config_add_route (ext, NMP_OBJECT_CAST_IP_ROUTE (obj));
+	return TRUE;
+}
+
+/*****************************************************************************/
+
 const NMPObject *
 nm_ip4_config_best_default_route_get (const NMIP4Config *self)
 {
@@ -3302,4 +3363,16 @@ nm_ip4_config_class_init (NMIP4ConfigClass *config_class)
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (config_class),
 	                                        NMDBUS_TYPE_IP4_CONFIG_SKELETON,
 	                                        NULL);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP4_CONFIG_ADDRESS_DATA,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP4_CONFIG_ADDRESSES,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP4_CONFIG_ROUTE_DATA,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP4_CONFIG_ROUTES,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
 }
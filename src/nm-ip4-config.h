@@ -398,6 +398,30 @@ nm_ip_config_add_address (NMIPConfig *self, const NMPlatformIPAddress *address)
 	_NM_IP_CONFIG_DISPATCH_VOID (self, nm_ip4_config_add_address, nm_ip6_config_add_address, (gconstpointer) address);
 }
 
+static inline void
+nm_ip_config_add_route (NMIPConfig *self, const NMPlatformIPRoute *route)
+{
+	_NM_IP_CONFIG_DISPATCH_VOID (self, nm_ip4_config_add_route, nm_ip6_config_add_route, (gconstpointer) route, NULL);
+}
+
+static inline const NMPObject *
+nm_ip_config_nmpobj_lookup (const NMIPConfig *self, const NMPObject *needle)
+{
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_nmpobj_lookup, nm_ip6_config_nmpobj_lookup, needle);
+}
+
+static inline gboolean
+nm_ip_config_nmpobj_remove (NMIPConfig *self, const NMPObject *needle)
+{
+	_NM_IP_CONFIG_DISPATCH (self, nm_ip4_config_nmpobj_remove, nm_ip6_config_nmpobj_remove, needle);
+}
+
+gboolean nm_ip_config_update_ext_route (NMIPConfig *ext,
+                                        NMIPConfig *ext_captured,
+                                        NMPlatform *platform,
+                                        const NMPObject *route,
+                                        NMIPConfig *const *internal);
+
 static inline int
 nm_ip_config_get_dns_priority (const NMIPConfig *self)
 {
@@ -2857,4 +2857,16 @@ nm_ip6_config_class_init (NMIP6ConfigClass *config_class)
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (config_class),
 	                                        NMDBUS_TYPE_IP6_CONFIG_SKELETON,
 	                                        NULL);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP6_CONFIG_ADDRESS_DATA,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP6_CONFIG_ADDRESSES,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP6_CONFIG_ROUTE_DATA,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
+	nm_exported_object_class_set_property_class (NM_EXPORTED_OBJECT_CLASS (config_class),
+	                                             NM_IP6_CONFIG_ROUTES,
+	                                             NM_EXPORTED_OBJECT_PROPERTY_CLASS_DEFERRED);
 }
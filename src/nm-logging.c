@@ -31,6 +31,8 @@
 #include <sys/stat.h>
 #include <strings.h>
 #include <string.h>
+#include <time.h>
+#include <net/if.h>
 
 #if SYSTEMD_JOURNAL
 #define SD_JOURNAL_SUPPRESS_LOCATION
@@ -587,42 +589,6 @@ _iovec_set_format (struct iovec *iov, gpointer *iov_free, const char *format, ..
 	} G_STMT_END
 #endif
 
-void
-_nm_log_impl (const char *file,
-              guint line,
-              const char *func,
-              NMLogLevel level,
-              NMLogDomain domain,
-              int error,
-              const char *ifname,
-              const char *conn_uuid,
-              const char *fmt,
-              ...)
-{
-	va_list args;
-	char *msg;
-	GTimeVal tv;
-	int errno_saved;
-
-	if ((guint) level >= G_N_ELEMENTS (_nm_logging_enabled_state))
-		g_return_if_reached ();
-
-	if (!(_nm_logging_enabled_state[level] & domain))
-		return;
-
-	errno_saved = errno;
-
-	/* Make sure that %m maps to the specified error */
-	if (error != 0) {
-		if (error < 0)
-			error = -error;
-		errno = error;
-	}
-
-	va_start (args, fmt);
-	msg = g_strdup_vprintf (fmt, args);
-	va_end (args);
-
 #define MESSAGE_FMT "%s%-7s [%ld.%04ld] %s"
 #define MESSAGE_ARG(global, tv, msg) \
     (global).prefix, \
@@ -631,8 +597,18 @@ _nm_log_impl (const char *file,
     ((tv).tv_usec / 100), \
     (msg)
 
-	g_get_current_time (&tv);
-
+static void
+_log_write (const char *file,
+            guint line,
+            const char *func,
+            NMLogLevel level,
+            NMLogDomain domain,
+            int error,
+            const char *ifname,
+            const char *conn_uuid,
+            GTimeVal tv,
+            const char *msg)
+{
 	if (global.debug_stderr)
 		g_printerr (MESSAGE_FMT"\n", MESSAGE_ARG (global, tv, msg));
 
@@ -731,6 +707,223 @@ _nm_log_impl (const char *file,
 		break;
 	}
 
+}
+
+/*****************************************************************************/
+
+/* The ring keeps the verbose messages in memory instead of passing
+ * them to the logging backend. The hot path formats the message into
+ * a preallocated entry, without allocating memory and without a
+ * syscall. Concurrent writers claim entries with an atomic counter.
+ *
+ * The arguments themselves cannot be kept for later, because strings
+ * like interface names may already be gone when the ring is flushed.
+ *
+ * The size of the ring is a power of two, so that the position of an
+ * index in the ring stays continuous when the 32 bit counter wraps. */
+
+#define RING_MSG_LEN 400
+
+/* replaces the end of messages that don't fit into an entry. */
+#define RING_MSG_TRUNCATED "..."
+
+typedef struct {
+	/* 2 * index + 1 while the entry is written, 2 * index + 2 afterwards. */
+	volatile gint seq;
+
+	NMLogLevel level;
+	NMLogDomain domain;
+	int error;
+	const char *file;
+	const char *func;
+	guint line;
+	GTimeVal tv;
+	char ifname[IFNAMSIZ];
+	char conn_uuid[37];
+	char msg[RING_MSG_LEN];
+} RingEntry;
+
+static struct {
+	RingEntry *entries;
+	guint size;
+	volatile gint next;
+	guint flushed;
+} ring;
+
+static void
+_ring_add (const char *file,
+           guint line,
+           const char *func,
+           NMLogLevel level,
+           NMLogDomain domain,
+           int error,
+           const char *ifname,
+           const char *conn_uuid,
+           const char *fmt,
+           va_list args)
+{
+	struct timespec ts;
+	RingEntry *entry;
+	guint idx;
+	int len;
+
+	idx = (guint) g_atomic_int_add (&ring.next, 1);
+	entry = &ring.entries[idx & (ring.size - 1)];
+
+	g_atomic_int_set (&entry->seq, (gint) (2 * idx + 1));
+
+	clock_gettime (CLOCK_REALTIME, &ts);
+	entry->tv.tv_sec = ts.tv_sec;
+	entry->tv.tv_usec = ts.tv_nsec / 1000;
+	entry->level = level;
+	entry->domain = domain;
+	entry->error = error;
+	entry->file = file;
+	entry->line = line;
+	entry->func = func;
+	g_strlcpy (entry->ifname, ifname ?: "", sizeof (entry->ifname));
+	g_strlcpy (entry->conn_uuid, conn_uuid ?: "", sizeof (entry->conn_uuid));
+	len = g_vsnprintf (entry->msg, sizeof (entry->msg), fmt, args);
+	if (len >= (int) sizeof (entry->msg)) {
+		memcpy (&entry->msg[sizeof (entry->msg) - sizeof (RING_MSG_TRUNCATED)],
+		        RING_MSG_TRUNCATED,
+		        sizeof (RING_MSG_TRUNCATED));
+	}
+
+	g_atomic_int_set (&entry->seq, (gint) (2 * idx + 2));
+}
+
+/**
+ * nm_logging_ring_setup:
+ * @size: the number of messages to keep. It is rounded up to a power
+ *   of two, and limited to %NM_LOGGING_RING_SIZE_MAX.
+ *
+ * With a ring, messages of the levels DEBUG and TRACE are only
+ * kept in memory. They are passed to the logging backend by
+ * nm_logging_ring_flush(). Can only be set up once.
+ */
+void
+nm_logging_ring_setup (guint size)
+{
+	guint n;
+
+	if (ring.entries)
+		g_return_if_reached ();
+	if (size == 0)
+		return;
+
+	size = MIN (size, NM_LOGGING_RING_SIZE_MAX);
+	for (n = 1; n < size; n <<= 1)
+		;
+
+	ring.entries = g_new0 (RingEntry, n);
+	ring.size = n;
+}
+
+void
+_nm_logging_ring_set_index_for_testing (guint idx)
+{
+	g_atomic_int_set (&ring.next, (gint) idx);
+	ring.flushed = idx;
+}
+
+/**
+ * nm_logging_ring_flush:
+ *
+ * Writes the messages from the ring to the logging backend, that
+ * were added since the last flush. Messages that were overwritten
+ * in the meantime are lost.
+ */
+void
+nm_logging_ring_flush (void)
+{
+	guint idx, next;
+	guint n_lost = 0;
+	RingEntry entry;
+
+	if (!ring.entries)
+		return;
+
+	next = (guint) g_atomic_int_get (&ring.next);
+	idx = ring.flushed;
+	if (next - idx > ring.size) {
+		n_lost = next - idx - ring.size;
+		idx = next - ring.size;
+	}
+
+	nm_log_info (LOGD_CORE, "logging: flush %u messages from ring (%u lost)", next - idx, n_lost);
+
+	for (; idx != next; idx++) {
+		const RingEntry *e = &ring.entries[idx & (ring.size - 1)];
+
+		if (g_atomic_int_get (&e->seq) != (gint) (2 * idx + 2))
+			continue;
+		entry = *e;
+		if (g_atomic_int_get (&e->seq) != (gint) (2 * idx + 2)) {
+			/* overwritten while copying. */
+			continue;
+		}
+
+		_log_write (entry.file, entry.line, entry.func,
+		            entry.level, entry.domain, entry.error,
+		            entry.ifname[0] ? entry.ifname : NULL,
+		            entry.conn_uuid[0] ? entry.conn_uuid : NULL,
+		            entry.tv, entry.msg);
+	}
+	ring.flushed = next;
+}
+
+/*****************************************************************************/
+
+void
+_nm_log_impl (const char *file,
+              guint line,
+              const char *func,
+              NMLogLevel level,
+              NMLogDomain domain,
+              int error,
+              const char *ifname,
+              const char *conn_uuid,
+              const char *fmt,
+              ...)
+{
+	va_list args;
+	char *msg;
+	GTimeVal tv;
+	int errno_saved;
+
+	if ((guint) level >= G_N_ELEMENTS (_nm_logging_enabled_state))
+		g_return_if_reached ();
+
+	if (!(_nm_logging_enabled_state[level] & domain))
+		return;
+
+	errno_saved = errno;
+
+	/* Make sure that %m maps to the specified error */
+	if (error != 0) {
+		if (error < 0)
+			error = -error;
+		errno = error;
+	}
+
+	if (   ring.entries
+	    && level < LOGL_INFO) {
+		va_start (args, fmt);
+		_ring_add (file, line, func, level, domain, error, ifname, conn_uuid, fmt, args);
+		va_end (args);
+		errno = errno_saved;
+		return;
+	}
+
+	va_start (args, fmt);
+	msg = g_strdup_vprintf (fmt, args);
+	va_end (args);
+
+	g_get_current_time (&tv);
+
+	_log_write (file, line, func, level, domain, error, ifname, conn_uuid, tv, msg);
+
 	g_free (msg);
 
 	errno = errno_saved;
@@ -233,6 +233,13 @@ void nm_logging_set_prefix (const char *format, ...) _nm_printf (1, 2);
 void     nm_logging_syslog_openlog (const char *logging_backend, gboolean debug);
 gboolean nm_logging_syslog_enabled (void);
 
+#define NM_LOGGING_RING_SIZE_MAX 8192
+
+void nm_logging_ring_setup (guint size);
+void nm_logging_ring_flush (void);
+
+void _nm_logging_ring_set_index_for_testing (guint idx);
+
 /*****************************************************************************/
 
 /* This is the default definition of _NMLOG_ENABLED(). Special implementations
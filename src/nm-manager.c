@@ -780,16 +780,32 @@ _get_activatable_connections_filter (NMSettings *settings,
 	return !active_connection_find_first (user_data, connection, NULL, NM_ACTIVE_CONNECTION_STATE_DEACTIVATING);
 }
 
+/**
+ * nm_manager_get_activatable_connections:
+ * @manager: the #NMManager
+ * @device: (allow-none): if given, skip connections that are bound
+ *   to a different interface and thus cannot be activated on @device.
+ * @out_len: (allow-none): the number of returned connections
+ * @sort: whether to sort the connections by autoconnect priority
+ *
+ * Returns: (transfer container): a NULL terminated list of connections
+ *   that are not volatile and not already active.
+ */
 NMSettingsConnection **
-nm_manager_get_activatable_connections (NMManager *manager, guint *out_len, gboolean sort)
+nm_manager_get_activatable_connections (NMManager *manager,
+                                        NMDevice *device,
+                                        guint *out_len,
+                                        gboolean sort)
 {
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
 
-	return nm_settings_get_connections_clone (priv->settings, out_len,
-	                                          _get_activatable_connections_filter,
-	                                          manager,
-	                                          sort ? nm_settings_connection_cmp_autoconnect_priority_p_with_data : NULL,
-	                                          NULL);
+	return nm_settings_get_connections_clone_for_ifname (priv->settings,
+	                                                     device ? nm_device_get_iface (device) : NULL,
+	                                                     out_len,
+	                                                     _get_activatable_connections_filter,
+	                                                     manager,
+	                                                     sort ? nm_settings_connection_cmp_autoconnect_priority_p_with_data : NULL,
+	                                                     NULL);
 }
 
 static NMActiveConnection *
@@ -2201,7 +2217,7 @@ get_existing_connection (NMManager *self,
 
 		/* the state file doesn't indicate a connection UUID to assume. Search the
 		 * persistent connections for a matching candidate. */
-		connections = nm_manager_get_activatable_connections (self, &len, FALSE);
+		connections = nm_manager_get_activatable_connections (self, device, &len, FALSE);
 		if (len > 0) {
 			for (i = 0, j = 0; i < len; i++) {
 				NMConnection *con = NM_CONNECTION (connections[i]);
@@ -3227,7 +3243,7 @@ ensure_master_active_connection (NMManager *self,
 			g_assert (master_connection == NULL);
 
 			/* Find a compatible connection and activate this device using it */
-			connections = nm_manager_get_activatable_connections (self, NULL, TRUE);
+			connections = nm_manager_get_activatable_connections (self, master_device, NULL, TRUE);
 			for (i = 0; connections[i]; i++) {
 				NMSettingsConnection *candidate = connections[i];
 
@@ -5321,6 +5337,35 @@ impl_manager_get_logging (NMManager *manager,
 	                                                      nm_logging_domains_to_string ()));
 }
 
+static void
+impl_manager_get_platform_statistics (NMManager *manager,
+                                      GDBusMethodInvocation *context)
+{
+	NMPlatformNetlinkStats stats;
+	GVariantBuilder builder;
+
+	nm_platform_netlink_get_stats (NM_PLATFORM_GET, &stats);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+	g_variant_builder_add (&builder, "{sv}", "netlink-rcvbuf",
+	                       g_variant_new_int64 (stats.rcvbuf));
+	g_variant_builder_add (&builder, "{sv}", "netlink-nobufs",
+	                       g_variant_new_uint64 (stats.nobufs));
+	g_variant_builder_add (&builder, "{sv}", "netlink-buf-grows",
+	                       g_variant_new_uint64 (stats.buf_grows));
+	g_variant_builder_add (&builder, "{sv}", "netlink-resyncs",
+	                       g_variant_new_uint64 (stats.resyncs));
+	g_variant_builder_add (&builder, "{sv}", "netlink-resync-total-usec",
+	                       g_variant_new_int64 (stats.resync_total_usec));
+	g_variant_builder_add (&builder, "{sv}", "netlink-resync-last-usec",
+	                       g_variant_new_int64 (stats.resync_last_usec));
+	g_variant_builder_add (&builder, "{sv}", "netlink-msgs-per-read-peak",
+	                       g_variant_new_uint64 (stats.msgs_per_read_peak));
+
+	g_dbus_method_invocation_return_value (context,
+	                                       g_variant_new ("(a{sv})", &builder));
+}
+
 typedef struct {
 	guint remaining;
 	GDBusMethodInvocation *context;
@@ -7150,6 +7195,7 @@ nm_manager_class_init (NMManagerClass *manager_class)
 	                                        "GetPermissions", impl_manager_get_permissions,
 	                                        "SetLogging", impl_manager_set_logging,
 	                                        "GetLogging", impl_manager_get_logging,
+	                                        "GetPlatformStatistics", impl_manager_get_platform_statistics,
 	                                        "CheckConnectivity", impl_manager_check_connectivity,
 	                                        "state", impl_manager_get_state,
 	                                        "CheckpointCreate", impl_manager_checkpoint_create,
@@ -101,6 +101,7 @@ const CList * nm_manager_get_active_connections        (NMManager *manager);
 	    iter = c_list_entry (iter->active_connections_lst.next, NMActiveConnection, active_connections_lst))
 
 NMSettingsConnection **nm_manager_get_activatable_connections (NMManager *manager,
+                                                               NMDevice *device,
                                                                guint *out_len,
                                                                gboolean sort);
 
@@ -1217,6 +1217,7 @@ ip_route_add (NMPlatform *platform,
 	NMPlatformIP4Route *r4 = NULL;
 	NMPlatformIP6Route *r6 = NULL;
 	gboolean has_same_weak_id;
+	gboolean has_same_id;
 	gboolean only_dirty;
 	guint16 nlmsgflags;
 
@@ -1224,8 +1225,10 @@ ip_route_add (NMPlatform *platform,
 
 	flags = NM_FLAGS_UNSET (flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE);
 
-	/* currently, only replace is implemented. */
-	g_assert (flags == NMP_NLM_FLAG_REPLACE);
+	/* currently, only replace, append and prepend are implemented. */
+	g_assert (NM_IN_SET (flags, NMP_NLM_FLAG_REPLACE,
+	                            NMP_NLM_FLAG_APPEND,
+	                            NMP_NLM_FLAG_PREPEND));
 
 	obj = nmp_object_new (addr_family == AF_INET
 	                        ? NMP_OBJECT_TYPE_IP4_ROUTE
@@ -1290,27 +1293,43 @@ ip_route_add (NMPlatform *platform,
 	}
 
 	has_same_weak_id = FALSE;
+	has_same_id = FALSE;
 	nmp_cache_iter_for_each (&iter,
 	                         nm_platform_lookup_all (platform,
 	                                                 NMP_CACHE_ID_TYPE_ROUTES_BY_WEAK_ID,
 	                                                 obj),
 	                         &o) {
 		if (addr_family == AF_INET) {
-			if (nm_platform_ip4_route_cmp (NMP_OBJECT_CAST_IP4_ROUTE (o), r4, NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) == 0)
+			if (nm_platform_ip4_route_cmp (NMP_OBJECT_CAST_IP4_ROUTE (o), r4, NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) == 0) {
+				has_same_id = TRUE;
 				continue;
+			}
 		} else {
-			if (nm_platform_ip6_route_cmp (NMP_OBJECT_CAST_IP6_ROUTE (o), r6, NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) == 0)
+			if (nm_platform_ip6_route_cmp (NMP_OBJECT_CAST_IP6_ROUTE (o), r6, NM_PLATFORM_IP_ROUTE_CMP_TYPE_ID) == 0) {
+				has_same_id = TRUE;
 				continue;
+			}
 		}
 		has_same_weak_id = TRUE;
 	}
 
+	/* like kernel, only replace may touch an identical route. */
+	if (   has_same_id
+	    && flags != NMP_NLM_FLAG_REPLACE)
+		return (NMPlatformError) -EEXIST;
+
 	nlmsgflags = 0;
 	if (has_same_weak_id) {
 		switch (flags) {
 		case NMP_NLM_FLAG_REPLACE:
 			nlmsgflags = NLM_F_REPLACE;
 			break;
+		case NMP_NLM_FLAG_APPEND:
+			nlmsgflags = NLM_F_CREATE | NLM_F_APPEND;
+			break;
+		case NMP_NLM_FLAG_PREPEND:
+			nlmsgflags = NLM_F_CREATE;
+			break;
 		default:
 			g_assert_not_reached ();
 			break;
@@ -83,6 +83,14 @@ enum {
 #define _NLE_NM_NOBUFS 500
 #define _NLE_MSG_TRUNC 501
 
+#ifndef SOL_NETLINK
+#define SOL_NETLINK                     270
+#endif
+
+#ifndef NETLINK_GET_STRICT_CHK
+#define NETLINK_GET_STRICT_CHK          12
+#endif
+
 /*****************************************************************************/
 
 #define IFQDISCSIZ                      32
@@ -265,6 +273,7 @@ typedef enum {
 	DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS          = (1LL << /* 5 */ DELAYED_ACTION_IDX_REFRESH_ALL_QDISCS),
 	DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS        = (1LL << /* 6 */ DELAYED_ACTION_IDX_REFRESH_ALL_TFILTERS),
 	DELAYED_ACTION_TYPE_REFRESH_LINK                = (1LL <<    7),
+	DELAYED_ACTION_TYPE_REFRESH_IFINDEX             = (1LL <<    8),
 	DELAYED_ACTION_TYPE_MASTER_CONNECTED            = (1LL <<   11),
 	DELAYED_ACTION_TYPE_READ_NETLINK                = (1LL <<   12),
 	DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE        = (1LL <<   13),
@@ -308,6 +317,7 @@ static void delayed_action_schedule (NMPlatform *platform, DelayedActionType act
 static gboolean delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink);
 static void do_request_link_no_delayed_actions (NMPlatform *platform, int ifindex, const char *name);
 static void do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type);
+static void do_request_ifindex_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type, int ifindex);
 static void cache_on_change (NMPlatform *platform,
                              NMPCacheOpsType cache_op,
                              const NMPObject *obj_old,
@@ -392,16 +402,11 @@ static int _support_kernel_extended_ifa_flags = 0;
 #define _support_kernel_extended_ifa_flags_still_undecided() (G_UNLIKELY (_support_kernel_extended_ifa_flags == 0))
 
 static void
-_support_kernel_extended_ifa_flags_detect (struct nl_msg *msg)
+_support_kernel_extended_ifa_flags_detect (const struct nlmsghdr *msg_hdr)
 {
-	struct nlmsghdr *msg_hdr;
 	gboolean support;
 
 	nm_assert (_support_kernel_extended_ifa_flags_still_undecided ());
-	nm_assert (msg);
-
-	msg_hdr = nlmsg_hdr (msg);
-
 	nm_assert (msg_hdr && msg_hdr->nlmsg_type == RTM_NEWADDR);
 
 	/* IFA_FLAGS is set for IPv4 and IPv6 addresses. It was added first to IPv6,
@@ -2388,21 +2393,15 @@ _new_from_nl_tfilter (struct nlmsghdr *nlh, gboolean id_only)
  *   be correctly detected.
  * @cache: (allow-none): for certain objects, the netlink message doesn't contain all the information.
  *   If a cache is given, the object is completed with information from the cache.
- * @nlh: the netlink message header
+ * @msghdr: the netlink message header. The message must originate from a
+ *   NETLINK_ROUTE socket.
  * @id_only: whether only to create an empty object with only the ID fields set.
  *
  * Returns: %NULL or a newly created NMPObject instance.
  **/
 static NMPObject *
-nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nl_msg *msg, gboolean id_only)
+nmp_object_new_from_nl (NMPlatform *platform, const NMPCache *cache, struct nlmsghdr *msghdr, gboolean id_only)
 {
-	struct nlmsghdr *msghdr;
-
-	if (nlmsg_get_proto (msg) != NETLINK_ROUTE)
-		return NULL;
-
-	msghdr = nlmsg_hdr (msg);
-
 	switch (msghdr->nlmsg_type) {
 	case RTM_NEWLINK:
 	case RTM_DELLINK:
@@ -2996,6 +2995,101 @@ nla_put_failure:
 	g_return_val_if_reached (NULL);
 }
 
+/* Create a dump request for @obj_type. This reimplements
+ *   nl_rtgen_request (sk, klass->rtm_gettype, klass->addr_family, NLM_F_DUMP);
+ * because we need the sequence number.
+ *
+ * With @strict_check, kernel rejects the short rtgenmsg header and expects
+ * the full header of the respective type. In exchange, it honors
+ * @ifindex to only dump the addresses or routes of one interface. */
+static struct nl_msg *
+_nl_msg_new_dump (NMPObjectType obj_type,
+                  gboolean strict_check,
+                  int ifindex)
+{
+	const NMPClass *klass = nmp_class_from_type (obj_type);
+	struct nl_msg *msg;
+	int nle;
+
+	nm_assert (ifindex >= 0);
+	nm_assert (   ifindex == 0
+	           || (   strict_check
+	               && NM_IN_SET (obj_type, NMP_OBJECT_TYPE_IP4_ADDRESS,
+	                                       NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                                       NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                       NMP_OBJECT_TYPE_IP6_ROUTE)));
+
+	msg = nlmsg_alloc_simple (klass->rtm_gettype, NLM_F_DUMP);
+	if (!msg)
+		g_return_val_if_reached (NULL);
+
+	switch (obj_type) {
+	case NMP_OBJECT_TYPE_QDISC:
+	case NMP_OBJECT_TYPE_TFILTER: {
+		struct tcmsg tcmsg = {
+			.tcm_family = AF_UNSPEC,
+		};
+
+		nle = nlmsg_append (msg, &tcmsg, sizeof (tcmsg), NLMSG_ALIGNTO);
+		break;
+	}
+	case NMP_OBJECT_TYPE_LINK:
+		if (strict_check) {
+			struct ifinfomsg ifi = {
+				.ifi_family = klass->addr_family,
+			};
+
+			nle = nlmsg_append (msg, &ifi, sizeof (ifi), NLMSG_ALIGNTO);
+			break;
+		}
+		goto rtgenmsg;
+	case NMP_OBJECT_TYPE_IP4_ADDRESS:
+	case NMP_OBJECT_TYPE_IP6_ADDRESS:
+		if (strict_check) {
+			struct ifaddrmsg ifa = {
+				.ifa_family = klass->addr_family,
+				.ifa_index = ifindex,
+			};
+
+			nle = nlmsg_append (msg, &ifa, sizeof (ifa), NLMSG_ALIGNTO);
+			break;
+		}
+		goto rtgenmsg;
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		if (strict_check) {
+			struct rtmsg rtm = {
+				.rtm_family = klass->addr_family,
+			};
+
+			nle = nlmsg_append (msg, &rtm, sizeof (rtm), NLMSG_ALIGNTO);
+			if (nle < 0)
+				break;
+			if (ifindex > 0)
+				NLA_PUT_U32 (msg, RTA_OIF, ifindex);
+			break;
+		}
+		goto rtgenmsg;
+	default:
+rtgenmsg:
+		{
+			struct rtgenmsg gmsg = {
+				.rtgen_family = klass->addr_family,
+			};
+
+			nle = nlmsg_append (msg, &gmsg, sizeof (gmsg), NLMSG_ALIGNTO);
+		}
+		break;
+	}
+	if (nle < 0)
+		goto nla_put_failure;
+
+	return msg;
+nla_put_failure:
+	nlmsg_free (msg);
+	g_return_val_if_reached (NULL);
+}
+
 /******************************************************************
  * NMPlatform types and functions
  ******************************************************************/
@@ -3004,6 +3098,7 @@ typedef enum {
 	DELAYED_ACTION_RESPONSE_TYPE_VOID                       = 0,
 	DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS    = 1,
 	DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET                  = 2,
+	DELAYED_ACTION_RESPONSE_TYPE_REFRESH_IFINDEX            = 3,
 } DelayedActionWaitForNlResponseType;
 
 typedef struct {
@@ -3019,8 +3114,53 @@ typedef struct {
 	} response;
 } DelayedActionWaitForNlResponseData;
 
+/* Argument for DELAYED_ACTION_TYPE_REFRESH_IFINDEX: refresh the objects
+ * of the given REFRESH_ALL types, but only for one interface. */
+typedef struct {
+	int ifindex;
+	DelayedActionType refresh_types;
+} DelayedActionRefreshIfindexData;
+
+/* Number of datagrams that are fetched from the netlink socket with
+ * one recvmmsg() call. Kernel notifications are sent as one datagram
+ * per message, so under a storm of events this saves a syscall per
+ * message. */
+#define NL_RECV_RING_SIZE           16
+#define NL_RECV_RING_BUF_SIZE_INIT  (32 * 1024)
+#define NL_RECV_RING_BUF_SIZE_MAX   (512 * 1024)
+
+typedef struct {
+	struct mmsghdr msgs[NL_RECV_RING_SIZE];
+	struct iovec iovs[NL_RECV_RING_SIZE];
+	union {
+		struct cmsghdr cmsghdr;
+		char buf[CMSG_SPACE (sizeof (struct ucred))];
+	} cmsgs[NL_RECV_RING_SIZE];
+
+	/* the number of datagrams received by the last recvmmsg() call,
+	 * and the index of the next one to process. */
+	guint n_msgs;
+	guint idx;
+
+	/* the highest @n_msgs seen so far. */
+	guint n_msgs_peak;
+
+	/* the size of each receive buffer. If a message gets truncated, we
+	 * increase @buf_size_next and reallocate on the next refill. */
+	gsize buf_size;
+	gsize buf_size_next;
+	guchar *bufs;
+
+	/* the recursion depth of event_handler_recvmsgs(). If the ring is refilled
+	 * while an outer invocation still parses a datagram in-place, the buffers
+	 * cannot be reused but are kept in @bufs_stale until it returns. */
+	guint busy;
+	GSList *bufs_stale;
+} NlRecvRing;
+
 typedef struct {
 	struct nl_sock *nlh;
+	NlRecvRing *recv_ring;
 	guint32 nlh_seq_next;
 #ifdef NM_MORE_LOGGING
 	guint32 nlh_seq_last_handled;
@@ -3031,6 +3171,16 @@ typedef struct {
 
 	bool pruning[_DELAYED_ACTION_IDX_REFRESH_ALL_NUM];
 
+	/* whether NETLINK_GET_STRICT_CHK is enabled on @nlh. Only then, kernel
+	 * honors the ifindex filter of our dump requests. */
+	bool nl_strict_check;
+
+	/* counters about overruns of the event socket. See nm_platform_netlink_get_stats(). */
+	NMPlatformNetlinkStats nl_stats;
+
+	/* if non-zero, the timestamp when the ongoing resync of the cache started. */
+	gint64 nl_resync_start_ns;
+
 	bool sysctl_get_warned;
 	GHashTable *sysctl_get_prev_values;
 
@@ -3047,6 +3197,7 @@ typedef struct {
 
 		GPtrArray *list_master_connected;
 		GPtrArray *list_refresh_link;
+		GArray *list_refresh_ifindex;
 		GArray *list_wait_for_nl_response;
 
 		gint is_handling;
@@ -3388,6 +3539,54 @@ process_events (NMPlatform *platform)
 	delayed_action_handle_all (platform, TRUE);
 }
 
+static int
+_netlink_get_rcvbuf (NMPlatform *platform)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	int size = 0;
+	socklen_t len = sizeof (size);
+
+	if (getsockopt (nl_socket_get_fd (priv->nlh), SOL_SOCKET, SO_RCVBUF, &size, &len) < 0)
+		return -1;
+	return size;
+}
+
+static gboolean
+netlink_set_rcvbuf (NMPlatform *platform, int size)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	int fd = nl_socket_get_fd (priv->nlh);
+	int errsv;
+
+	/* with CAP_NET_ADMIN, SO_RCVBUFFORCE lets us exceed net.core.rmem_max.
+	 * Otherwise, kernel silently caps SO_RCVBUF at rmem_max. */
+	if (setsockopt (fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof (size)) < 0) {
+		if (setsockopt (fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof (size)) < 0) {
+			errsv = errno;
+			_LOGW ("netlink: failure to set receive buffer size to %d bytes: %s", size, g_strerror (errsv));
+			return FALSE;
+		}
+	}
+
+	_LOGD ("netlink: set receive buffer size to %d bytes (effective %d)", size, _netlink_get_rcvbuf (platform));
+	return TRUE;
+}
+
+static gboolean
+netlink_get_stats (NMPlatform *platform, NMPlatformNetlinkStats *out_stats)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+
+	*out_stats = priv->nl_stats;
+	out_stats->rcvbuf = _netlink_get_rcvbuf (platform);
+	out_stats->msgs_per_read_peak = priv->recv_ring->n_msgs_peak;
+	if (priv->nl_resync_start_ns) {
+		/* a resync is still ongoing. Account the time so far. */
+		out_stats->resync_total_usec += (nm_utils_get_monotonic_timestamp_ns () - priv->nl_resync_start_ns) / 1000;
+	}
+	return TRUE;
+}
+
 /*****************************************************************************/
 
 _NM_UTILS_LOOKUP_DEFINE (static, delayed_action_refresh_from_object_type, NMPObjectType, DelayedActionType,
@@ -3436,6 +3635,7 @@ NM_UTILS_LOOKUP_STR_DEFINE_STATIC (delayed_action_to_string, DelayedActionType,
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS,        "refresh-all-qdiscs"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS,      "refresh-all-tfilters"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_LINK,              "refresh-link"),
+	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_REFRESH_IFINDEX,           "refresh-ifindex"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_MASTER_CONNECTED,          "master-connected"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_READ_NETLINK,              "read-netlink"),
 	NM_UTILS_LOOKUP_STR_ITEM (DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE,      "wait-for-nl-response"),
@@ -3458,6 +3658,25 @@ delayed_action_to_string_full (DelayedActionType action_type, gpointer user_data
 	case DELAYED_ACTION_TYPE_REFRESH_LINK:
 		nm_utils_strbuf_append (&buf, &buf_size, " (ifindex %d)", GPOINTER_TO_INT (user_data));
 		break;
+	case DELAYED_ACTION_TYPE_REFRESH_IFINDEX: {
+		const DelayedActionRefreshIfindexData *refresh_data = user_data;
+		DelayedActionType iflags;
+		const char *sep = "";
+
+		if (!refresh_data) {
+			nm_utils_strbuf_append_str (&buf, &buf_size, " (any)");
+			break;
+		}
+		nm_utils_strbuf_append (&buf, &buf_size, " (ifindex %d:", refresh_data->ifindex);
+		FOR_EACH_DELAYED_ACTION (iflags, refresh_data->refresh_types) {
+			nm_utils_strbuf_append (&buf, &buf_size, "%s %s",
+			                        sep,
+			                        nmp_class_from_type (delayed_action_refresh_to_object_type (iflags))->obj_type_name);
+			sep = ",";
+		}
+		nm_utils_strbuf_append_str (&buf, &buf_size, ")");
+		break;
+	}
 	case DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE:
 		data = user_data;
 
@@ -3548,6 +3767,16 @@ delayed_action_wait_for_nl_response_complete (NMPlatform *platform,
 			data->response.out_route_get = NULL;
 		}
 		break;
+	case DELAYED_ACTION_RESPONSE_TYPE_REFRESH_IFINDEX:
+		if (!NM_IN_SET (seq_result, WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK,
+		                            WAIT_FOR_NL_RESPONSE_RESULT_FAILED_DISPOSING)) {
+			/* the filtered dump failed, so the objects that were marked dirty
+			 * for it are not trustworthy. Fall back to a full dump. */
+			delayed_action_schedule (platform,
+			                         (DelayedActionType) GPOINTER_TO_UINT (data->response.out_data),
+			                         NULL);
+		}
+		break;
 	}
 
 	g_array_remove_index_fast (priv->delayed_action.list_wait_for_nl_response, idx);
@@ -3599,6 +3828,12 @@ delayed_action_handle_REFRESH_LINK (NMPlatform *platform, int ifindex)
 	do_request_link_no_delayed_actions (platform, ifindex, NULL);
 }
 
+static void
+delayed_action_handle_REFRESH_IFINDEX (NMPlatform *platform, const DelayedActionRefreshIfindexData *data)
+{
+	do_request_ifindex_no_delayed_actions (platform, data->refresh_types, data->ifindex);
+}
+
 static void
 delayed_action_handle_REFRESH_ALL (NMPlatform *platform, DelayedActionType flags)
 {
@@ -3686,6 +3921,24 @@ delayed_action_handle_one (NMPlatform *platform)
 		return TRUE;
 	}
 
+	if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_IFINDEX)) {
+		DelayedActionRefreshIfindexData refresh_data;
+		GArray *list = priv->delayed_action.list_refresh_ifindex;
+
+		nm_assert (list->len > 0);
+
+		refresh_data = g_array_index (list, DelayedActionRefreshIfindexData, 0);
+		g_array_remove_index_fast (list, 0);
+		if (list->len == 0)
+			priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_IFINDEX;
+
+		_LOGt_delayed_action (DELAYED_ACTION_TYPE_REFRESH_IFINDEX, &refresh_data, "handle");
+
+		delayed_action_handle_REFRESH_IFINDEX (platform, &refresh_data);
+
+		return TRUE;
+	}
+
 	if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE)) {
 		nm_assert (priv->delayed_action.list_wait_for_nl_response->len > 0);
 		_LOGt_delayed_action (DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE, NULL, "handle");
@@ -3713,6 +3966,18 @@ delayed_action_handle_all (NMPlatform *platform, gboolean read_netlink)
 
 	cache_prune_all (platform);
 
+	if (   priv->nl_resync_start_ns
+	    && !NM_FLAGS_ANY (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_ALL)) {
+		gint64 usec;
+
+		usec = (nm_utils_get_monotonic_timestamp_ns () - priv->nl_resync_start_ns) / 1000;
+		priv->nl_resync_start_ns = 0;
+		priv->nl_stats.resync_last_usec = usec;
+		priv->nl_stats.resync_total_usec += usec;
+		_LOGD ("netlink: resynchronized platform cache in %"G_GINT64_FORMAT".%03d msec",
+		       usec / 1000, (int) (usec % 1000));
+	}
+
 	return any;
 }
 
@@ -3729,6 +3994,27 @@ delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gp
 		if (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_refresh_link->pdata, priv->delayed_action.list_refresh_link->len, user_data) < 0)
 			g_ptr_array_add (priv->delayed_action.list_refresh_link, user_data);
 		break;
+	case DELAYED_ACTION_TYPE_REFRESH_IFINDEX: {
+		const DelayedActionRefreshIfindexData *refresh_data = user_data;
+		GArray *list = priv->delayed_action.list_refresh_ifindex;
+		guint i;
+
+		nm_assert (refresh_data->ifindex > 0);
+		nm_assert (refresh_data->refresh_types != DELAYED_ACTION_TYPE_NONE);
+		nm_assert (!NM_FLAGS_ANY (refresh_data->refresh_types, ~DELAYED_ACTION_TYPE_REFRESH_ALL));
+
+		for (i = 0; i < list->len; i++) {
+			DelayedActionRefreshIfindexData *d = &g_array_index (list, DelayedActionRefreshIfindexData, i);
+
+			if (d->ifindex == refresh_data->ifindex) {
+				d->refresh_types |= refresh_data->refresh_types;
+				break;
+			}
+		}
+		if (i == list->len)
+			g_array_append_vals (list, refresh_data, 1);
+		break;
+	}
 	case DELAYED_ACTION_TYPE_MASTER_CONNECTED:
 		if (_nm_utils_ptrarray_find_first ((gconstpointer *) priv->delayed_action.list_master_connected->pdata, priv->delayed_action.list_master_connected->len, user_data) < 0)
 			g_ptr_array_add (priv->delayed_action.list_master_connected, user_data);
@@ -3739,6 +4025,7 @@ delayed_action_schedule (NMPlatform *platform, DelayedActionType action_type, gp
 	default:
 		nm_assert (!user_data);
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_REFRESH_LINK));
+		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_REFRESH_IFINDEX));
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_MASTER_CONNECTED));
 		nm_assert (!NM_FLAGS_HAS (action_type, DELAYED_ACTION_TYPE_WAIT_FOR_NL_RESPONSE));
 		break;
@@ -3773,6 +4060,36 @@ delayed_action_schedule_WAIT_FOR_NL_RESPONSE (NMPlatform *platform,
 	                         &data);
 }
 
+static void
+delayed_action_schedule_refresh_ifindex (NMPlatform *platform,
+                                         DelayedActionType refresh_types,
+                                         int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	DelayedActionRefreshIfindexData data = {
+		.ifindex = ifindex,
+		.refresh_types = refresh_types,
+	};
+
+	nm_assert (ifindex > 0);
+	nm_assert (!NM_FLAGS_ANY (refresh_types, ~(  DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES
+	                                           | DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES
+	                                           | DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES
+	                                           | DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES)));
+
+	if (!priv->nl_strict_check) {
+		/* without strict checking, kernel ignores the filter and would
+		 * dump all objects anyway. Just schedule a full refresh, which
+		 * can be coalesced with other refresh requests. */
+		delayed_action_schedule (platform, refresh_types, NULL);
+		return;
+	}
+
+	delayed_action_schedule (platform,
+	                         DELAYED_ACTION_TYPE_REFRESH_IFINDEX,
+	                         &data);
+}
+
 /*****************************************************************************/
 
 static void
@@ -3883,11 +4200,13 @@ cache_on_change (NMPlatform *platform,
 				ifindex = obj_new->link.ifindex;
 
 			if (ifindex > 0) {
+				delayed_action_schedule_refresh_ifindex (platform,
+				                                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
+				                                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES |
+				                                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
+				                                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
+				                                         ifindex);
 				delayed_action_schedule (platform,
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ADDRESSES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ADDRESSES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES |
 				                         DELAYED_ACTION_TYPE_REFRESH_ALL_QDISCS |
 				                         DELAYED_ACTION_TYPE_REFRESH_ALL_TFILTERS,
 				                         NULL);
@@ -3937,11 +4256,14 @@ cache_on_change (NMPlatform *platform,
 			            && !NM_FLAGS_HAS (obj_new->link.n_ifi_flags, IFF_LOWER_UP)))) {
 				/* FIXME: I suspect that IFF_LOWER_UP must not be considered, and I
 				 * think kernel does send RTM_DELROUTE events for IPv6 routes, so
-				 * we might not need to refresh IPv6 routes. */
-				delayed_action_schedule (platform,
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
-				                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
-				                         NULL);
+				 * we might not need to refresh IPv6 routes.
+				 *
+				 * Kernel only flushes the routes that have this link as outgoing
+				 * interface, so we only need to refresh those. */
+				delayed_action_schedule_refresh_ifindex (platform,
+				                                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP4_ROUTES |
+				                                         DELAYED_ACTION_TYPE_REFRESH_ALL_IP6_ROUTES,
+				                                         obj_new->link.ifindex);
 			}
 		}
 		if (   NM_IN_SET (cache_op, NMP_CACHE_OPS_ADDED, NMP_CACHE_OPS_UPDATED)
@@ -4210,9 +4532,7 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 
 	FOR_EACH_DELAYED_ACTION (iflags, action_type) {
 		NMPObjectType obj_type = delayed_action_refresh_to_object_type (iflags);
-		const NMPClass *klass = nmp_class_from_type (obj_type);
 		nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
-		int nle;
 		gint *out_refresh_all_in_progess;
 
 		out_refresh_all_in_progess = &priv->delayed_action.refresh_all_in_progess[delayed_action_refresh_all_to_idx (iflags)];
@@ -4227,32 +4547,30 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 			g_ptr_array_set_size (priv->delayed_action.list_refresh_link, 0);
 			_LOGt_delayed_action (DELAYED_ACTION_TYPE_REFRESH_LINK, NULL, "clear (do-request-all)");
 		}
+		if (NM_FLAGS_HAS (priv->delayed_action.flags, DELAYED_ACTION_TYPE_REFRESH_IFINDEX)) {
+			GArray *list = priv->delayed_action.list_refresh_ifindex;
+			guint i;
+
+			/* the full dump also covers the per-ifindex refreshes of this type. */
+			for (i = list->len; i > 0; i--) {
+				DelayedActionRefreshIfindexData *d = &g_array_index (list, DelayedActionRefreshIfindexData, i - 1);
+
+				d->refresh_types &= ~iflags;
+				if (d->refresh_types == DELAYED_ACTION_TYPE_NONE)
+					g_array_remove_index_fast (list, i - 1);
+			}
+			if (list->len == 0) {
+				priv->delayed_action.flags &= ~DELAYED_ACTION_TYPE_REFRESH_IFINDEX;
+				_LOGt_delayed_action (DELAYED_ACTION_TYPE_REFRESH_IFINDEX, NULL, "clear (do-request-all)");
+			}
+		}
 
 		event_handler_read_netlink (platform, FALSE);
 
-		/* reimplement
-		 *   nl_rtgen_request (sk, klass->rtm_gettype, klass->addr_family, NLM_F_DUMP);
-		 * because we need the sequence number.
-		 */
-		nlmsg = nlmsg_alloc_simple (klass->rtm_gettype, NLM_F_DUMP);
+		nlmsg = _nl_msg_new_dump (obj_type, priv->nl_strict_check, 0);
 		if (!nlmsg)
 			continue;
 
-		if (   klass->obj_type == NMP_OBJECT_TYPE_QDISC
-		    || klass->obj_type == NMP_OBJECT_TYPE_TFILTER) {
-			struct tcmsg tcmsg = {
-				.tcm_family = AF_UNSPEC,
-			};
-			nle = nlmsg_append (nlmsg, &tcmsg, sizeof (tcmsg), NLMSG_ALIGNTO);
-		} else {
-			struct rtgenmsg gmsg = {
-				.rtgen_family = klass->addr_family,
-			};
-			nle = nlmsg_append (nlmsg, &gmsg, sizeof (gmsg), NLMSG_ALIGNTO);
-		}
-		if (nle < 0)
-			continue;
-
 		if (_nl_send_nlmsg (platform, nlmsg, NULL, DELAYED_ACTION_RESPONSE_TYPE_REFRESH_ALL_IN_PROGRESS, out_refresh_all_in_progess) < 0) {
 			nm_assert (*out_refresh_all_in_progess > 0);
 			*out_refresh_all_in_progess -= 1;
@@ -4260,6 +4578,58 @@ do_request_all_no_delayed_actions (NMPlatform *platform, DelayedActionType actio
 	}
 }
 
+static void
+do_request_ifindex_no_delayed_actions (NMPlatform *platform, DelayedActionType action_type, int ifindex)
+{
+	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
+	NMPCache *cache = nm_platform_get_cache (platform);
+	const NMPObject *obj_link;
+	gboolean link_exists;
+	DelayedActionType iflags;
+
+	nm_assert (ifindex > 0);
+	nm_assert (priv->nl_strict_check);
+	nm_assert (!NM_FLAGS_ANY (action_type, ~DELAYED_ACTION_TYPE_REFRESH_ALL));
+
+	obj_link = nmp_cache_lookup_link (cache, ifindex);
+	link_exists = obj_link && obj_link->_link.netlink.is_in_netlink;
+
+	FOR_EACH_DELAYED_ACTION (iflags, action_type) {
+		NMPObjectType obj_type = delayed_action_refresh_to_object_type (iflags);
+		nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+		NMPLookup lookup;
+		int nle;
+
+		if (delayed_action_refresh_all_in_progress (platform, iflags)) {
+			/* a full dump is pending, which covers this interface too. */
+			continue;
+		}
+
+		priv->pruning[delayed_action_refresh_all_to_idx (iflags)] = TRUE;
+		nmp_cache_dirty_set_all_main (cache,
+		                              nmp_lookup_init_object (&lookup, obj_type, ifindex));
+
+		if (!link_exists) {
+			/* the link is gone, and with it all its addresses and routes.
+			 * There is nothing to dump, just prune what we have. */
+			continue;
+		}
+
+		event_handler_read_netlink (platform, FALSE);
+
+		nlmsg = _nl_msg_new_dump (obj_type, TRUE, ifindex);
+		if (!nlmsg)
+			continue;
+
+		nle = _nl_send_nlmsg (platform, nlmsg, NULL, DELAYED_ACTION_RESPONSE_TYPE_REFRESH_IFINDEX, GUINT_TO_POINTER (iflags));
+		if (nle < 0) {
+			_LOGE ("do-request-ifindex: %d: failed sending netlink request \"%s\" (%d)",
+			       ifindex, nl_geterror (nle), -nle);
+			delayed_action_schedule (platform, iflags, NULL);
+		}
+	}
+}
+
 static void
 do_request_one_type (NMPlatform *platform, NMPObjectType obj_type)
 {
@@ -4334,22 +4704,19 @@ event_seq_check (NMPlatform *platform, guint32 seq_number, WaitForNlResponseResu
 }
 
 static void
-event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_events)
+event_valid_msg (NMPlatform *platform, struct nlmsghdr *msghdr, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv;
 	nm_auto_nmpobj NMPObject *obj = NULL;
 	NMPCacheOpsType cache_op;
-	struct nlmsghdr *msghdr;
 	char buf_nlmsghdr[400];
 	gboolean id_only = FALSE;
 	NMPCache *cache = nm_platform_get_cache (platform);
 	gboolean is_dump;
 
-	msghdr = nlmsg_hdr (msg);
-
 	if (   _support_kernel_extended_ifa_flags_still_undecided ()
 	    && msghdr->nlmsg_type == RTM_NEWADDR)
-		_support_kernel_extended_ifa_flags_detect (msg);
+		_support_kernel_extended_ifa_flags_detect (msghdr);
 
 	if (!handle_events)
 		return;
@@ -4360,7 +4727,7 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 		id_only = TRUE;
 	}
 
-	obj = nmp_object_new_from_nl (platform, cache, msg, id_only);
+	obj = nmp_object_new_from_nl (platform, cache, msghdr, id_only);
 	if (!obj) {
 		_LOGT ("event-notification: %s: ignore",
 		       _nl_nlmsghdr_to_str (msghdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
@@ -4424,7 +4791,7 @@ event_valid_msg (NMPlatform *platform, struct nl_msg *msg, gboolean handle_event
 						if (   data->response_type == DELAYED_ACTION_RESPONSE_TYPE_ROUTE_GET
 						    && data->response.out_route_get) {
 							nm_assert (!*data->response.out_route_get);
-							if (data->seq_number == nlmsg_hdr (msg)->nlmsg_seq) {
+							if (data->seq_number == msghdr->nlmsg_seq) {
 								*data->response.out_route_get = nmp_object_clone (obj, FALSE);
 								data->response.out_route_get = NULL;
 								break;
@@ -4552,6 +4919,95 @@ do_add_link_with_lookup (NMPlatform *platform,
 	return seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
 }
 
+static void
+_do_add_addrroute_log (NMPlatform *platform,
+                       const NMPObject *obj_id,
+                       WaitForNlResponseResult seq_result,
+                       gboolean suppress_netlink_failure)
+{
+	char s_buf[256];
+
+	_NMLOG ((   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
+	         || (   suppress_netlink_failure
+	             && seq_result < 0))
+	            ? LOGL_DEBUG
+	            : LOGL_WARN,
+	        "do-add-%s[%s]: %s",
+	        NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
+	        nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+}
+
+static gboolean
+_do_add_addrroute_needs_refetch (NMPlatform *platform,
+                                 const NMPObject *obj_id)
+{
+	if (NMP_OBJECT_GET_TYPE (obj_id) != NMP_OBJECT_TYPE_IP6_ADDRESS)
+		return FALSE;
+
+	/* In rare cases, the object is not yet ready as we received the ACK from
+	 * kernel. Need to refetch.
+	 *
+	 * We want to safe the expensive refetch, thus we look first into the cache
+	 * whether the object exists.
+	 *
+	 * rh#1484434 */
+	return !nmp_cache_lookup_obj (nm_platform_get_cache (platform), obj_id);
+}
+
+static gboolean
+_do_delete_object_log (NMPlatform *platform,
+                       const NMPObject *obj_id,
+                       WaitForNlResponseResult seq_result)
+{
+	char s_buf[256];
+	gboolean success;
+	const char *log_detail = "";
+
+	success = TRUE;
+	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
+		/* ok */
+	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT))
+		log_detail = ", meaning the object was already removed";
+	else if (   NM_IN_SET (-((int) seq_result), ENXIO)
+	         && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
+		/* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
+		log_detail = ", meaning the address was already removed";
+	} else if (   NM_IN_SET (-((int) seq_result), EADDRNOTAVAIL)
+	           && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS))
+		log_detail = ", meaning the address was already removed";
+	else
+		success = FALSE;
+
+	_NMLOG (success ? LOGL_DEBUG : LOGL_WARN,
+	        "do-delete-%s[%s]: %s%s",
+	        NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
+	        nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)),
+	        log_detail);
+	return success;
+}
+
+static gboolean
+_do_delete_object_needs_refetch (NMPlatform *platform,
+                                 const NMPObject *obj_id)
+{
+	if (!NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
+	                NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                NMP_OBJECT_TYPE_QDISC,
+	                NMP_OBJECT_TYPE_TFILTER))
+		return FALSE;
+
+	/* In rare cases, the object is still there after we receive the ACK from
+	 * kernel. Need to refetch.
+	 *
+	 * We want to safe the expensive refetch, thus we look first into the cache
+	 * whether the object exists.
+	 *
+	 * rh#1484434 */
+	return !!nmp_cache_lookup_obj (nm_platform_get_cache (platform), obj_id);
+}
+
 static NMPlatformError
 do_add_addrroute (NMPlatform *platform,
                   const NMPObject *obj_id,
@@ -4560,7 +5016,6 @@ do_add_addrroute (NMPlatform *platform,
 {
 	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
 	int nle;
-	char s_buf[256];
 
 	nm_assert (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
 	                      NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS,
@@ -4581,27 +5036,10 @@ do_add_addrroute (NMPlatform *platform,
 
 	nm_assert (seq_result);
 
-	_NMLOG ((   seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK
-	         || (   suppress_netlink_failure
-	             && seq_result < 0))
-	            ? LOGL_DEBUG
-	            : LOGL_WARN,
-	        "do-add-%s[%s]: %s",
-	        NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
-	        nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
-	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)));
+	_do_add_addrroute_log (platform, obj_id, seq_result, suppress_netlink_failure);
 
-	if (NMP_OBJECT_GET_TYPE (obj_id) == NMP_OBJECT_TYPE_IP6_ADDRESS) {
-		/* In rare cases, the object is not yet ready as we received the ACK from
-		 * kernel. Need to refetch.
-		 *
-		 * We want to safe the expensive refetch, thus we look first into the cache
-		 * whether the object exists.
-		 *
-		 * rh#1484434 */
-		if (!nmp_cache_lookup_obj (nm_platform_get_cache (platform), obj_id))
-			do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
-	}
+	if (_do_add_addrroute_needs_refetch (platform, obj_id))
+		do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
 
 	return wait_for_nl_response_to_plerr (seq_result);
 }
@@ -4611,9 +5049,7 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 {
 	WaitForNlResponseResult seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
 	int nle;
-	char s_buf[256];
 	gboolean success;
-	const char *log_detail = "";
 
 	event_handler_read_netlink (platform, FALSE);
 
@@ -4630,42 +5066,10 @@ do_delete_object (NMPlatform *platform, const NMPObject *obj_id, struct nl_msg *
 
 	nm_assert (seq_result);
 
-	success = TRUE;
-	if (seq_result == WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK) {
-		/* ok */
-	} else if (NM_IN_SET (-((int) seq_result), ESRCH, ENOENT))
-		log_detail = ", meaning the object was already removed";
-	else if (   NM_IN_SET (-((int) seq_result), ENXIO)
-	         && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP6_ADDRESS)) {
-		/* On RHEL7 kernel, deleting a non existing address fails with ENXIO */
-		log_detail = ", meaning the address was already removed";
-	} else if (   NM_IN_SET (-((int) seq_result), EADDRNOTAVAIL)
-	           && NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id), NMP_OBJECT_TYPE_IP4_ADDRESS, NMP_OBJECT_TYPE_IP6_ADDRESS))
-		log_detail = ", meaning the address was already removed";
-	else
-		success = FALSE;
-
-	_NMLOG (success ? LOGL_DEBUG : LOGL_WARN,
-	        "do-delete-%s[%s]: %s%s",
-	        NMP_OBJECT_GET_CLASS (obj_id)->obj_type_name,
-	        nmp_object_to_string (obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
-	        wait_for_nl_response_to_string (seq_result, s_buf, sizeof (s_buf)),
-	        log_detail);
+	success = _do_delete_object_log (platform, obj_id, seq_result);
 
-	if (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj_id),
-	               NMP_OBJECT_TYPE_IP6_ADDRESS,
-	               NMP_OBJECT_TYPE_QDISC,
-	               NMP_OBJECT_TYPE_TFILTER)) {
-		/* In rare cases, the object is still there after we receive the ACK from
-		 * kernel. Need to refetch.
-		 *
-		 * We want to safe the expensive refetch, thus we look first into the cache
-		 * whether the object exists.
-		 *
-		 * rh#1484434 */
-		if (nmp_cache_lookup_obj (nm_platform_get_cache (platform), obj_id))
-			do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
-	}
+	if (_do_delete_object_needs_refetch (platform, obj_id))
+		do_request_one_type (platform, NMP_OBJECT_GET_TYPE (obj_id));
 
 	return success;
 }
@@ -6383,6 +6787,190 @@ object_delete (NMPlatform *platform,
 
 /*****************************************************************************/
 
+/* the maximum number of requests of a batch that we send before
+ * waiting for the responses. */
+#define BATCH_IN_FLIGHT_MAX 128
+
+typedef struct {
+	WaitForNlResponseResult seq_result;
+	bool sent:1;
+
+	/* the object as it is used for logging and for the cache lookup
+	 * after completion. For added routes, that is the normalized route. */
+	NMPObject obj_id;
+} BatchInFlight;
+
+static struct nl_msg *
+_nl_msg_new_batch_op (const NMPlatformBatchOp *op,
+                      NMPObject *obj_id)
+{
+	const NMPObject *obj = op->obj;
+
+	switch (NMP_OBJECT_GET_TYPE (obj)) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: {
+		const NMPlatformIP4Address *a = NMP_OBJECT_CAST_IP4_ADDRESS (obj);
+
+		nmp_object_stackinit_id_ip4_address (obj_id, a->ifindex, a->address, a->plen, a->peer_address);
+		if (op->is_delete) {
+			return _nl_msg_new_address (RTM_DELADDR,
+			                            0,
+			                            AF_INET,
+			                            a->ifindex,
+			                            &a->address,
+			                            a->plen,
+			                            &a->peer_address,
+			                            0,
+			                            RT_SCOPE_NOWHERE,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NULL);
+		}
+		return _nl_msg_new_address (RTM_NEWADDR,
+		                            NLM_F_CREATE | NLM_F_REPLACE,
+		                            AF_INET,
+		                            a->ifindex,
+		                            &a->address,
+		                            a->plen,
+		                            &a->peer_address,
+		                            a->n_ifa_flags,
+		                            nm_utils_ip4_address_is_link_local (a->address) ? RT_SCOPE_LINK : RT_SCOPE_UNIVERSE,
+		                            a->lifetime,
+		                            a->preferred,
+		                            a->label[0] ? a->label : NULL);
+	}
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+		const NMPlatformIP6Address *a = NMP_OBJECT_CAST_IP6_ADDRESS (obj);
+
+		nmp_object_stackinit_id_ip6_address (obj_id, a->ifindex, &a->address);
+		if (op->is_delete) {
+			return _nl_msg_new_address (RTM_DELADDR,
+			                            0,
+			                            AF_INET6,
+			                            a->ifindex,
+			                            &a->address,
+			                            a->plen,
+			                            NULL,
+			                            0,
+			                            RT_SCOPE_NOWHERE,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NM_PLATFORM_LIFETIME_PERMANENT,
+			                            NULL);
+		}
+		return _nl_msg_new_address (RTM_NEWADDR,
+		                            NLM_F_CREATE | NLM_F_REPLACE,
+		                            AF_INET6,
+		                            a->ifindex,
+		                            &a->address,
+		                            a->plen,
+		                            &a->peer_address,
+		                            a->n_ifa_flags,
+		                            RT_SCOPE_UNIVERSE,
+		                            a->lifetime,
+		                            a->preferred,
+		                            NULL);
+	}
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		nmp_object_stackinit (obj_id, NMP_OBJECT_GET_TYPE (obj), &obj->object);
+		if (op->is_delete)
+			return _nl_msg_new_route (RTM_DELROUTE, 0, obj_id);
+		nm_platform_ip_route_normalize (NMP_OBJECT_GET_TYPE (obj) == NMP_OBJECT_TYPE_IP4_ROUTE ? AF_INET : AF_INET6,
+		                                NMP_OBJECT_CAST_IP_ROUTE (obj_id));
+		return _nl_msg_new_route (RTM_NEWROUTE, op->flags & NMP_NLM_FLAG_FMASK, obj_id);
+	default:
+		break;
+	}
+	g_return_val_if_reached (NULL);
+}
+
+static void
+batch_commit (NMPlatform *platform,
+              NMPlatformBatchOp *ops,
+              guint n_ops)
+{
+	gs_free BatchInFlight *in_flight = NULL;
+	gboolean refetch_ip6_address = FALSE;
+	guint i_start, n_chunk, i;
+
+	nm_assert (ops);
+	nm_assert (n_ops > 0);
+
+	in_flight = g_new (BatchInFlight, MIN (n_ops, BATCH_IN_FLIGHT_MAX));
+
+	/* Send the requests back to back and only then wait for all the
+	 * ACKs, instead of waiting for the response of each request
+	 * before sending the next one. Kernel processes the messages
+	 * in order, so the semantics are the same as for sending them
+	 * one by one. */
+	for (i_start = 0; i_start < n_ops; i_start += n_chunk) {
+		n_chunk = MIN (n_ops - i_start, BATCH_IN_FLIGHT_MAX);
+
+		event_handler_read_netlink (platform, FALSE);
+
+		for (i = 0; i < n_chunk; i++) {
+			NMPlatformBatchOp *op = &ops[i_start + i];
+			BatchInFlight *f = &in_flight[i];
+			nm_auto_nlmsg struct nl_msg *nlmsg = NULL;
+			int nle;
+
+			f->seq_result = WAIT_FOR_NL_RESPONSE_RESULT_UNKNOWN;
+			f->sent = FALSE;
+
+			nlmsg = _nl_msg_new_batch_op (op, &f->obj_id);
+			if (!nlmsg) {
+				op->result = NM_PLATFORM_ERROR_BUG;
+				continue;
+			}
+
+			nle = _nl_send_nlmsg (platform, nlmsg, &f->seq_result, DELAYED_ACTION_RESPONSE_TYPE_VOID, NULL);
+			if (nle < 0) {
+				_LOGE ("do-%s-%s[%s]: failure sending netlink request \"%s\" (%d)",
+				       op->is_delete ? "delete" : "add",
+				       NMP_OBJECT_GET_CLASS (&f->obj_id)->obj_type_name,
+				       nmp_object_to_string (&f->obj_id, NMP_OBJECT_TO_STRING_ID, NULL, 0),
+				       nl_geterror (nle), -nle);
+				op->result = op->is_delete
+				             ? NM_PLATFORM_ERROR_UNSPECIFIED
+				             : NM_PLATFORM_ERROR_NETLINK;
+				continue;
+			}
+			f->sent = TRUE;
+		}
+
+		delayed_action_handle_all (platform, FALSE);
+
+		for (i = 0; i < n_chunk; i++) {
+			NMPlatformBatchOp *op = &ops[i_start + i];
+			BatchInFlight *f = &in_flight[i];
+
+			if (!f->sent)
+				continue;
+
+			nm_assert (f->seq_result);
+
+			if (op->is_delete) {
+				op->result =   _do_delete_object_log (platform, &f->obj_id, f->seq_result)
+				             ? NM_PLATFORM_ERROR_SUCCESS
+				             : NM_PLATFORM_ERROR_UNSPECIFIED;
+				if (_do_delete_object_needs_refetch (platform, &f->obj_id))
+					refetch_ip6_address = TRUE;
+			} else {
+				_do_add_addrroute_log (platform, &f->obj_id, f->seq_result,
+				                       NM_FLAGS_HAS (op->flags, NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE));
+				op->result = wait_for_nl_response_to_plerr (f->seq_result);
+				if (_do_add_addrroute_needs_refetch (platform, &f->obj_id))
+					refetch_ip6_address = TRUE;
+			}
+		}
+	}
+
+	/* For the batch, we only refetch once. Only IPv6 addresses need that. */
+	if (refetch_ip6_address)
+		do_request_one_type (platform, NMP_OBJECT_TYPE_IP6_ADDRESS);
+}
+
+/*****************************************************************************/
+
 static NMPlatformError
 ip_route_get (NMPlatform *platform,
               int addr_family,
@@ -6555,99 +7143,189 @@ event_handler (GIOChannel *channel,
 
 /*****************************************************************************/
 
-/* copied from libnl3's recvmsgs() */
+static NlRecvRing *
+_nl_recv_ring_new (void)
+{
+	NlRecvRing *ring;
+
+	ring = g_slice_new0 (NlRecvRing);
+	ring->buf_size_next = NL_RECV_RING_BUF_SIZE_INIT;
+	return ring;
+}
+
+static void
+_nl_recv_ring_free (NlRecvRing *ring)
+{
+	nm_assert (ring);
+	nm_assert (ring->busy == 0);
+	nm_assert (!ring->bufs_stale);
+
+	g_free (ring->bufs);
+	g_slice_free (NlRecvRing, ring);
+}
+
+static int
+_nl_recv_ring_refill (NlRecvRing *ring, int fd)
+{
+	guint i;
+	int n;
+	int errsv;
+
+	nm_assert (ring->idx >= ring->n_msgs);
+
+	ring->n_msgs = 0;
+	ring->idx = 0;
+
+	if (   ring->busy > 1
+	    && ring->bufs) {
+		/* an outer event_handler_recvmsgs() call still references the buffers. */
+		ring->bufs_stale = g_slist_prepend (ring->bufs_stale, ring->bufs);
+		ring->bufs = NULL;
+	}
+
+	if (   !ring->bufs
+	    || ring->buf_size != ring->buf_size_next) {
+		g_free (ring->bufs);
+		ring->buf_size = ring->buf_size_next;
+		ring->bufs = g_malloc (ring->buf_size * NL_RECV_RING_SIZE);
+	}
+
+	for (i = 0; i < NL_RECV_RING_SIZE; i++) {
+		ring->iovs[i].iov_base = &ring->bufs[i * ring->buf_size];
+		ring->iovs[i].iov_len = ring->buf_size;
+		ring->msgs[i].msg_hdr = (struct msghdr) {
+			.msg_iov = &ring->iovs[i],
+			.msg_iovlen = 1,
+			.msg_control = &ring->cmsgs[i],
+			.msg_controllen = sizeof (ring->cmsgs[i]),
+		};
+		ring->msgs[i].msg_len = 0;
+	}
+
+again:
+	n = recvmmsg (fd, ring->msgs, NL_RECV_RING_SIZE, 0, NULL);
+	if (n < 0) {
+		errsv = errno;
+		if (errsv == EINTR)
+			goto again;
+		if (errsv == EAGAIN) {
+			G_STATIC_ASSERT (EAGAIN == EWOULDBLOCK);
+			return -NLE_AGAIN;
+		}
+		if (errsv == ENOBUFS) {
+			/* we are very much interested in a overrun of the receive buffer.
+			 * Hack our own return code to signal the overrun. */
+			return -_NLE_NM_NOBUFS;
+		}
+		return -nl_syserr2nlerr (errsv);
+	}
+	if (n == 0)
+		return -NLE_AGAIN;
+
+	ring->n_msgs = n;
+	ring->n_msgs_peak = MAX (ring->n_msgs_peak, (guint) n);
+	return 0;
+}
+
+/**
+ * _nl_recv_ring_next:
+ * @ring: the receive ring
+ * @fd: the netlink socket
+ * @out_hdr: (out): the first netlink message in the datagram. It points
+ *   into the receive ring and is only valid until the next call.
+ * @out_creds: (out): the credentials of the sender. They are copied,
+ *   because nested calls may refill the ring while the caller still
+ *   processes the datagram.
+ * @out_creds_has: (out): whether the datagram carried credentials.
+ *
+ * Returns: the length of the datagram or a negative libnl3 error code.
+ *   -NLE_MSG_TRUNC means that the datagram was lost because the receive
+ *   buffer was too small.
+ */
+static int
+_nl_recv_ring_next (NlRecvRing *ring,
+                    int fd,
+                    struct nlmsghdr **out_hdr,
+                    struct ucred *out_creds,
+                    gboolean *out_creds_has)
+{
+	struct mmsghdr *m;
+	struct cmsghdr *cmsg;
+	int nle;
+
+	if (ring->idx >= ring->n_msgs) {
+		nle = _nl_recv_ring_refill (ring, fd);
+		if (nle < 0)
+			return nle;
+	}
+
+	m = &ring->msgs[ring->idx++];
+
+	if (NM_FLAGS_HAS (m->msg_hdr.msg_flags, MSG_TRUNC))
+		return -NLE_MSG_TRUNC;
+
+	*out_creds_has = FALSE;
+	for (cmsg = CMSG_FIRSTHDR (&m->msg_hdr); cmsg; cmsg = CMSG_NXTHDR (&m->msg_hdr, cmsg)) {
+		if (   cmsg->cmsg_level == SOL_SOCKET
+		    && cmsg->cmsg_type == SCM_CREDENTIALS) {
+			memcpy (out_creds, CMSG_DATA (cmsg), sizeof (*out_creds));
+			*out_creds_has = TRUE;
+			break;
+		}
+	}
+
+	*out_hdr = m->msg_hdr.msg_iov[0].iov_base;
+	return m->msg_len;
+}
+
+/* based on libnl3's recvmsgs(), but parses the messages in-place from
+ * the receive ring instead of converting them to struct nl_msg. */
 static int
 event_handler_recvmsgs (NMPlatform *platform, gboolean handle_events)
 {
 	NMLinuxPlatformPrivate *priv = NM_LINUX_PLATFORM_GET_PRIVATE (platform);
-	struct nl_sock *sk = priv->nlh;
+	NlRecvRing *ring = priv->recv_ring;
+	int fd = nl_socket_get_fd (priv->nlh);
 	int n, err = 0, multipart = 0, interrupted = 0;
 	struct nlmsghdr *hdr;
+	struct ucred creds;
+	gboolean creds_has;
 	WaitForNlResponseResult seq_result;
 
-	/*
-	nla is passed on to not only to nl_recv() but may also be passed
-	to a function pointer provided by the caller which may or may not
-	initialize the variable. Thomas Graf.
-	*/
-	struct sockaddr_nl nla = {0};
-	nm_auto_free struct ucred *creds = NULL;
-	nm_auto_free unsigned char *buf = NULL;
+	ring->busy++;
 
 continue_reading:
-	g_clear_pointer (&buf, free);
-	g_clear_pointer (&creds, free);
-	errno = 0;
-	n = nl_recv (sk, &nla, &buf, &creds);
-
-	if (n <= 0) {
-		/* workaround libnl3 <= 3.2.15 returning danling pointers in case nl_recv()
-		 * fails. Fixed by libnl3 69468517d0de1675d80f24661ff57a5dbac7275c. */
-		buf = NULL;
-		creds = NULL;
-	}
-
-	switch (n) {
-	case 0:
-		/* Work around a libnl bug fixed in 3.2.22 (375a6294) */
-		if (errno == EAGAIN) {
-			/* EAGAIN is equal to EWOULDBLOCK. If it would not be, we'd have to
-			 * workaround libnl3 mapping EWOULDBLOCK to -NLE_FAILURE. */
-			G_STATIC_ASSERT (EAGAIN == EWOULDBLOCK);
-			n = -NLE_AGAIN;
-		}
-		break;
-	case -NLE_MSG_TRUNC: {
-		int buf_size;
+	hdr = NULL;
+	creds_has = FALSE;
+	n = _nl_recv_ring_next (ring, fd, &hdr, &creds, &creds_has);
 
+	if (n == -NLE_MSG_TRUNC) {
 		/* the message receive buffer was too small. We lost one message, which
 		 * is unfortunate. Try to double the buffer size for the next time. */
-		buf_size = nl_socket_get_msg_buf_size (sk);
-		if (buf_size < 512*1024) {
-			buf_size *= 2;
-			_LOGT ("netlink: recvmsg: increase message buffer size for recvmsg() to %d bytes", buf_size);
-			if (nl_socket_set_msg_buf_size (sk, buf_size) < 0)
-				nm_assert_not_reached ();
+		if (ring->buf_size_next < NL_RECV_RING_BUF_SIZE_MAX) {
+			ring->buf_size_next *= 2;
+			priv->nl_stats.buf_grows++;
+			_LOGT ("netlink: recvmsg: increase message buffer size for recvmmsg() to %u bytes", (guint) ring->buf_size_next);
 			if (!handle_events)
 				goto continue_reading;
 		}
 		n = -_NLE_MSG_TRUNC;
-		break;
-	}
-	case -NLE_NOMEM:
-		if (errno == ENOBUFS) {
-			/* we are very much interested in a overrun of the receive buffer.
-			 * nl_recv() maps all kinds of errors to NLE_NOMEM, so check also
-			 * for errno explicitly. And if so, hack our own return code to signal
-			 * the overrun. */
-			n = -_NLE_NM_NOBUFS;
-		}
-		break;
 	}
 
-	if (n <= 0)
-		return n;
+	if (n <= 0) {
+		err = n;
+		goto out_unbusy;
+	}
 
-	hdr = (struct nlmsghdr *) buf;
 	while (nlmsg_ok (hdr, n)) {
-		nm_auto_nlmsg struct nl_msg *msg = NULL;
 		gboolean abort_parsing = FALSE;
 		gboolean process_valid_msg = FALSE;
 		guint32 seq_number;
 		char buf_nlmsghdr[400];
 
-		msg = nlmsg_convert (hdr);
-		if (!msg) {
-			err = -NLE_NOMEM;
-			goto out;
-		}
-
-		nlmsg_set_proto (msg, NETLINK_ROUTE);
-		nlmsg_set_src (msg, &nla);
-
-		if (!creds || creds->pid) {
-			if (creds)
-				_LOGT ("netlink: recvmsg: received non-kernel message (pid %d)", creds->pid);
+		if (!creds_has || creds.pid) {
+			if (creds_has)
+				_LOGT ("netlink: recvmsg: received non-kernel message (pid %d)", creds.pid);
 			else
 				_LOGT ("netlink: recvmsg: received message without credentials");
 			err = 0;
@@ -6657,9 +7335,6 @@ continue_reading:
 		_LOGt ("netlink: recvmsg: new message %s",
 		       _nl_nlmsghdr_to_str (hdr, buf_nlmsghdr, sizeof (buf_nlmsghdr)));
 
-		if (creds)
-			nlmsg_set_creds (msg, creds);
-
 		if (hdr->nlmsg_flags & NLM_F_MULTI)
 			multipart = 1;
 
@@ -6715,14 +7390,14 @@ continue_reading:
 				_LOGD ("netlink: recvmsg: error message from kernel: %s (%d) for request %d",
 				       strerror (errsv),
 				       errsv,
-				       nlmsg_hdr (msg)->nlmsg_seq);
+				       hdr->nlmsg_seq);
 				seq_result = -errsv;
 			} else
 				seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
 		} else
 			process_valid_msg = TRUE;
 
-		seq_number = nlmsg_hdr (msg)->nlmsg_seq;
+		seq_number = hdr->nlmsg_seq;
 
 		/* check whether the seq number is different from before, and
 		 * whether the previous number (@nlh_seq_last_seen) is a pending
@@ -6738,7 +7413,7 @@ continue_reading:
 			 * get along with broken kernels. NL_SKIP has no
 			 * effect on this.  */
 
-			event_valid_msg (platform, msg, handle_events);
+			event_valid_msg (platform, hdr, handle_events);
 
 			seq_result = WAIT_FOR_NL_RESPONSE_RESULT_RESPONSE_OK;
 		}
@@ -6763,9 +7438,12 @@ stop:
 		 * Repeat reading. */
 		goto continue_reading;
 	}
-out:
 	if (interrupted)
 		err = -NLE_DUMP_INTR;
+out_unbusy:
+	if (   --ring->busy == 0
+	    && ring->bufs_stale)
+		g_slist_free_full (g_steal_pointer (&ring->bufs_stale), g_free);
 	return err;
 }
 
@@ -6814,6 +7492,11 @@ event_handler_read_netlink (NMPlatform *platform, gboolean wait_for_acks)
 					            }
 					            _reason;
 					       }));
+					if (nle == -_NLE_NM_NOBUFS)
+						priv->nl_stats.nobufs++;
+					priv->nl_stats.resyncs++;
+					if (!priv->nl_resync_start_ns)
+						priv->nl_resync_start_ns = nm_utils_get_monotonic_timestamp_ns ();
 					event_handler_recvmsgs (platform, FALSE);
 					delayed_action_wait_for_nl_response_complete_all (platform, WAIT_FOR_NL_RESPONSE_RESULT_FAILED_RESYNC);
 					delayed_action_schedule (platform,
@@ -7026,6 +7709,7 @@ nm_linux_platform_init (NMLinuxPlatform *self)
 	priv->nlh_seq_next = 1;
 	priv->delayed_action.list_master_connected = g_ptr_array_new ();
 	priv->delayed_action.list_refresh_link = g_ptr_array_new ();
+	priv->delayed_action.list_refresh_ifindex = g_array_new (FALSE, FALSE, sizeof (DelayedActionRefreshIfindexData));
 	priv->delayed_action.list_wait_for_nl_response = g_array_new (FALSE, TRUE, sizeof (DelayedActionWaitForNlResponseData));
 	priv->wifi_data = g_hash_table_new_full (nm_direct_hash, NULL, NULL, (GDestroyNotify) wifi_utils_unref);
 }
@@ -7038,6 +7722,7 @@ constructed (GObject *_object)
 	int channel_flags;
 	gboolean status;
 	int nle;
+	const int one = 1;
 
 	nm_assert (!platform->_netns || platform->_netns == nmp_netns_get_current ());
 
@@ -7065,6 +7750,15 @@ constructed (GObject *_object)
 	nle = nl_socket_set_passcred (priv->nlh, 1);
 	g_assert (!nle);
 
+	/* With strict checking (kernel 4.20+), kernel validates our requests
+	 * and honors filters in dump requests. That allows us to refresh the
+	 * addresses and routes of one interface, instead of all of them. */
+	priv->nl_strict_check = (setsockopt (nl_socket_get_fd (priv->nlh),
+	                                     SOL_NETLINK,
+	                                     NETLINK_GET_STRICT_CHK,
+	                                     &one,
+	                                     sizeof (one)) == 0);
+
 	/* No blocking for event socket, so that we can drain it safely. */
 	nle = nl_socket_set_nonblocking (priv->nlh);
 	g_assert (!nle);
@@ -7073,11 +7767,10 @@ constructed (GObject *_object)
 	nle = nl_socket_set_buffer_size (priv->nlh, 8*1024*1024, 0);
 	g_assert (!nle);
 
-	/* explicitly set the msg buffer size and disable MSG_PEEK.
-	 * If we later encounter NLE_MSG_TRUNC, we will adjust the buffer size. */
-	nl_socket_disable_msg_peek (priv->nlh);
-	nle = nl_socket_set_msg_buf_size (priv->nlh, 32 * 1024);
-	g_assert (!nle);
+	/* we don't use libnl3's nl_recv() but receive the messages via recvmmsg()
+	 * into our own ring of buffers. If we later encounter NLE_MSG_TRUNC,
+	 * we will adjust the buffer size. */
+	priv->recv_ring = _nl_recv_ring_new ();
 
 	nle = nl_socket_add_memberships (priv->nlh,
 	                                 RTNLGRP_LINK,
@@ -7086,7 +7779,8 @@ constructed (GObject *_object)
 	                                 RTNLGRP_TC,
 	                                 0);
 	g_assert (!nle);
-	_LOGD ("Netlink socket for events established: port=%u, fd=%d", nl_socket_get_local_port (priv->nlh), nl_socket_get_fd (priv->nlh));
+	_LOGD ("Netlink socket for events established: port=%u, fd=%d%s", nl_socket_get_local_port (priv->nlh), nl_socket_get_fd (priv->nlh),
+	       priv->nl_strict_check ? ", strict checking" : "");
 
 	priv->event_channel = g_io_channel_unix_new (nl_socket_get_fd (priv->nlh));
 	g_io_channel_set_encoding (priv->event_channel, NULL, NULL);
@@ -7157,6 +7851,7 @@ dispose (GObject *object)
 	priv->delayed_action.flags = DELAYED_ACTION_TYPE_NONE;
 	g_ptr_array_set_size (priv->delayed_action.list_master_connected, 0);
 	g_ptr_array_set_size (priv->delayed_action.list_refresh_link, 0);
+	g_array_set_size (priv->delayed_action.list_refresh_ifindex, 0);
 
 	G_OBJECT_CLASS (nm_linux_platform_parent_class)->dispose (object);
 }
@@ -7168,11 +7863,13 @@ finalize (GObject *object)
 
 	g_ptr_array_unref (priv->delayed_action.list_master_connected);
 	g_ptr_array_unref (priv->delayed_action.list_refresh_link);
+	g_array_unref (priv->delayed_action.list_refresh_ifindex);
 	g_array_unref (priv->delayed_action.list_wait_for_nl_response);
 
 	g_source_remove (priv->event_id);
 	g_io_channel_unref (priv->event_channel);
 	nl_socket_free (priv->nlh);
+	_nl_recv_ring_free (priv->recv_ring);
 
 	g_hash_table_unref (priv->wifi_data);
 
@@ -7275,6 +7972,7 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->ip6_address_delete = ip6_address_delete;
 
 	platform_class->ip_route_add = ip_route_add;
+	platform_class->batch_commit = batch_commit;
 	platform_class->ip_route_get = ip_route_get;
 
 	platform_class->qdisc_add = qdisc_add;
@@ -7283,5 +7981,7 @@ nm_linux_platform_class_init (NMLinuxPlatformClass *klass)
 	platform_class->check_kernel_support = check_kernel_support;
 
 	platform_class->process_events = process_events;
+	platform_class->netlink_set_rcvbuf = netlink_set_rcvbuf;
+	platform_class->netlink_get_stats = netlink_get_stats;
 }
 
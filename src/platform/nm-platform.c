@@ -100,6 +100,9 @@ typedef struct _NMPlatformPrivate {
 	GHashTable *ip4_dev_route_blacklist_hash;
 	NMDedupMultiIndex *multi_idx;
 	NMPCache *cache;
+
+	bool batch_active:1;
+	GArray *batch_ops;
 } NMPlatformPrivate;
 
 G_DEFINE_TYPE (NMPlatform, nm_platform, G_TYPE_OBJECT)
@@ -353,6 +356,51 @@ nm_platform_process_events (NMPlatform *self)
 		klass->process_events (self);
 }
 
+/**
+ * nm_platform_netlink_set_rcvbuf:
+ * @self: platform instance
+ * @size: the requested size of the receive buffer in bytes
+ *
+ * Set the size of the kernel receive queue of the netlink event
+ * socket. A larger buffer makes overruns during event storms less likely,
+ * at the cost of (unswappable) kernel memory.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nm_platform_netlink_set_rcvbuf (NMPlatform *self, int size)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (size > 0, FALSE);
+
+	if (!klass->netlink_set_rcvbuf)
+		return FALSE;
+	return klass->netlink_set_rcvbuf (self, size);
+}
+
+/**
+ * nm_platform_netlink_get_stats:
+ * @self: platform instance
+ * @out_stats: (out): the counters of the netlink event socket
+ *
+ * Returns: %TRUE if the platform has a netlink socket and @out_stats
+ *   was set. Otherwise, @out_stats is zeroed.
+ */
+gboolean
+nm_platform_netlink_get_stats (NMPlatform *self, NMPlatformNetlinkStats *out_stats)
+{
+	_CHECK_SELF (self, klass, FALSE);
+
+	g_return_val_if_fail (out_stats, FALSE);
+
+	memset (out_stats, 0, sizeof (*out_stats));
+	out_stats->rcvbuf = -1;
+	if (!klass->netlink_get_stats)
+		return FALSE;
+	return klass->netlink_get_stats (self, out_stats);
+}
+
 /*****************************************************************************/
 
 /**
@@ -3364,6 +3412,7 @@ nm_platform_ip4_address_sync (NMPlatform *self,
 	NMPLookup lookup;
 	guint32 lifetime, preferred;
 	guint32 ifa_flags;
+	gs_free NMPlatformError *plerrs = NULL;
 
 	_CHECK_SELF (self, klass, FALSE);
 
@@ -3455,9 +3504,15 @@ nm_platform_ip4_address_sync (NMPlatform *self,
 	            ? IFA_F_NOPREFIXROUTE
 	            : 0;
 
+	plerrs = g_new (NMPlatformError, known_addresses->len);
+
 	/* Add missing addresses */
+	nm_platform_batch_begin (self);
 	for (i = 0; i < known_addresses->len; i++) {
 		const NMPObject *o;
+		NMPObject obj_add;
+
+		plerrs[i] = NM_PLATFORM_ERROR_UNSPECIFIED;
 
 		o = known_addresses->pdata[i];
 		if (!o)
@@ -3468,18 +3523,24 @@ nm_platform_ip4_address_sync (NMPlatform *self,
 		lifetime = nm_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
 		                                  now, &preferred);
 		if (!lifetime)
-			goto delete_and_next2;
+			continue;
 
-		if (!nm_platform_ip4_address_add (self, ifindex, known_address->address, known_address->plen,
-		                                  known_address->peer_address, lifetime, preferred,
-		                                  ifa_flags,
-		                                  known_address->label))
-			goto delete_and_next2;
+		nmp_object_stackinit (&obj_add, NMP_OBJECT_TYPE_IP4_ADDRESS, (const NMPlatformObject *) known_address);
+		obj_add.ip4_address.ifindex = ifindex;
+		obj_add.ip4_address.timestamp = 0;
+		obj_add.ip4_address.lifetime = lifetime;
+		obj_add.ip4_address.preferred = preferred;
+		obj_add.ip4_address.n_ifa_flags = ifa_flags;
+		_LOGD ("address: adding or updating IPv4 address: %s", nm_platform_ip4_address_to_string (&obj_add.ip4_address, NULL, 0));
+		nm_platform_batch_add (self, NMP_NLM_FLAG_REPLACE, &obj_add, &plerrs[i]);
+	}
+	nm_platform_batch_commit (self);
 
-		continue;
-delete_and_next2:
-		nmp_object_unref (o);
-		known_addresses->pdata[i] = NULL;
+	/* Drop the addresses that expired or could not be added. */
+	for (i = 0; i < known_addresses->len; i++) {
+		if (   known_addresses->pdata[i]
+		    && plerrs[i] != NM_PLATFORM_ERROR_SUCCESS)
+			nmp_object_unref (g_steal_pointer (&known_addresses->pdata[i]));
 	}
 
 	return TRUE;
@@ -3627,26 +3688,33 @@ next_plat:
 	            : 0;
 
 	/* Add missing addresses. New addresses are added by kernel with top
-	 * priority.
+	 * priority. The batch preserves the order of the requests.
 	 */
+	nm_platform_batch_begin (self);
 	for (i_know = 0; i_know < known_addresses->len; i_know++) {
 		const NMPlatformIP6Address *known_address = NMP_OBJECT_CAST_IP6_ADDRESS (known_addresses->pdata[i_know]);
 		guint32 lifetime, preferred;
+		NMPObject obj_add;
 
 		if (!known_address)
 			continue;
 
 		lifetime = nm_utils_lifetime_get (known_address->timestamp, known_address->lifetime, known_address->preferred,
 		                                  now, &preferred);
-
-		if (!nm_platform_ip6_address_add (self, ifindex, known_address->address,
-		                                  known_address->plen, known_address->peer_address,
-		                                  lifetime, preferred,
-		                                  ifa_flags | known_address->n_ifa_flags))
-			return FALSE;
+		if (!lifetime)
+			continue;
+		nm_assert (preferred <= lifetime);
+
+		nmp_object_stackinit (&obj_add, NMP_OBJECT_TYPE_IP6_ADDRESS, (const NMPlatformObject *) known_address);
+		obj_add.ip6_address.ifindex = ifindex;
+		obj_add.ip6_address.timestamp = 0;
+		obj_add.ip6_address.lifetime = lifetime;
+		obj_add.ip6_address.preferred = preferred;
+		obj_add.ip6_address.n_ifa_flags = ifa_flags | known_address->n_ifa_flags;
+		_LOGD ("address: adding or updating IPv6 address: %s", nm_platform_ip6_address_to_string (&obj_add.ip6_address, NULL, 0));
+		nm_platform_batch_add (self, NMP_NLM_FLAG_REPLACE, &obj_add, NULL);
 	}
-
-	return TRUE;
+	return nm_platform_batch_commit (self);
 }
 
 gboolean
@@ -3758,6 +3826,266 @@ nm_platform_ip_route_get_prune_list (NMPlatform *self,
 	return routes_prune;
 }
 
+typedef enum {
+	ROUTE_SYNC_STATE_UNCHANGED,
+	ROUTE_SYNC_STATE_ADD,
+	ROUTE_SYNC_STATE_REPLACE,
+	ROUTE_SYNC_STATE_DUPLICATE,
+} RouteSyncState;
+
+typedef struct {
+	const NMPObject *obj;
+	guint idx;
+} RouteSyncSortData;
+
+typedef struct {
+	/* the route to add, or %NULL to only delete @obj_del. The instance is
+	 * owned by the caller's list of routes. */
+	const NMPObject *obj_add;
+
+	/* the route to delete before adding @obj_add (if any). We keep a
+	 * reference, because the object might be removed from the cache
+	 * while applying the changes. */
+	const NMPObject *obj_del;
+
+	/* the result of adding @obj_add. */
+	NMPlatformError plerr;
+} RouteSyncOp;
+
+static int
+_route_sync_sort_data_cmp (gconstpointer p_a, gconstpointer p_b)
+{
+	const RouteSyncSortData *a = p_a;
+	const RouteSyncSortData *b = p_b;
+
+	NM_CMP_RETURN (nmp_object_id_cmp (a->obj, b->obj));
+
+	/* for duplicate routes, the first one in the list wins. */
+	NM_CMP_FIELD (a, b, idx);
+	return 0;
+}
+
+static int
+_route_sync_obj_cmp_p (gconstpointer p_a, gconstpointer p_b)
+{
+	return nmp_object_id_cmp (*((const NMPObject *const*) p_a),
+	                          *((const NMPObject *const*) p_b));
+}
+
+static void
+_route_sync_op_clear (gpointer data)
+{
+	RouteSyncOp *op = data;
+
+	nmp_object_unref (op->obj_del);
+}
+
+static const NMPObject *
+_route_sync_find_sorted (GPtrArray *sorted, guint *p_idx, const NMPObject *obj)
+{
+	int c;
+
+	/* advance the cursor @p_idx through the sorted list @sorted. @obj must
+	 * be passed in increasing order. */
+	for (; *p_idx < sorted->len; (*p_idx)++) {
+		c = nmp_object_id_cmp (sorted->pdata[*p_idx], obj);
+		if (c > 0)
+			break;
+		if (c == 0)
+			return sorted->pdata[*p_idx];
+	}
+	return NULL;
+}
+
+/**
+ * _ip_route_sync_diff:
+ * @self: the #NMPlatform instance.
+ * @vt: the route vtable for the address family.
+ * @ifindex: the interface.
+ * @routes: (allow-none): the routes to configure.
+ * @routes_prune: (allow-none): the routes to delete.
+ *
+ * Computes the minimal list of changes to bring the routes in the platform
+ * cache in sync with @routes. The desired routes and the cached routes of
+ * @ifindex are both sorted by their ID and merged, so that this costs
+ * O(n log n) without any per-route cache lookup.
+ *
+ * Returns: (transfer full): the array of #RouteSyncOp, in the order in
+ *   which they must be applied. That is, first device routes, then
+ *   gateway routes and finally the routes to prune.
+ */
+static GArray *
+_ip_route_sync_diff (NMPlatform *self,
+                     const NMPlatformVTableRoute *vt,
+                     int ifindex,
+                     GPtrArray *routes,
+                     GPtrArray *routes_prune)
+{
+	gs_unref_ptrarray GPtrArray *plat_sorted = NULL;
+	gs_unref_ptrarray GPtrArray *conf_sorted = NULL;
+	gs_free RouteSyncSortData *conf_data = NULL;
+	gs_free RouteSyncState *conf_state = NULL;
+	gs_free const NMPObject **conf_plat = NULL;
+	const NMDedupMultiHeadEntry *head_entry;
+	NMPLookup lookup;
+	GArray *ops;
+	guint n_routes = routes ? routes->len : 0;
+	guint i, j;
+	int i_type;
+	char sbuf1[sizeof (_nm_utils_to_string_buffer)];
+
+	ops = g_array_new (FALSE, FALSE, sizeof (RouteSyncOp));
+	g_array_set_clear_func (ops, _route_sync_op_clear);
+
+	/* the currently configured routes on the interface, sorted by ID. */
+	head_entry = nm_platform_lookup (self,
+	                                 nmp_lookup_init_object (&lookup,
+	                                                         vt->obj_type,
+	                                                         ifindex));
+	plat_sorted = g_ptr_array_sized_new (head_entry ? head_entry->len : 0);
+	if (head_entry) {
+		NMDedupMultiIter iter;
+		const NMPObject *plat_o;
+
+		nmp_cache_iter_for_each (&iter, head_entry, &plat_o)
+			g_ptr_array_add (plat_sorted, (gpointer) plat_o);
+		g_ptr_array_sort (plat_sorted, _route_sync_obj_cmp_p);
+	}
+
+	/* the desired routes, sorted by ID. */
+	conf_sorted = g_ptr_array_new ();
+	if (n_routes > 0) {
+		conf_data = g_new (RouteSyncSortData, n_routes);
+		conf_state = g_new (RouteSyncState, n_routes);
+		conf_plat = g_new0 (const NMPObject *, n_routes);
+		for (i = 0; i < n_routes; i++) {
+			conf_data[i].obj = routes->pdata[i];
+			conf_data[i].idx = i;
+		}
+		g_qsort_with_data (conf_data, n_routes, sizeof (RouteSyncSortData),
+		                   (GCompareDataFunc) _route_sync_sort_data_cmp, NULL);
+
+		j = 0;
+		for (i = 0; i < n_routes; i++) {
+			const NMPObject *conf_o = conf_data[i].obj;
+			const NMPObject *plat_o;
+			guint idx = conf_data[i].idx;
+
+			if (   i > 0
+			    && nmp_object_id_equal (conf_data[i - 1].obj, conf_o)) {
+				conf_state[idx] = ROUTE_SYNC_STATE_DUPLICATE;
+				continue;
+			}
+
+			g_ptr_array_add (conf_sorted, (gpointer) conf_o);
+
+			if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->ifindex == ifindex)
+				plat_o = _route_sync_find_sorted (plat_sorted, &j, conf_o);
+			else {
+				const NMDedupMultiEntry *plat_entry;
+
+				plat_entry = nm_platform_lookup_entry (self,
+				                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+				                                       conf_o);
+				plat_o = plat_entry ? plat_entry->obj : NULL;
+			}
+
+			if (!plat_o)
+				conf_state[idx] = ROUTE_SYNC_STATE_ADD;
+			else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
+			                        NMP_OBJECT_CAST_IPX_ROUTE (plat_o),
+			                        NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) == 0)
+				conf_state[idx] = ROUTE_SYNC_STATE_UNCHANGED;
+			else {
+				conf_state[idx] = ROUTE_SYNC_STATE_REPLACE;
+				conf_plat[idx] = plat_o;
+			}
+		}
+	}
+
+	/* we add routes in two runs over @i_type, in the original order of @routes.
+	 *
+	 * First device routes, then gateway routes. */
+	for (i_type = 0; i_type < 2; i_type++) {
+		for (i = 0; i < n_routes; i++) {
+			const NMPObject *conf_o = routes->pdata[i];
+			RouteSyncOp op;
+
+#define VTABLE_IS_DEVICE_ROUTE(vt, o) (vt->is_ip4 \
+                                         ? (NMP_OBJECT_CAST_IP4_ROUTE (o)->gateway == 0) \
+                                         : IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (o)->gateway) )
+
+			if (   (i_type == 0 && !VTABLE_IS_DEVICE_ROUTE (vt, conf_o))
+			    || (i_type == 1 &&  VTABLE_IS_DEVICE_ROUTE (vt, conf_o)))
+				continue;
+
+			switch (conf_state[i]) {
+			case ROUTE_SYNC_STATE_UNCHANGED:
+				continue;
+			case ROUTE_SYNC_STATE_DUPLICATE:
+				_LOGD ("route-sync: skip adding duplicate route %s",
+				       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
+				continue;
+			case ROUTE_SYNC_STATE_ADD:
+			case ROUTE_SYNC_STATE_REPLACE:
+				break;
+			}
+
+			/* if we need to replace the existing route with a (slightly) differnt
+			 * one, delete it first. */
+			op = (RouteSyncOp) {
+				.obj_add = conf_o,
+				.obj_del = nmp_object_ref (conf_plat[i]),
+				.plerr   = NM_PLATFORM_ERROR_UNSPECIFIED,
+			};
+			g_array_append_val (ops, op);
+		}
+	}
+
+	if (routes_prune && routes_prune->len > 0) {
+		gs_unref_ptrarray GPtrArray *prune_sorted = NULL;
+		guint j_conf = 0;
+		guint j_plat = 0;
+
+		prune_sorted = g_ptr_array_sized_new (routes_prune->len);
+		for (i = 0; i < routes_prune->len; i++) {
+			nm_assert (NMP_OBJECT_GET_TYPE (routes_prune->pdata[i]) == vt->obj_type);
+			g_ptr_array_add (prune_sorted, routes_prune->pdata[i]);
+		}
+		g_ptr_array_sort (prune_sorted, _route_sync_obj_cmp_p);
+
+		for (i = 0; i < prune_sorted->len; i++) {
+			const NMPObject *prune_o = prune_sorted->pdata[i];
+			RouteSyncOp op;
+
+			if (   i > 0
+			    && nmp_object_id_equal (prune_sorted->pdata[i - 1], prune_o))
+				continue;
+
+			/* @routes overrules @routes_prune. */
+			if (_route_sync_find_sorted (conf_sorted, &j_conf, prune_o))
+				continue;
+
+			if (NMP_OBJECT_CAST_IP_ROUTE (prune_o)->ifindex == ifindex) {
+				if (!_route_sync_find_sorted (plat_sorted, &j_plat, prune_o))
+					continue;
+			} else {
+				if (!nm_platform_lookup_entry (self,
+				                               NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+				                               prune_o))
+					continue;
+			}
+
+			op = (RouteSyncOp) {
+				.obj_del = nmp_object_ref (prune_o),
+			};
+			g_array_append_val (ops, op);
+		}
+	}
+
+	return ops;
+}
+
 /**
  * nm_platform_ip_route_sync:
  * @self: the #NMPlatform instance.
@@ -3784,11 +4112,9 @@ nm_platform_ip_route_sync (NMPlatform *self,
                            GPtrArray **out_temporary_not_available)
 {
 	const NMPlatformVTableRoute *vt;
-	gs_unref_hashtable GHashTable *routes_idx = NULL;
-	const NMPObject *conf_o;
+	gs_unref_array GArray *ops = NULL;
 	const NMDedupMultiEntry *plat_entry;
 	guint i;
-	int i_type;
 	gboolean success = TRUE;
 	char sbuf1[sizeof (_nm_utils_to_string_buffer)];
 	char sbuf2[sizeof (_nm_utils_to_string_buffer)];
@@ -3802,133 +4128,88 @@ nm_platform_ip_route_sync (NMPlatform *self,
 	     ? &nm_platform_vtable_route_v4
 	     : &nm_platform_vtable_route_v6;
 
-	for (i_type = 0; routes && i_type < 2; i_type++) {
-		for (i = 0; i < routes->len; i++) {
-			NMPlatformError plerr;
-
-			conf_o = routes->pdata[i];
-
-#define VTABLE_IS_DEVICE_ROUTE(vt, o) (vt->is_ip4 \
-                                         ? (NMP_OBJECT_CAST_IP4_ROUTE (o)->gateway == 0) \
-                                         : IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (o)->gateway) )
-
-			if (   (i_type == 0 && !VTABLE_IS_DEVICE_ROUTE (vt, conf_o))
-			    || (i_type == 1 &&  VTABLE_IS_DEVICE_ROUTE (vt, conf_o))) {
-				/* we add routes in two runs over @i_type.
-				 *
-				 * First device routes, then gateway routes. */
-				continue;
-			}
-
-			if (!routes_idx) {
-				routes_idx = g_hash_table_new ((GHashFunc) nmp_object_id_hash,
-				                               (GEqualFunc) nmp_object_id_equal);
-			}
-			if (!g_hash_table_insert (routes_idx, (gpointer) conf_o, (gpointer) conf_o)) {
-				_LOGD ("route-sync: skip adding duplicate route %s",
-				       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
-				continue;
-			}
-
-			plat_entry = nm_platform_lookup_entry (self,
-			                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
-			                                       conf_o);
-			if (plat_entry) {
-				const NMPObject *plat_o;
+	ops = _ip_route_sync_diff (self, vt, ifindex, routes, routes_prune);
 
-				plat_o = plat_entry->obj;
-
-				if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
-				                   NMP_OBJECT_CAST_IPX_ROUTE (plat_o),
-				                   NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) == 0)
-					continue;
+	if (ops->len == 0)
+		return TRUE;
 
-				/* we need to replace the existing route with a (slightly) differnt
-				 * one. Delete it first. */
-				if (!nm_platform_object_delete (self, plat_o)) {
-					/* ignore error. */
-				}
-			}
+	nm_platform_batch_begin (self);
+	for (i = 0; i < ops->len; i++) {
+		RouteSyncOp *op = &g_array_index (ops, RouteSyncOp, i);
 
-			plerr = nm_platform_ip_route_add (self,
-			                                    NMP_NLM_FLAG_APPEND
-			                                  | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
-			                                  conf_o);
-			if (plerr != NM_PLATFORM_ERROR_SUCCESS) {
-				if (-((int) plerr) == EEXIST) {
-					/* Don't fail for EEXIST. It's not clear that the existing route
-					 * is identical to the one that we were about to add. However,
-					 * above we should have deleted conflicting (non-identical) routes. */
-					if (_LOGD_ENABLED ()) {
-						plat_entry = nm_platform_lookup_entry (self,
-						                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
-						                                       conf_o);
-						if (!plat_entry) {
-							_LOGD ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
-							       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
-						} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
-						                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
-						                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
-							_LOGD ("route-sync: adding route %s failed due to existing (different!) route %s",
-							       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-							       nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
-						}
-					}
-				} else if (   -((int) plerr) == EINVAL
-				           && out_temporary_not_available
-				           && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
-					_LOGD ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
-					if (!*out_temporary_not_available)
-						*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
-					g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
-				} else if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
-					_LOGD ("route-sync: ignore failure to add IPv%c route: %s: %s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
-				} else {
-					const char *reason = "";
-
-					if (   -((int) plerr) == ENETUNREACH
-					    && (  vt->is_ip4
-					        ? !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway
-					        : !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))
-						reason = "; is the gateway directly reachable?";
-
-					_LOGW ("route-sync: failure to add IPv%c route: %s: %s%s",
-					       vt->is_ip4 ? '4' : '6',
-					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
-					       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)),
-					       reason);
-					success = FALSE;
-				}
-			}
+		if (op->obj_del) {
+			/* ignore errors for deleting. */
+			nm_platform_batch_delete (self, op->obj_del, NULL);
+		}
+		if (op->obj_add) {
+			nm_platform_batch_add (self,
+			                         NMP_NLM_FLAG_APPEND
+			                       | NMP_NLM_FLAG_SUPPRESS_NETLINK_FAILURE,
+			                       op->obj_add,
+			                       &op->plerr);
 		}
 	}
+	nm_platform_batch_commit (self);
 
-	if (routes_prune) {
-		for (i = 0; i < routes_prune->len; i++) {
-			const NMPObject *prune_o;
-
-			prune_o = routes_prune->pdata[i];
+	for (i = 0; i < ops->len; i++) {
+		const RouteSyncOp *op = &g_array_index (ops, RouteSyncOp, i);
+		const NMPObject *conf_o = op->obj_add;
+		NMPlatformError plerr = op->plerr;
 
-			nm_assert (   (addr_family == AF_INET  && NMP_OBJECT_GET_TYPE (prune_o) == NMP_OBJECT_TYPE_IP4_ROUTE)
-			           || (addr_family == AF_INET6 && NMP_OBJECT_GET_TYPE (prune_o) == NMP_OBJECT_TYPE_IP6_ROUTE));
-
-			if (   routes_idx
-			    && g_hash_table_lookup (routes_idx, prune_o))
-				continue;
+		if (!conf_o)
+			continue;
 
-			if (!nm_platform_lookup_entry (self,
-			                               NMP_CACHE_ID_TYPE_OBJECT_TYPE,
-			                               prune_o))
-				continue;
+		if (plerr == NM_PLATFORM_ERROR_SUCCESS)
+			continue;
 
-			if (!nm_platform_object_delete (self, prune_o)) {
-				/* ignore error... */
+		if (-((int) plerr) == EEXIST) {
+			/* Don't fail for EEXIST. It's not clear that the existing route
+			 * is identical to the one that we were about to add. However,
+			 * above we should have deleted conflicting (non-identical) routes. */
+			if (_LOGD_ENABLED ()) {
+				plat_entry = nm_platform_lookup_entry (self,
+				                                       NMP_CACHE_ID_TYPE_OBJECT_TYPE,
+				                                       conf_o);
+				if (!plat_entry) {
+					_LOGD ("route-sync: adding route %s failed with EEXIST, however we cannot find such a route",
+					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)));
+				} else if (vt->route_cmp (NMP_OBJECT_CAST_IPX_ROUTE (conf_o),
+				                          NMP_OBJECT_CAST_IPX_ROUTE (plat_entry->obj),
+				                          NM_PLATFORM_IP_ROUTE_CMP_TYPE_SEMANTICALLY) != 0) {
+					_LOGD ("route-sync: adding route %s failed due to existing (different!) route %s",
+					       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+					       nmp_object_to_string (plat_entry->obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf2, sizeof (sbuf2)));
+				}
 			}
+		} else if (   -((int) plerr) == EINVAL
+		           && out_temporary_not_available
+		           && _err_inval_due_to_ipv6_tentative_pref_src (self, conf_o)) {
+			_LOGD ("route-sync: ignore failure to add IPv6 route with tentative IPv6 pref-src: %s: %s",
+			       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
+			if (!*out_temporary_not_available)
+				*out_temporary_not_available = g_ptr_array_new_full (0, (GDestroyNotify) nmp_object_unref);
+			g_ptr_array_add (*out_temporary_not_available, (gpointer) nmp_object_ref (conf_o));
+		} else if (NMP_OBJECT_CAST_IP_ROUTE (conf_o)->rt_source < NM_IP_CONFIG_SOURCE_USER) {
+			_LOGD ("route-sync: ignore failure to add IPv%c route: %s: %s",
+			       vt->is_ip4 ? '4' : '6',
+			       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)));
+		} else {
+			const char *reason = "";
+
+			if (   -((int) plerr) == ENETUNREACH
+			    && (  vt->is_ip4
+			        ? !!NMP_OBJECT_CAST_IP4_ROUTE (conf_o)->gateway
+			        : !IN6_IS_ADDR_UNSPECIFIED (&NMP_OBJECT_CAST_IP6_ROUTE (conf_o)->gateway)))
+				reason = "; is the gateway directly reachable?";
+
+			_LOGW ("route-sync: failure to add IPv%c route: %s: %s%s",
+			       vt->is_ip4 ? '4' : '6',
+			       nmp_object_to_string (conf_o, NMP_OBJECT_TO_STRING_PUBLIC, sbuf1, sizeof (sbuf1)),
+			       nm_platform_error_to_string (plerr, sbuf_err, sizeof (sbuf_err)),
+			       reason);
+			success = FALSE;
 		}
 	}
 
@@ -4124,6 +4405,234 @@ nm_platform_object_delete (NMPlatform *self,
 
 /*****************************************************************************/
 
+static void
+_batch_op_clear (gpointer data)
+{
+	NMPlatformBatchOp *op = data;
+
+	nmp_object_unref (op->obj);
+}
+
+static void
+_batch_queue (NMPlatform *self,
+              gboolean is_delete,
+              NMPNlmFlags flags,
+              const NMPObject *obj,
+              NMPlatformError *out_result)
+{
+	NMPlatformPrivate *priv;
+	NMPlatformBatchOp *op;
+	char sbuf[sizeof (_nm_utils_to_string_buffer)];
+
+	_CHECK_SELF_VOID (self, klass);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	g_return_if_fail (priv->batch_active);
+	g_return_if_fail (NM_IN_SET (NMP_OBJECT_GET_TYPE (obj), NMP_OBJECT_TYPE_IP4_ADDRESS,
+	                                                        NMP_OBJECT_TYPE_IP6_ADDRESS,
+	                                                        NMP_OBJECT_TYPE_IP4_ROUTE,
+	                                                        NMP_OBJECT_TYPE_IP6_ROUTE));
+	nm_assert (obj->object.ifindex > 0);
+
+	if (is_delete) {
+		_LOGD ("%s: queue delete %s",
+		       NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+		       nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof (sbuf)));
+	} else {
+		_LOGD ("%s: queue %-10s %s",
+		       NMP_OBJECT_GET_CLASS (obj)->obj_type_name,
+		       _nmp_nlm_flag_to_string (flags & NMP_NLM_FLAG_FMASK),
+		       nmp_object_to_string (obj, NMP_OBJECT_TO_STRING_PUBLIC, sbuf, sizeof (sbuf)));
+	}
+
+	if (!priv->batch_ops) {
+		priv->batch_ops = g_array_new (FALSE, FALSE, sizeof (NMPlatformBatchOp));
+		g_array_set_clear_func (priv->batch_ops, _batch_op_clear);
+	}
+
+	g_array_set_size (priv->batch_ops, priv->batch_ops->len + 1);
+	op = &g_array_index (priv->batch_ops, NMPlatformBatchOp, priv->batch_ops->len - 1);
+	*op = (NMPlatformBatchOp) {
+		.obj        =   NMP_OBJECT_IS_STACKINIT (obj)
+		              ? nmp_object_clone (obj, FALSE)
+		              : nmp_object_ref (obj),
+		.flags      = flags,
+		.is_delete  = is_delete,
+		.result     = NM_PLATFORM_ERROR_UNSPECIFIED,
+		.out_result = out_result,
+	};
+}
+
+/**
+ * nm_platform_batch_begin:
+ * @self: platform instance
+ *
+ * Start queueing address and route changes instead of executing them
+ * one at a time. Until the matching nm_platform_batch_commit(),
+ * nm_platform_batch_add() and nm_platform_batch_delete() only enqueue
+ * the operation. On commit, the platform implementation may send all
+ * requests at once and wait for the responses together, instead of
+ * waiting for a round trip after each request.
+ *
+ * The operations are executed in the order in which they were queued.
+ * Batches cannot be nested, because the caller expects the results to
+ * be available after its commit.
+ */
+void
+nm_platform_batch_begin (NMPlatform *self)
+{
+	NMPlatformPrivate *priv;
+
+	_CHECK_SELF_VOID (self, klass);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	g_return_if_fail (!priv->batch_active);
+
+	priv->batch_active = TRUE;
+}
+
+/**
+ * nm_platform_batch_add:
+ * @self: platform instance
+ * @flags: the nlmsg flags for the request. Addresses are always
+ *   added with %NMP_NLM_FLAG_REPLACE semantics, like for
+ *   nm_platform_ip4_address_add().
+ * @obj: the address or route to add. The batch takes a reference
+ *   (or a copy, if @obj is stack allocated).
+ *   For addresses, the lifetime and preferred lifetime are taken as relative
+ *   to the time of the commit, like for nm_platform_ip4_address_add().
+ * @out_result: (allow-none): on commit, the result of the operation will
+ *   be written here.
+ */
+void
+nm_platform_batch_add (NMPlatform *self,
+                       NMPNlmFlags flags,
+                       const NMPObject *obj,
+                       NMPlatformError *out_result)
+{
+	_batch_queue (self, FALSE, flags, obj, out_result);
+}
+
+/**
+ * nm_platform_batch_delete:
+ * @self: platform instance
+ * @obj: the address or route to delete.
+ * @out_result: (allow-none): on commit, the result of the operation will
+ *   be written here.
+ */
+void
+nm_platform_batch_delete (NMPlatform *self,
+                          const NMPObject *obj,
+                          NMPlatformError *out_result)
+{
+	_batch_queue (self, TRUE, 0, obj, out_result);
+}
+
+static NMPlatformError
+_batch_op_apply (NMPlatform *self, const NMPlatformBatchOp *op)
+{
+	NMPlatformClass *klass = NM_PLATFORM_GET_CLASS (self);
+	gboolean success;
+
+	switch (NMP_OBJECT_GET_TYPE (op->obj)) {
+	case NMP_OBJECT_TYPE_IP4_ADDRESS: {
+		const NMPlatformIP4Address *a = NMP_OBJECT_CAST_IP4_ADDRESS (op->obj);
+
+		if (op->is_delete)
+			success = klass->ip4_address_delete (self, a->ifindex, a->address, a->plen, a->peer_address);
+		else {
+			success = klass->ip4_address_add (self, a->ifindex, a->address, a->plen, a->peer_address,
+			                                  a->lifetime, a->preferred, a->n_ifa_flags,
+			                                  a->label[0] ? a->label : NULL);
+		}
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP6_ADDRESS: {
+		const NMPlatformIP6Address *a = NMP_OBJECT_CAST_IP6_ADDRESS (op->obj);
+
+		if (op->is_delete)
+			success = klass->ip6_address_delete (self, a->ifindex, a->address, a->plen);
+		else {
+			success = klass->ip6_address_add (self, a->ifindex, a->address, a->plen, a->peer_address,
+			                                  a->lifetime, a->preferred, a->n_ifa_flags);
+		}
+		break;
+	}
+	case NMP_OBJECT_TYPE_IP4_ROUTE:
+	case NMP_OBJECT_TYPE_IP6_ROUTE:
+		if (!op->is_delete) {
+			return klass->ip_route_add (self,
+			                            op->flags,
+			                              NMP_OBJECT_GET_TYPE (op->obj) == NMP_OBJECT_TYPE_IP4_ROUTE
+			                            ? AF_INET
+			                            : AF_INET6,
+			                            NMP_OBJECT_CAST_IP_ROUTE (op->obj));
+		}
+		success = klass->object_delete (self, op->obj);
+		break;
+	default:
+		g_return_val_if_reached (NM_PLATFORM_ERROR_BUG);
+	}
+
+	return success ? NM_PLATFORM_ERROR_SUCCESS : NM_PLATFORM_ERROR_UNSPECIFIED;
+}
+
+/**
+ * nm_platform_batch_commit:
+ * @self: platform instance
+ *
+ * Ends a batch started with nm_platform_batch_begin(). All queued
+ * operations are executed and their results are written to the
+ * respective @out_result arguments.
+ *
+ * Returns: %FALSE if any of the executed operations failed.
+ */
+gboolean
+nm_platform_batch_commit (NMPlatform *self)
+{
+	NMPlatformPrivate *priv;
+	gs_unref_array GArray *ops = NULL;
+	gboolean success = TRUE;
+	guint i;
+
+	_CHECK_SELF (self, klass, FALSE);
+
+	priv = NM_PLATFORM_GET_PRIVATE (self);
+
+	g_return_val_if_fail (priv->batch_active, FALSE);
+
+	priv->batch_active = FALSE;
+
+	ops = g_steal_pointer (&priv->batch_ops);
+	if (!ops || ops->len == 0)
+		return TRUE;
+
+	if (klass->batch_commit)
+		klass->batch_commit (self, (NMPlatformBatchOp *) ops->data, ops->len);
+	else {
+		for (i = 0; i < ops->len; i++) {
+			NMPlatformBatchOp *op = &g_array_index (ops, NMPlatformBatchOp, i);
+
+			op->result = _batch_op_apply (self, op);
+		}
+	}
+
+	for (i = 0; i < ops->len; i++) {
+		const NMPlatformBatchOp *op = &g_array_index (ops, NMPlatformBatchOp, i);
+
+		if (op->result != NM_PLATFORM_ERROR_SUCCESS)
+			success = FALSE;
+		if (op->out_result)
+			*op->out_result = op->result;
+	}
+
+	return success;
+}
+
+/*****************************************************************************/
+
 NMPlatformError
 nm_platform_ip_route_get (NMPlatform *self,
                           int addr_family,
@@ -6572,6 +7081,8 @@ finalize (GObject *object)
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_check_id);
 	nm_clear_g_source (&priv->ip4_dev_route_blacklist_gc_timeout_id);
 	g_clear_pointer (&priv->ip4_dev_route_blacklist_hash, g_hash_table_unref);
+	nm_assert (!priv->batch_active);
+	g_clear_pointer (&priv->batch_ops, g_array_unref);
 	g_clear_object (&self->_netns);
 	nm_dedup_multi_index_unref (priv->multi_idx);
 	nmp_cache_free (priv->cache);
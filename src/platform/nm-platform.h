@@ -705,6 +705,46 @@ typedef enum {
 
 /*****************************************************************************/
 
+/* A queued operation of a platform batch. See nm_platform_batch_begin(). */
+typedef struct {
+	/* an address or route object to add or delete. The batch owns a reference. */
+	const NMPObject *obj;
+
+	/* for additions, the nlmsg flags to use. */
+	NMPNlmFlags flags;
+
+	bool is_delete:1;
+
+	/* the result of the operation, set by the batch_commit() implementation. */
+	NMPlatformError result;
+
+	/* optional. On commit, the result is also written here. */
+	NMPlatformError *out_result;
+} NMPlatformBatchOp;
+
+/* Counters about the netlink event socket, for diagnosing overruns. */
+typedef struct {
+	/* the effective size of the socket receive buffer, or -1 if unknown. */
+	gint64 rcvbuf;
+
+	/* how often the receive buffer overflowed (ENOBUFS). */
+	guint64 nobufs;
+
+	/* how often a datagram was truncated and the receive buffer grown. */
+	guint64 buf_grows;
+
+	/* how often the cache was resynchronized after losing events, and how long
+	 * the resynchronizations took in total and the last time. */
+	guint64 resyncs;
+	gint64 resync_total_usec;
+	gint64 resync_last_usec;
+
+	/* the highest number of datagrams received by one read. */
+	guint64 msgs_per_read_peak;
+} NMPlatformNetlinkStats;
+
+/*****************************************************************************/
+
 struct _NMPlatformPrivate;
 
 struct _NMPlatform {
@@ -736,6 +776,9 @@ typedef struct {
 
 	void (*process_events) (NMPlatform *self);
 
+	gboolean (*netlink_set_rcvbuf) (NMPlatform *self, int size);
+	gboolean (*netlink_get_stats) (NMPlatform *self, NMPlatformNetlinkStats *out_stats);
+
 	gboolean (*link_set_up) (NMPlatform *, int ifindex, gboolean *out_no_firmware);
 	gboolean (*link_set_down) (NMPlatform *, int ifindex);
 	gboolean (*link_set_arp) (NMPlatform *, int ifindex);
@@ -864,6 +907,12 @@ typedef struct {
 	                                 NMPNlmFlags flags,
 	                                 int addr_family,
 	                                 const NMPlatformIPRoute *route);
+
+	/* optional. Execute all @ops and set their result. Implementations
+	 * that don't implement it, get the ops applied one by one. */
+	void (*batch_commit) (NMPlatform *self,
+	                      NMPlatformBatchOp *ops,
+	                      guint n_ops);
 	NMPlatformError (*ip_route_get) (NMPlatform *self,
 	                                 int addr_family,
 	                                 gconstpointer address,
@@ -1106,6 +1155,9 @@ const char *nm_platform_link_get_type_name (NMPlatform *self, int ifindex);
 gboolean nm_platform_link_refresh (NMPlatform *self, int ifindex);
 void nm_platform_process_events (NMPlatform *self);
 
+gboolean nm_platform_netlink_set_rcvbuf (NMPlatform *self, int size);
+gboolean nm_platform_netlink_get_stats (NMPlatform *self, NMPlatformNetlinkStats *out_stats);
+
 gboolean nm_platform_link_set_up (NMPlatform *self, int ifindex, gboolean *out_no_firmware);
 gboolean nm_platform_link_set_down (NMPlatform *self, int ifindex);
 gboolean nm_platform_link_set_arp (NMPlatform *self, int ifindex);
@@ -1274,6 +1326,16 @@ gboolean nm_platform_ip6_address_add (NMPlatform *self,
                                       guint32 flags);
 gboolean nm_platform_ip4_address_delete (NMPlatform *self, int ifindex, in_addr_t address, guint8 plen, in_addr_t peer_address);
 gboolean nm_platform_ip6_address_delete (NMPlatform *self, int ifindex, struct in6_addr address, guint8 plen);
+void nm_platform_batch_begin (NMPlatform *self);
+void nm_platform_batch_add (NMPlatform *self,
+                            NMPNlmFlags flags,
+                            const NMPObject *obj,
+                            NMPlatformError *out_result);
+void nm_platform_batch_delete (NMPlatform *self,
+                               const NMPObject *obj,
+                               NMPlatformError *out_result);
+gboolean nm_platform_batch_commit (NMPlatform *self);
+
 gboolean nm_platform_ip4_address_sync (NMPlatform *self, int ifindex, GPtrArray *known_addresses);
 gboolean nm_platform_ip6_address_sync (NMPlatform *self, int ifindex, GPtrArray *known_addresses, gboolean full_sync);
 gboolean nm_platform_ip_address_flush (NMPlatform *self,
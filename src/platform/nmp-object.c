@@ -290,6 +290,10 @@ _dedup_multi_idx_type_init (DedupMultiIdxType *idx_type, NMPCacheIdType cache_id
 	nm_dedup_multi_idx_type_init ((NMDedupMultiIdxType *) idx_type,
 	                              &_dedup_multi_idx_type_class);
 	idx_type->cache_id_type = cache_id_type;
+
+	/* all indexes hash only binary ids (ifindex, addresses, metric, ...),
+	 * except the lookup by interface name. */
+	idx_type->parent.fixed_width_keys = (cache_id_type != NMP_CACHE_ID_TYPE_LINK_BY_IFNAME);
 }
 
 /*****************************************************************************/
@@ -1084,7 +1088,7 @@ nmp_object_id_hash (const NMPObject *obj)
 	if (!obj)
 		return nm_hash_static (914932607u);
 
-	nm_hash_init (&h, 914932607u);
+	nm_hash_init_fast (&h, 914932607u);
 	nmp_object_id_hash_update (obj, &h);
 	return nm_hash_complete (&h);
 }
@@ -2510,6 +2514,37 @@ nmp_cache_dirty_set_all (NMPCache *cache, NMPObjectType obj_type)
 	                                     _nmp_object_stackinit_from_type (&obj_needle, obj_type));
 }
 
+/**
+ * nmp_cache_dirty_set_all_main:
+ * @cache: the platform cache
+ * @lookup: select the objects to mark
+ *
+ * Like nmp_cache_dirty_set_all(), but only mark the objects that are
+ * selected by @lookup. The dirty flag is set on the entries of the
+ * main index, which is what nmp_cache_remove() checks for @only_dirty.
+ */
+void
+nmp_cache_dirty_set_all_main (NMPCache *cache,
+                              const NMPLookup *lookup)
+{
+	const NMDedupMultiHeadEntry *head_entry;
+	NMDedupMultiIter iter;
+
+	nm_assert (cache);
+	nm_assert (lookup);
+
+	head_entry = nmp_cache_lookup (cache, lookup);
+
+	nm_dedup_multi_iter_init (&iter, head_entry);
+	while (nm_dedup_multi_iter_next (&iter)) {
+		const NMDedupMultiEntry *main_entry;
+
+		main_entry = _lookup_entry (cache, iter.current->obj);
+		nm_assert (main_entry);
+		nm_dedup_multi_entry_set_dirty (main_entry, TRUE);
+	}
+}
+
 /*****************************************************************************/
 
 NMPCache *
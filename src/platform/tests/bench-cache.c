@@ -0,0 +1,296 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+/* Microbenchmark for the platform cache (NMPCache) and the underlying
+ * NMDedupMultiIndex. It is not run by "make check", invoke it manually:
+ *
+ *   $ ./src/platform/tests/bench-cache [--max-objects=N]
+ *
+ * For each size, it reports the time per operation and the growth of the
+ * resident set size per object. Compare the numbers before and after a
+ * change; absolute values depend on the machine. */
+
+#include "nm-default.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "platform/nm-fake-platform.h"
+#include "platform/nmp-object.h"
+#include "nm-ip4-config.h"
+#include "NetworkManagerUtils.h"
+
+#include "nm-test-utils-core.h"
+
+NMTST_DEFINE ();
+
+/* spread the objects over some interfaces, like on a router. */
+#define N_IFINDEXES 64
+
+static struct {
+	guint max_objects;
+} global_opt = {
+	.max_objects = 1000000,
+};
+
+/*****************************************************************************/
+
+static gsize
+_rss_get (void)
+{
+	gs_free char *contents = NULL;
+	gs_strfreev char **tokens = NULL;
+	gint64 pages;
+
+	if (!g_file_get_contents ("/proc/self/statm", &contents, NULL, NULL))
+		return 0;
+	tokens = g_strsplit (contents, " ", -1);
+	if (!tokens[0] || !tokens[1])
+		return 0;
+	pages = _nm_utils_ascii_str_to_int64 (tokens[1], 10, 0, G_MAXINT64, 0);
+	return pages * sysconf (_SC_PAGESIZE);
+}
+
+typedef struct {
+	const char *name;
+	guint n;
+	gint64 start_ns;
+	gsize start_rss;
+} Bench;
+
+static void
+_bench_start (Bench *bench, const char *name, guint n)
+{
+	*bench = (Bench) {
+		.name = name,
+		.n = n,
+		.start_rss = _rss_get (),
+		.start_ns = nm_utils_get_monotonic_timestamp_ns (),
+	};
+}
+
+static void
+_bench_end (Bench *bench)
+{
+	gint64 duration_ns = nm_utils_get_monotonic_timestamp_ns () - bench->start_ns;
+	gssize rss_delta = (gssize) _rss_get () - (gssize) bench->start_rss;
+
+	g_print ("%-36s %8u objects: %9.1f ns/op %8.1f bytes RSS/object\n",
+	         bench->name,
+	         bench->n,
+	         (double) duration_ns / bench->n,
+	         (double) rss_delta / bench->n);
+}
+
+/*****************************************************************************/
+
+static void
+_init_ip4_address (NMPlatformIP4Address *a, guint i)
+{
+	*a = (NMPlatformIP4Address) {
+		.ifindex = 1 + (i % N_IFINDEXES),
+		.address = htonl (0x0a000000u + i),
+		.peer_address = htonl (0x0a000000u + i),
+		.plen = 32,
+		.addr_source = NM_IP_CONFIG_SOURCE_KERNEL,
+		.lifetime = NM_PLATFORM_LIFETIME_PERMANENT,
+		.preferred = NM_PLATFORM_LIFETIME_PERMANENT,
+	};
+}
+
+static void
+_init_ip4_route (NMPlatformIP4Route *r, guint i)
+{
+	*r = (NMPlatformIP4Route) {
+		.ifindex = 1 + (i % N_IFINDEXES),
+		.network = htonl (0x0a000000u + i),
+		.plen = 32,
+		.metric = 100,
+		.rt_source = NM_IP_CONFIG_SOURCE_KERNEL,
+		.table_coerced = nm_platform_route_table_coerce (RT_TABLE_MAIN),
+		.scope_inv = nm_platform_route_scope_inv (RT_SCOPE_LINK),
+	};
+}
+
+/*****************************************************************************/
+
+static void
+bench_cache (guint n)
+{
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = NULL;
+	NMPCache *cache;
+	NMPlatformIP4Address a;
+	NMPlatformIP4Route r;
+	NMPLookup lookup;
+	Bench bench;
+	guint i;
+
+	multi_idx = nm_dedup_multi_index_new ();
+	cache = nmp_cache_new (multi_idx, FALSE);
+
+	/* what the linux platform does for each RTM_NEWADDR message. */
+	_bench_start (&bench, "nmp_cache_update_netlink", n);
+	for (i = 0; i < n; i++) {
+		nm_auto_nmpobj NMPObject *obj = NULL;
+		NMPCacheOpsType ops_type;
+
+		_init_ip4_address (&a, i);
+		obj = nmp_object_new (NMP_OBJECT_TYPE_IP4_ADDRESS, (const NMPlatformObject *) &a);
+		ops_type = nmp_cache_update_netlink (cache, obj, TRUE, NULL, NULL);
+		g_assert_cmpint (ops_type, ==, NMP_CACHE_OPS_ADDED);
+	}
+	_bench_end (&bench);
+
+	/* what the linux platform does for each RTM_NEWROUTE message of a dump. */
+	_bench_start (&bench, "nmp_cache_update_netlink_route", n);
+	for (i = 0; i < n; i++) {
+		nm_auto_nmpobj NMPObject *obj = NULL;
+		NMPCacheOpsType ops_type;
+
+		_init_ip4_route (&r, i);
+		obj = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+		ops_type = nmp_cache_update_netlink_route (cache, obj, TRUE, 0, NULL, NULL, NULL, NULL);
+		g_assert_cmpint (ops_type, ==, NMP_CACHE_OPS_ADDED);
+	}
+	_bench_end (&bench);
+
+	_bench_start (&bench, "nmp_cache_lookup (route by weak-id)", n);
+	for (i = 0; i < n; i++) {
+		_init_ip4_route (&r, i);
+		nmp_lookup_init_ip4_route_by_weak_id (&lookup, r.network, r.plen, r.metric, r.tos);
+		if (!nmp_cache_lookup (cache, &lookup))
+			g_assert_not_reached ();
+	}
+	_bench_end (&bench);
+
+	_bench_start (&bench, "nmp_cache_lookup (addresses by ifindex)", N_IFINDEXES);
+	for (i = 0; i < N_IFINDEXES; i++) {
+		nmp_lookup_init_object (&lookup, NMP_OBJECT_TYPE_IP4_ADDRESS, 1 + i);
+		if (!nmp_cache_lookup (cache, &lookup))
+			g_assert_not_reached ();
+	}
+	_bench_end (&bench);
+
+	nmp_cache_free (cache);
+}
+
+static void
+bench_dedup_multi_index (guint n)
+{
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = NULL;
+	NMIPConfigDedupMultiIdxType idx_type;
+	NMPlatformIP4Route r;
+	Bench bench;
+	guint i;
+
+	multi_idx = nm_dedup_multi_index_new ();
+	nm_ip_config_dedup_multi_idx_type_init (&idx_type, NMP_OBJECT_TYPE_IP4_ROUTE);
+
+	/* what NMIP4Config does when tracking routes. */
+	_bench_start (&bench, "nm_dedup_multi_index_add", n);
+	for (i = 0; i < n; i++) {
+		nm_auto_nmpobj NMPObject *obj = NULL;
+
+		_init_ip4_route (&r, i);
+		obj = nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r);
+		if (!nm_dedup_multi_index_add (multi_idx,
+		                               &idx_type.parent,
+		                               obj,
+		                               NM_DEDUP_MULTI_IDX_MODE_APPEND,
+		                               NULL,
+		                               NULL))
+			g_assert_not_reached ();
+	}
+	_bench_end (&bench);
+
+	nm_dedup_multi_index_remove_idx (multi_idx, &idx_type.parent);
+}
+
+static void
+bench_fake_platform (guint n)
+{
+	gs_unref_object NMPlatform *platform = NULL;
+	NMPlatformIP4Route r;
+	Bench bench;
+	guint i;
+
+	platform = g_object_new (NM_TYPE_FAKE_PLATFORM,
+	                         NM_PLATFORM_LOG_WITH_PTR, FALSE,
+	                         NULL);
+
+	/* the full path through NMPlatform, including the change signals. */
+	_bench_start (&bench, "nm_platform_ip4_route_add (fake)", n);
+	for (i = 0; i < n; i++) {
+		_init_ip4_route (&r, i);
+		if (nm_platform_ip4_route_add (platform, NMP_NLM_FLAG_REPLACE, &r) != NM_PLATFORM_ERROR_SUCCESS)
+			g_assert_not_reached ();
+	}
+	_bench_end (&bench);
+}
+
+/*****************************************************************************/
+
+static gboolean
+read_argv (int *argc, char ***argv)
+{
+	GOptionContext *context;
+	int max_objects = global_opt.max_objects;
+	GOptionEntry options[] = {
+		{ "max-objects", 'n', 0, G_OPTION_ARG_INT, &max_objects, "Skip sizes larger than N objects", "N" },
+		{ 0 },
+	};
+	gs_free_error GError *error = NULL;
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, "Benchmark the NMPlatform cache.");
+	g_option_context_add_main_entries (context, options, NULL);
+
+	if (!g_option_context_parse (context, argc, argv, &error)) {
+		g_warning ("Error parsing command line arguments: %s", error->message);
+		g_option_context_free (context);
+		return FALSE;
+	}
+
+	g_option_context_free (context);
+	global_opt.max_objects = MAX (max_objects, 0);
+	return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+	static const guint sizes[] = { 1000, 10000, 100000, 1000000 };
+	guint i;
+
+	nmtst_init_with_logging (&argc, &argv, "WARN", "DEFAULT");
+
+	if (!read_argv (&argc, &argv))
+		return 2;
+
+	for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+		if (sizes[i] > global_opt.max_objects)
+			break;
+		bench_cache (sizes[i]);
+		bench_dedup_multi_index (sizes[i]);
+		bench_fake_platform (sizes[i]);
+		g_print ("\n");
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -53,6 +53,25 @@ test_link_get_all (void)
 
 /*****************************************************************************/
 
+static void
+test_netlink_stats (void)
+{
+	gs_unref_object NMPlatform *platform = NULL;
+	NMPlatformNetlinkStats stats;
+
+	platform = nm_linux_platform_new (TRUE, NM_PLATFORM_NETNS_SUPPORT_DEFAULT);
+
+	g_assert (nm_platform_netlink_set_rcvbuf (platform, 256 * 1024));
+
+	nm_platform_process_events (platform);
+
+	g_assert (nm_platform_netlink_get_stats (platform, &stats));
+	g_assert_cmpint (stats.rcvbuf, >, 0);
+	g_assert_cmpint (stats.resync_last_usec, <=, stats.resync_total_usec);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -62,6 +81,7 @@ main (int argc, char **argv)
 
 	g_test_add_func ("/general/init_linux_platform", test_init_linux_platform);
 	g_test_add_func ("/general/link_get_all", test_link_get_all);
+	g_test_add_func ("/general/netlink_stats", test_netlink_stats);
 
 	return g_test_run ();
 }
@@ -23,6 +23,7 @@
 
 #include "nm-core-utils.h"
 #include "platform/nm-platform-utils.h"
+#include "platform/nm-netlink.h"
 
 #include "test-common.h"
 
@@ -714,6 +715,199 @@ test_ip6_route_options (gconstpointer test_data)
 
 /*****************************************************************************/
 
+static void
+test_ip4_route_sync (void)
+{
+	const int IFINDEX = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+	gs_unref_ptrarray GPtrArray *routes_prune = NULL;
+	gs_unref_ptrarray GPtrArray *routes_plat = NULL;
+	NMPlatformIP4Route r;
+	guint i;
+
+	routes = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+
+	r = ((NMPlatformIP4Route) {
+		.ifindex = IFINDEX,
+		.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		.network = nmtst_inet4_from_string ("192.168.5.0"),
+		.plen = 24,
+		.metric = 100,
+	});
+	g_ptr_array_add (routes, nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r));
+
+	/* add gateway routes first. The sync must add the device route before them. */
+	for (i = 0; i < 10; i++) {
+		r = ((NMPlatformIP4Route) {
+			.ifindex = IFINDEX,
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+			.network = htonl (0x0a000000u + (i << 8)),
+			.plen = 24,
+			.gateway = nmtst_inet4_from_string ("192.168.5.1"),
+			.metric = 100,
+		});
+		g_ptr_array_insert (routes, 0, nmp_object_new (NMP_OBJECT_TYPE_IP4_ROUTE, (const NMPlatformObject *) &r));
+	}
+
+	/* duplicates are ignored. */
+	g_ptr_array_add (routes, (gpointer) nmp_object_ref (routes->pdata[3]));
+
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, IFINDEX, routes, NULL, NULL));
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes_plat->len, ==, 11);
+	g_clear_pointer (&routes_plat, g_ptr_array_unref);
+
+	/* syncing again changes nothing. */
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, IFINDEX, routes, NULL, NULL));
+
+	/* drop half of the gateway routes and prune them. */
+	g_ptr_array_remove_range (routes, 0, 5);
+	routes_prune = nm_platform_ip_route_get_prune_list (NM_PLATFORM_GET, AF_INET, IFINDEX, NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN);
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, IFINDEX, routes, routes_prune, NULL));
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes_plat->len, ==, 6);
+	for (i = 0; i < routes_plat->len; i++) {
+		const NMPlatformIP4Route *rr = NMP_OBJECT_CAST_IP4_ROUTE (routes_plat->pdata[i]);
+
+		g_assert (   rr->gateway == 0
+		          || ntohl (rr->network) >= 0x0a000000u + (5 << 8));
+	}
+	g_clear_pointer (&routes_plat, g_ptr_array_unref);
+
+	g_clear_pointer (&routes_prune, g_ptr_array_unref);
+	routes_prune = nm_platform_ip_route_get_prune_list (NM_PLATFORM_GET, AF_INET, IFINDEX, NM_IP_ROUTE_TABLE_SYNC_MODE_MAIN);
+	g_assert (nm_platform_ip_route_sync (NM_PLATFORM_GET, AF_INET, IFINDEX, NULL, routes_prune, NULL));
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes_plat->len, ==, 0);
+}
+
+static void
+test_ip4_route_batch (void)
+{
+	const int IFINDEX = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	gs_unref_ptrarray GPtrArray *routes_plat = NULL;
+	NMPObject obj_dev;
+	NMPObject obj_gw[5];
+	NMPlatformError plerr_dev = NM_PLATFORM_ERROR_BUG;
+	NMPlatformError plerr_gw[G_N_ELEMENTS (obj_gw)];
+	guint i;
+
+	nmp_object_stackinit (&obj_dev, NMP_OBJECT_TYPE_IP4_ROUTE, NULL);
+	obj_dev.ip4_route = ((NMPlatformIP4Route) {
+		.ifindex = IFINDEX,
+		.rt_source = NM_IP_CONFIG_SOURCE_USER,
+		.network = nmtst_inet4_from_string ("192.168.6.0"),
+		.plen = 24,
+		.metric = 100,
+	});
+
+	for (i = 0; i < G_N_ELEMENTS (obj_gw); i++) {
+		nmp_object_stackinit (&obj_gw[i], NMP_OBJECT_TYPE_IP4_ROUTE, NULL);
+		obj_gw[i].ip4_route = ((NMPlatformIP4Route) {
+			.ifindex = IFINDEX,
+			.rt_source = NM_IP_CONFIG_SOURCE_USER,
+			.network = htonl (0x0b000000u + (i << 8)),
+			.plen = 24,
+			.gateway = nmtst_inet4_from_string ("192.168.6.1"),
+			.metric = 100,
+		});
+		plerr_gw[i] = NM_PLATFORM_ERROR_BUG;
+	}
+
+	/* the gateway routes depend on the device route, which is
+	 * queued first. */
+	nm_platform_batch_begin (NM_PLATFORM_GET);
+	nm_platform_batch_add (NM_PLATFORM_GET, NMP_NLM_FLAG_APPEND, &obj_dev, &plerr_dev);
+	for (i = 0; i < G_N_ELEMENTS (obj_gw); i++)
+		nm_platform_batch_add (NM_PLATFORM_GET, NMP_NLM_FLAG_APPEND, &obj_gw[i], &plerr_gw[i]);
+	g_assert (nm_platform_batch_commit (NM_PLATFORM_GET));
+
+	g_assert_cmpint (plerr_dev, ==, NM_PLATFORM_ERROR_SUCCESS);
+	for (i = 0; i < G_N_ELEMENTS (obj_gw); i++)
+		g_assert_cmpint (plerr_gw[i], ==, NM_PLATFORM_ERROR_SUCCESS);
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes_plat->len, ==, 1 + G_N_ELEMENTS (obj_gw));
+	g_clear_pointer (&routes_plat, g_ptr_array_unref);
+
+	nm_platform_batch_begin (NM_PLATFORM_GET);
+	for (i = 0; i < G_N_ELEMENTS (obj_gw); i++)
+		nm_platform_batch_delete (NM_PLATFORM_GET, &obj_gw[i], &plerr_gw[i]);
+	nm_platform_batch_delete (NM_PLATFORM_GET, &obj_dev, &plerr_dev);
+	g_assert (nm_platform_batch_commit (NM_PLATFORM_GET));
+
+	g_assert_cmpint (plerr_dev, ==, NM_PLATFORM_ERROR_SUCCESS);
+	for (i = 0; i < G_N_ELEMENTS (obj_gw); i++)
+		g_assert_cmpint (plerr_gw[i], ==, NM_PLATFORM_ERROR_SUCCESS);
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes_plat->len, ==, 0);
+}
+
+static void
+test_ip4_route_link_down (void)
+{
+	const int IFINDEX = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	const char *const IFNAME_DOWN = "nm-test-down";
+	gs_unref_ptrarray GPtrArray *routes_plat = NULL;
+	gs_unref_array GArray *addrs_plat = NULL;
+	int ifindex_down;
+
+	ifindex_down = nmtstp_link_dummy_add (NULL, FALSE, IFNAME_DOWN)->ifindex;
+	nmtstp_link_set_updown (NULL, FALSE, ifindex_down, TRUE);
+
+	nmtstp_ip4_route_add (NM_PLATFORM_GET, IFINDEX, NM_IP_CONFIG_SOURCE_USER,
+	                      nmtst_inet4_from_string ("192.168.8.0"), 24, INADDR_ANY, 0, 100, 0);
+	nmtstp_ip4_route_add (NM_PLATFORM_GET, ifindex_down, NM_IP_CONFIG_SOURCE_USER,
+	                      nmtst_inet4_from_string ("192.168.9.0"), 24, INADDR_ANY, 0, 100, 0);
+
+	/* kernel flushes the routes of a link that goes down without sending
+	 * RTM_DELROUTE. Platform must notice by refreshing the routes of that
+	 * link, and leave the routes on the other link alone. */
+	nmtstp_link_set_updown (NULL, TRUE, ifindex_down, FALSE);
+	nm_platform_process_events (NM_PLATFORM_GET);
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, ifindex_down);
+	g_assert_cmpint (routes_plat->len, ==, 0);
+	g_clear_pointer (&routes_plat, g_ptr_array_unref);
+
+	routes_plat = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes_plat->len, ==, 1);
+	g_clear_pointer (&routes_plat, g_ptr_array_unref);
+
+	/* kernel keeps IPv4 addresses of a link that is down, and IPv6
+	 * addresses added while it is down. */
+	nmtstp_ip4_address_add (NULL, FALSE, ifindex_down, nmtst_inet4_from_string ("192.168.10.2"), 24,
+	                        nmtst_inet4_from_string ("192.168.10.2"),
+	                        NM_PLATFORM_LIFETIME_PERMANENT, NM_PLATFORM_LIFETIME_PERMANENT, 0, NULL);
+	nmtstp_ip6_address_add (NULL, FALSE, ifindex_down, *nmtst_inet6_from_string ("2001:db8:10::2"), 64,
+	                        in6addr_any,
+	                        NM_PLATFORM_LIFETIME_PERMANENT, NM_PLATFORM_LIFETIME_PERMANENT, 0);
+
+	addrs_plat = nmtstp_platform_ip4_address_get_all (NM_PLATFORM_GET, ifindex_down);
+	g_assert_cmpint (addrs_plat->len, ==, 1);
+	g_clear_pointer (&addrs_plat, g_array_unref);
+	addrs_plat = nmtstp_platform_ip6_address_get_all (NM_PLATFORM_GET, ifindex_down);
+	g_assert_cmpint (addrs_plat->len, ==, 1);
+	g_clear_pointer (&addrs_plat, g_array_unref);
+
+	/* deleting the link drops its remaining objects from the cache. */
+	nmtstp_link_del (NULL, TRUE, ifindex_down, IFNAME_DOWN);
+	nm_platform_process_events (NM_PLATFORM_GET);
+	addrs_plat = nmtstp_platform_ip4_address_get_all (NM_PLATFORM_GET, ifindex_down);
+	g_assert_cmpint (addrs_plat->len, ==, 0);
+	g_clear_pointer (&addrs_plat, g_array_unref);
+	addrs_plat = nmtstp_platform_ip6_address_get_all (NM_PLATFORM_GET, ifindex_down);
+	g_assert_cmpint (addrs_plat->len, ==, 0);
+
+	nmtstp_platform_ip4_route_delete (NM_PLATFORM_GET, IFINDEX, nmtst_inet4_from_string ("192.168.8.0"), 24, 100);
+}
+
+/*****************************************************************************/
+
 static void
 test_ip (gconstpointer test_data)
 {
@@ -834,6 +1028,84 @@ again_find_idx:
 
 /*****************************************************************************/
 
+static void
+_many_routes_send (struct nl_sock *sk, int ifindex, guint idx_start, guint n)
+{
+	guint i;
+
+	for (i = idx_start; i < idx_start + n; i++) {
+		nm_auto_nlmsg struct nl_msg *msg = NULL;
+		const struct rtmsg rtmsg = {
+			.rtm_family = AF_INET,
+			.rtm_dst_len = 32,
+			.rtm_table = RT_TABLE_MAIN,
+			.rtm_protocol = RTPROT_STATIC,
+			.rtm_scope = RT_SCOPE_LINK,
+			.rtm_type = RTN_UNICAST,
+		};
+		in_addr_t network = htonl (0x0a000000u + i);
+
+		msg = nlmsg_alloc_simple (RTM_NEWROUTE, NLM_F_CREATE | NLM_F_EXCL);
+		g_assert (msg);
+		g_assert (nlmsg_append (msg, (gpointer) &rtmsg, sizeof (rtmsg), NLMSG_ALIGNTO) >= 0);
+		g_assert (nla_put (msg, RTA_DST, sizeof (network), &network) >= 0);
+		g_assert (nla_put_u32 (msg, RTA_OIF, ifindex) >= 0);
+		g_assert (nl_send_auto (sk, msg) >= 0);
+	}
+}
+
+static void
+test_ip4_route_many_events (gconstpointer test_data)
+{
+	const guint N_ROUTES = GPOINTER_TO_UINT (test_data);
+	const guint BATCH = 1000;
+	const int IFINDEX = nm_platform_link_get_ifindex (NM_PLATFORM_GET, DEVICE_NAME);
+	struct nl_sock *sk_gen;
+	gint64 time_platform = 0;
+	gint64 ts;
+	guint i;
+	gs_unref_ptrarray GPtrArray *routes = NULL;
+
+	if (N_ROUTES > 10000 && nmtst_test_quick ()) {
+		g_print ("Skipping test: don't run long running test %s (NMTST_DEBUG=slow)\n", g_get_prgname () ?: "test-route-linux");
+		g_test_skip ("Skip long running test");
+		return;
+	}
+
+	/* @sk_gen injects RTM_NEWROUTE requests without waiting for ACKs, so
+	 * that the notifications pile up in the socket of NMLinuxPlatform. */
+	sk_gen = nl_socket_alloc ();
+	g_assert (sk_gen);
+	g_assert (!nl_connect (sk_gen, NETLINK_ROUTE));
+	nl_socket_disable_auto_ack (sk_gen);
+
+	nm_platform_process_events (NM_PLATFORM_GET);
+
+	for (i = 0; i < N_ROUTES; i += BATCH) {
+		_many_routes_send (sk_gen, IFINDEX, i, MIN (BATCH, N_ROUTES - i));
+
+		ts = nm_utils_get_monotonic_timestamp_ns ();
+		nm_platform_process_events (NM_PLATFORM_GET);
+		time_platform += nm_utils_get_monotonic_timestamp_ns () - ts;
+	}
+
+	routes = nmtstp_ip4_route_get_all (NM_PLATFORM_GET, IFINDEX);
+	g_assert_cmpint (routes->len, >=, N_ROUTES);
+
+	/* this only reports the throughput of the current receive path. It
+	 * is not a comparison against another implementation. */
+	_LOGI (">>> %u route events: NMPlatform processed %.0f msgs/sec",
+	       N_ROUTES,
+	       (double) N_ROUTES * NM_UTILS_NS_PER_SECOND / MAX (time_platform, 1));
+
+	nl_socket_free (sk_gen);
+
+	nmtstp_run_command_check ("ip route flush dev %s", DEVICE_NAME);
+	nmtstp_wait_for_signal (NM_PLATFORM_GET, 50);
+}
+
+/*****************************************************************************/
+
 NMTstpSetupFunc const _nmtstp_setup_platform_func = SETUP;
 
 void
@@ -850,6 +1122,8 @@ _nmtstp_setup_tests (void)
 	add_test_func ("/route/ip4", test_ip4_route);
 	add_test_func ("/route/ip6", test_ip6_route);
 	add_test_func ("/route/ip4_metric0", test_ip4_route_metric0);
+	add_test_func ("/route/ip4_sync", test_ip4_route_sync);
+	add_test_func ("/route/ip4_batch", test_ip4_route_batch);
 	add_test_func_data ("/route/ip4_options/1", test_ip4_route_options, GINT_TO_POINTER (1));
 	if (nmtstp_is_root_test ())
 		add_test_func_data ("/route/ip4_options/2", test_ip4_route_options, GINT_TO_POINTER (2));
@@ -861,5 +1135,8 @@ _nmtstp_setup_tests (void)
 		add_test_func_data ("/route/ip/1", test_ip, GINT_TO_POINTER (1));
 		add_test_func ("/route/ip_route_get", test_ip_route_get);
 		add_test_func ("/route/ip4_zero_gateway", test_ip4_zero_gateway);
+		add_test_func ("/route/ip4_link_down", test_ip4_route_link_down);
+		add_test_func_data ("/route/ip4_many_events/1", test_ip4_route_many_events, GUINT_TO_POINTER (5000));
+		add_test_func_data ("/route/ip4_many_events/2", test_ip4_route_many_events, GUINT_TO_POINTER (100000));
 	}
 }
@@ -1518,6 +1518,61 @@ check_writable (NMConnection *self, GError **error)
 	return TRUE;
 }
 
+/**
+ * nm_settings_connection_get_settings_for_dbus:
+ * @self: the #NMSettingsConnection
+ *
+ * Serializes the settings of @self like they are returned by the
+ * GetSettings D-Bus method: without secrets, but with the timestamp and
+ * the seen BSSIDs that are tracked outside of the connection.
+ *
+ * Returns: (transfer floating): the settings as a "a{sa{sv}}" variant.
+ */
+GVariant *
+nm_settings_connection_get_settings_for_dbus (NMSettingsConnection *self)
+{
+	gs_unref_object NMConnection *dupl_con = NULL;
+	NMSettingConnection *s_con;
+	NMSettingWireless *s_wifi;
+	guint64 timestamp = 0;
+	gs_free char **bssids = NULL;
+	GVariant *settings;
+
+	g_return_val_if_fail (NM_IS_SETTINGS_CONNECTION (self), NULL);
+
+	dupl_con = nm_simple_connection_new_clone (NM_CONNECTION (self));
+	g_assert (dupl_con);
+
+	/* Timestamp is not updated in connection's 'timestamp' property,
+	 * because it would force updating the connection and in turn
+	 * writing to /etc periodically, which we want to avoid. Rather real
+	 * timestamps are kept track of in a private variable. So, substitute
+	 * timestamp property with the real one here before returning the settings.
+	 */
+	nm_settings_connection_get_timestamp (self, &timestamp);
+	if (timestamp) {
+		s_con = nm_connection_get_setting_connection (NM_CONNECTION (dupl_con));
+		g_assert (s_con);
+		g_object_set (s_con, NM_SETTING_CONNECTION_TIMESTAMP, timestamp, NULL);
+	}
+	/* Seen BSSIDs are not updated in 802-11-wireless 'seen-bssids' property
+	 * from the same reason as timestamp. Thus we put it here to GetSettings()
+	 * return settings too.
+	 */
+	bssids = nm_settings_connection_get_seen_bssids (self);
+	s_wifi = nm_connection_get_setting_wireless (NM_CONNECTION (dupl_con));
+	if (bssids && bssids[0] && s_wifi)
+		g_object_set (s_wifi, NM_SETTING_WIRELESS_SEEN_BSSIDS, bssids, NULL);
+
+	/* Secrets should *never* be returned by the GetSettings method, they
+	 * get returned by the GetSecrets method which can be better
+	 * protected against leakage of secrets to unprivileged callers.
+	 */
+	settings = nm_connection_to_dbus (NM_CONNECTION (dupl_con), NM_CONNECTION_SERIALIZE_NO_SECRETS);
+	g_assert (settings);
+	return settings;
+}
+
 static void
 get_settings_auth_cb (NMSettingsConnection *self,
                       GDBusMethodInvocation *context,
@@ -1528,47 +1583,9 @@ get_settings_auth_cb (NMSettingsConnection *self,
 	if (error)
 		g_dbus_method_invocation_return_gerror (context, error);
 	else {
-		GVariant *settings;
-		NMConnection *dupl_con;
-		NMSettingConnection *s_con;
-		NMSettingWireless *s_wifi;
-		guint64 timestamp = 0;
-		char **bssids;
-
-		dupl_con = nm_simple_connection_new_clone (NM_CONNECTION (self));
-		g_assert (dupl_con);
-
-		/* Timestamp is not updated in connection's 'timestamp' property,
-		 * because it would force updating the connection and in turn
-		 * writing to /etc periodically, which we want to avoid. Rather real
-		 * timestamps are kept track of in a private variable. So, substitute
-		 * timestamp property with the real one here before returning the settings.
-		 */
-		nm_settings_connection_get_timestamp (self, &timestamp);
-		if (timestamp) {
-			s_con = nm_connection_get_setting_connection (NM_CONNECTION (dupl_con));
-			g_assert (s_con);
-			g_object_set (s_con, NM_SETTING_CONNECTION_TIMESTAMP, timestamp, NULL);
-		}
-		/* Seen BSSIDs are not updated in 802-11-wireless 'seen-bssids' property
-		 * from the same reason as timestamp. Thus we put it here to GetSettings()
-		 * return settings too.
-		 */
-		bssids = nm_settings_connection_get_seen_bssids (self);
-		s_wifi = nm_connection_get_setting_wireless (NM_CONNECTION (dupl_con));
-		if (bssids && bssids[0] && s_wifi)
-			g_object_set (s_wifi, NM_SETTING_WIRELESS_SEEN_BSSIDS, bssids, NULL);
-		g_free (bssids);
-
-		/* Secrets should *never* be returned by the GetSettings method, they
-		 * get returned by the GetSecrets method which can be better
-		 * protected against leakage of secrets to unprivileged callers.
-		 */
-		settings = nm_connection_to_dbus (NM_CONNECTION (dupl_con), NM_CONNECTION_SERIALIZE_NO_SECRETS);
-		g_assert (settings);
 		g_dbus_method_invocation_return_value (context,
-		                                       g_variant_new ("(@a{sa{sv}})", settings));
-		g_object_unref (dupl_con);
+		                                       g_variant_new ("(@a{sa{sv}})",
+		                                                      nm_settings_connection_get_settings_for_dbus (self)));
 	}
 }
 
@@ -124,6 +124,10 @@ typedef struct {
 	gboolean connections_loaded;
 	GHashTable *connections;
 	NMSettingsConnection **connections_cached_list;
+
+	/* The connections indexed by their interface-name, built on demand.
+	 * Connections without interface-name are indexed by "". */
+	GHashTable *connections_by_ifname;
 	GSList *unmanaged_specs;
 	GSList *unrecognized_specs;
 
@@ -286,6 +290,83 @@ impl_settings_list_connections (NMSettings *self,
 	g_ptr_array_unref (connections);
 }
 
+/**
+ * nm_settings_get_all_settings_for_subject:
+ * @connections: a %NULL terminated list of connections
+ * @subject: the requesting subject
+ *
+ * Returns: (transfer floating): an "a{oa{sa{sv}}}" variant with the
+ *   settings of those connections in @connections that @subject is
+ *   allowed to see, keyed by their D-Bus path.
+ */
+GVariant *
+nm_settings_get_all_settings_for_subject (NMSettingsConnection *const*connections,
+                                          NMAuthSubject *subject)
+{
+	GVariantBuilder builder;
+	guint i;
+
+	g_return_val_if_fail (connections, NULL);
+	g_return_val_if_fail (NM_IS_AUTH_SUBJECT (subject), NULL);
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{oa{sa{sv}}}"));
+	for (i = 0; connections[i]; i++) {
+		NMSettingsConnection *connection = connections[i];
+
+		/* like GetSettings, silently skip connections that the caller cannot see. */
+		if (!nm_auth_is_subject_in_acl (NM_CONNECTION (connection), subject, NULL))
+			continue;
+
+		g_variant_builder_add (&builder,
+		                       "{o@a{sa{sv}}}",
+		                       nm_connection_get_path (NM_CONNECTION (connection)),
+		                       nm_settings_connection_get_settings_for_dbus (connection));
+	}
+	return g_variant_builder_end (&builder);
+}
+
+static void
+impl_settings_get_all_settings (NMSettings *self,
+                                GDBusMethodInvocation *context,
+                                const char *const*connections)
+{
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	gs_unref_object NMAuthSubject *subject = NULL;
+	gs_free NMSettingsConnection **list = NULL;
+	GVariant *all_settings;
+	guint i, n;
+
+	subject = nm_auth_subject_new_unix_process_from_context (context);
+	if (!subject) {
+		g_dbus_method_invocation_return_error_literal (context,
+		                                               NM_SETTINGS_ERROR,
+		                                               NM_SETTINGS_ERROR_PERMISSION_DENIED,
+		                                               "Unable to determine UID of request.");
+		return;
+	}
+
+	if (!connections || !connections[0]) {
+		all_settings = nm_settings_get_all_settings_for_subject (nm_settings_get_connections (self, NULL),
+		                                                         subject);
+	} else {
+		list = g_new (NMSettingsConnection *, g_strv_length ((char **) connections) + 1);
+		for (i = 0, n = 0; connections[i]; i++) {
+			NMSettingsConnection *connection;
+
+			/* unknown paths are omitted from the result, just like
+			 * invisible connections. */
+			connection = g_hash_table_lookup (priv->connections, connections[i]);
+			if (connection)
+				list[n++] = connection;
+		}
+		list[n] = NULL;
+		all_settings = nm_settings_get_all_settings_for_subject (list, subject);
+	}
+
+	g_dbus_method_invocation_return_value (context,
+	                                       g_variant_new ("(@a{oa{sa{sv}}})", all_settings));
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
@@ -403,6 +484,95 @@ nm_settings_get_connections (NMSettings *self, guint *out_len)
 	return v;
 }
 
+static void
+_connections_cached_clear (NMSettings *self)
+{
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+
+	g_clear_pointer (&priv->connections_cached_list, g_free);
+	g_clear_pointer (&priv->connections_by_ifname, g_hash_table_unref);
+}
+
+/**
+ * nm_settings_get_connections_by_ifname:
+ * @self: the #NMSettings
+ * @ifname: (allow-none): the interface name
+ * @out_len: (out): (allow-none): returns the number of returned
+ *   connections.
+ *
+ * A connection that has the interface-name property set is only
+ * compatible with a device of that name. Hence, the candidates for
+ * a device are the connections returned for the device's interface
+ * name and the ones returned for %NULL.
+ *
+ * Returns: (transfer-none): the NULL terminated list of connections
+ * whose interface-name is @ifname, or which have no interface-name,
+ * if @ifname is %NULL. Like for nm_settings_get_connections(), the
+ * list is cached internally and only valid until the next NMSettings
+ * operation.
+ */
+NMSettingsConnection *const*
+nm_settings_get_connections_by_ifname (NMSettings *self, const char *ifname, guint *out_len)
+{
+	NMSettingsPrivate *priv;
+
+	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
+
+	priv = NM_SETTINGS_GET_PRIVATE (self);
+
+	if (G_UNLIKELY (!priv->connections_by_ifname)) {
+		NMSettingsConnection *const*list = nm_settings_get_connections (self, NULL);
+
+		priv->connections_by_ifname = nm_utils_connections_index_by_ifname ((NMConnection *const*) list);
+	}
+
+	return (NMSettingsConnection *const*) nm_utils_connections_index_lookup (priv->connections_by_ifname,
+	                                                                         ifname,
+	                                                                         out_len);
+}
+
+static NMSettingsConnection **
+_connections_clone (NMSettings *self,
+                    NMSettingsConnection *const*list_a,
+                    guint len_a,
+                    NMSettingsConnection *const*list_b,
+                    guint len_b,
+                    guint *out_len,
+                    NMSettingsConnectionFilterFunc func,
+                    gpointer func_data,
+                    GCompareDataFunc sort_compare_func,
+                    gpointer sort_data)
+{
+	NMSettingsConnection **list;
+	guint len, i, j;
+
+	len = len_a + len_b;
+	list = g_new (NMSettingsConnection *, ((gsize) len + 1));
+	if (func) {
+		for (i = 0, j = 0; i < len; i++) {
+			NMSettingsConnection *con = i < len_a ? list_a[i] : list_b[i - len_a];
+
+			if (func (self, con, func_data))
+				list[j++] = con;
+		}
+		list[j] = NULL;
+		len = j;
+	} else {
+		memcpy (list, list_a, sizeof (list[0]) * len_a);
+		if (len_b)
+			memcpy (&list[len_a], list_b, sizeof (list[0]) * len_b);
+		list[len] = NULL;
+	}
+
+	if (   len > 1
+	    && sort_compare_func) {
+		g_qsort_with_data (list, len, sizeof (NMSettingsConnection *),
+		                   sort_compare_func, sort_data);
+	}
+	NM_SET_OUT (out_len, len);
+	return list;
+}
+
 /**
  * nm_settings_get_connections_clone:
  * @self: the #NMSetting
@@ -429,8 +599,10 @@ nm_settings_get_connections_clone (NMSettings *self,
                                    gpointer sort_data)
 {
 	NMSettingsConnection *const*list_cached;
-	NMSettingsConnection **list;
-	guint len, i, j;
+	guint len;
+#if NM_MORE_ASSERTS
+	guint i;
+#endif
 
 	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
 
@@ -443,24 +615,52 @@ nm_settings_get_connections_clone (NMSettings *self,
 	nm_assert (!list_cached[i]);
 #endif
 
-	list = g_new (NMSettingsConnection *, ((gsize) len + 1));
-	if (func) {
-		for (i = 0, j = 0; i < len; i++) {
-			if (func (self, list_cached[i], func_data))
-				list[j++] = list_cached[i];
-		}
-		list[j] = NULL;
-		len = j;
-	} else
-		memcpy (list, list_cached, sizeof (list[0]) * ((gsize) len + 1));
+	return _connections_clone (self, list_cached, len, NULL, 0, out_len,
+	                           func, func_data, sort_compare_func, sort_data);
+}
 
-	if (   len > 1
-	    && sort_compare_func) {
-		g_qsort_with_data (list, len, sizeof (NMSettingsConnection *),
-		                   sort_compare_func, sort_data);
+/**
+ * nm_settings_get_connections_clone_for_ifname:
+ * @self: the #NMSetting
+ * @ifname: (allow-none): the interface name of a device, or %NULL
+ * @out_len: (allow-none): optional output argument
+ * @func: caller-supplied function for filtering connections
+ * @func_data: caller-supplied data passed to @func
+ * @sort_compare_func: (allow-none): optional function pointer for
+ *   sorting the returned list.
+ * @sort_data: user data for @sort_compare_func.
+ *
+ * Like nm_settings_get_connections_clone(), but if @ifname is given, only
+ * consider connections that are not bound to a different interface name.
+ * See nm_settings_get_connections_by_ifname().
+ *
+ * Returns: (transfer container) (element-type NMSettingsConnection):
+ *   an NULL terminated array of #NMSettingsConnection objects.
+ */
+NMSettingsConnection **
+nm_settings_get_connections_clone_for_ifname (NMSettings *self,
+                                              const char *ifname,
+                                              guint *out_len,
+                                              NMSettingsConnectionFilterFunc func,
+                                              gpointer func_data,
+                                              GCompareDataFunc sort_compare_func,
+                                              gpointer sort_data)
+{
+	NMSettingsConnection *const*list_a;
+	NMSettingsConnection *const*list_b;
+	guint len_a, len_b;
+
+	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
+
+	if (!ifname || !ifname[0]) {
+		return nm_settings_get_connections_clone (self, out_len, func, func_data,
+		                                          sort_compare_func, sort_data);
 	}
-	NM_SET_OUT (out_len, len);
-	return list;
+
+	list_a = nm_settings_get_connections_by_ifname (self, NULL, &len_a);
+	list_b = nm_settings_get_connections_by_ifname (self, ifname, &len_b);
+	return _connections_clone (self, list_a, len_a, list_b, len_b, out_len,
+	                           func, func_data, sort_compare_func, sort_data);
 }
 
 NMSettingsConnection *
@@ -804,6 +1004,16 @@ connection_updated (NMSettingsConnection *connection, gboolean by_user, gpointer
 	               by_user);
 }
 
+static void
+connection_changed (NMSettingsConnection *connection, gpointer user_data)
+{
+	NMSettings *self = NM_SETTINGS (user_data);
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+
+	/* the interface-name might have changed. */
+	g_clear_pointer (&priv->connections_by_ifname, g_hash_table_unref);
+}
+
 static void
 connection_flags_changed (NMSettingsConnection *connection,
                           GParamSpec *pspec,
@@ -833,6 +1043,7 @@ connection_removed (NMSettingsConnection *connection, gpointer user_data)
 
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_removed), self);
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_updated), self);
+	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_changed), self);
 	g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_flags_changed), self);
 	if (!priv->startup_complete)
 		g_signal_handlers_disconnect_by_func (connection, G_CALLBACK (connection_ready_changed), self);
@@ -840,7 +1051,7 @@ connection_removed (NMSettingsConnection *connection, gpointer user_data)
 
 	/* Forget about the connection internally */
 	g_hash_table_remove (priv->connections, (gpointer) cpath);
-	g_clear_pointer (&priv->connections_cached_list, g_free);
+	_connections_cached_clear (self);
 
 	/* Notify D-Bus */
 	g_signal_emit (self, signals[CONNECTION_REMOVED], 0, connection);
@@ -957,6 +1168,8 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	                        G_CALLBACK (connection_removed), self);
 	g_signal_connect (connection, NM_SETTINGS_CONNECTION_UPDATED_INTERNAL,
 	                  G_CALLBACK (connection_updated), self);
+	g_signal_connect (connection, NM_CONNECTION_CHANGED,
+	                  G_CALLBACK (connection_changed), self);
 	g_signal_connect (connection, "notify::" NM_SETTINGS_CONNECTION_FLAGS,
 	                  G_CALLBACK (connection_flags_changed),
 	                  self);
@@ -974,7 +1187,7 @@ claim_connection (NMSettings *self, NMSettingsConnection *connection)
 	g_hash_table_insert (priv->connections,
 	                     (gpointer) nm_connection_get_path (NM_CONNECTION (connection)),
 	                     g_object_ref (connection));
-	g_clear_pointer (&priv->connections_cached_list, g_free);
+	_connections_cached_clear (self);
 
 	nm_utils_log_connection_diff (NM_CONNECTION (connection), NULL, LOGL_DEBUG, LOGD_CORE, "new connection", "++ ");
 
@@ -1893,7 +2106,7 @@ finalize (GObject *object)
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
 	g_hash_table_destroy (priv->connections);
-	g_clear_pointer (&priv->connections_cached_list, g_free);
+	_connections_cached_clear (self);
 
 	g_slist_free_full (priv->unmanaged_specs, g_free);
 	g_slist_free_full (priv->unrecognized_specs, g_free);
@@ -1991,6 +2204,7 @@ nm_settings_class_init (NMSettingsClass *class)
 	nm_exported_object_class_add_interface (NM_EXPORTED_OBJECT_CLASS (class),
 	                                        NMDBUS_TYPE_SETTINGS_SKELETON,
 	                                        "ListConnections", impl_settings_list_connections,
+	                                        "GetAllSettings", impl_settings_get_all_settings,
 	                                        "GetConnectionByUuid", impl_settings_get_connection_by_uuid,
 	                                        "AddConnection", impl_settings_add_connection,
 	                                        "AddConnectionUnsaved", impl_settings_add_connection_unsaved,
@@ -103,6 +103,18 @@ NMSettingsConnection **nm_settings_get_connections_clone (NMSettings *self,
                                                           GCompareDataFunc sort_compare_func,
                                                           gpointer sort_data);
 
+NMSettingsConnection *const* nm_settings_get_connections_by_ifname (NMSettings *self,
+                                                                    const char *ifname,
+                                                                    guint *out_len);
+
+NMSettingsConnection **nm_settings_get_connections_clone_for_ifname (NMSettings *self,
+                                                                     const char *ifname,
+                                                                     guint *out_len,
+                                                                     NMSettingsConnectionFilterFunc func,
+                                                                     gpointer func_data,
+                                                                     GCompareDataFunc sort_compare_func,
+                                                                     gpointer sort_data);
+
 NMSettingsConnection *nm_settings_add_connection (NMSettings *settings,
                                                   NMConnection *connection,
                                                   gboolean save_to_disk,
@@ -113,6 +125,9 @@ NMSettingsConnection *nm_settings_get_connection_by_path (NMSettings *settings,
 NMSettingsConnection *nm_settings_get_connection_by_uuid (NMSettings *settings,
                                                           const char *uuid);
 
+GVariant *nm_settings_get_all_settings_for_subject (NMSettingsConnection *const*connections,
+                                                    NMAuthSubject *subject);
+
 gboolean nm_settings_has_connection (NMSettings *self, NMSettingsConnection *connection);
 
 const GSList *nm_settings_get_unmanaged_specs (NMSettings *self);
@@ -0,0 +1,275 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include "nms-keyfile-cache.h"
+
+#include <string.h>
+
+#include "nm-core-internal.h"
+#include "nm-simple-connection.h"
+#include "NetworkManagerUtils.h"
+
+/*****************************************************************************/
+
+/* The cache file contains the normalized connections that were read from
+ * keyfiles, serialized as GVariant. It is mapped into memory, and a
+ * connection is only taken from the cache if the keyfile still has
+ * the same device, inode, modification time and size.
+ *
+ * The format is (version, {path: (dev, inode, mtime-nsec, size, connection)}).
+ * The cache is dropped if the version differs. */
+#define CACHE_ENTRY_TYPE  "(ttxta{sa{sv}})"
+#define CACHE_TYPE        "(sa{s" CACHE_ENTRY_TYPE "})"
+
+struct _NMSKeyfileCache {
+	char *filename;
+	GVariant *data;
+
+	/* the entries from the cache file. path::GVariant */
+	GHashTable *old_entries;
+
+	/* the entries for the next version of the cache file. path::GVariant */
+	GHashTable *new_entries;
+
+	bool dirty:1;
+};
+
+/*****************************************************************************/
+
+#define _NMLOG_PREFIX_NAME      "keyfile"
+#define _NMLOG_DOMAIN           LOGD_SETTINGS
+#define _NMLOG(level, ...) \
+    nm_log ((level), _NMLOG_DOMAIN, NULL, NULL, \
+            "%s" _NM_UTILS_MACRO_FIRST (__VA_ARGS__), \
+            _NMLOG_PREFIX_NAME": cache: " \
+            _NM_UTILS_MACRO_REST (__VA_ARGS__))
+
+/*****************************************************************************/
+
+static gint64
+_stat_mtime_nsec (const struct stat *st)
+{
+	return ((gint64) st->st_mtim.tv_sec * NM_UTILS_NS_PER_SECOND) + st->st_mtim.tv_nsec;
+}
+
+/**
+ * nms_keyfile_cache_load:
+ * @filename: the cache file
+ *
+ * Returns: (transfer full): the cache. If @filename does not exist or
+ *   cannot be used, the cache is empty.
+ */
+NMSKeyfileCache *
+nms_keyfile_cache_load (const char *filename)
+{
+	NMSKeyfileCache *cache;
+	gs_free_error GError *error = NULL;
+	GMappedFile *mapped;
+	GBytes *bytes;
+	gs_unref_variant GVariant *entries = NULL;
+	GVariantIter iter;
+	const char *version;
+	const char *path;
+	GVariant *entry;
+
+	cache = g_slice_new0 (NMSKeyfileCache);
+	cache->filename = g_strdup (filename);
+	cache->old_entries = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, (GDestroyNotify) g_variant_unref);
+	cache->new_entries = g_hash_table_new_full (nm_str_hash, g_str_equal, g_free, (GDestroyNotify) g_variant_unref);
+
+	mapped = g_mapped_file_new (filename, FALSE, &error);
+	if (!mapped) {
+		_LOGT ("cannot open %s: %s", filename, error->message);
+		return cache;
+	}
+
+	bytes = g_mapped_file_get_bytes (mapped);
+	g_mapped_file_unref (mapped);
+
+	/* the data is not trusted. GVariant checks it while accessing it. */
+	cache->data = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (CACHE_TYPE), bytes, FALSE));
+	g_bytes_unref (bytes);
+
+	g_variant_get_child (cache->data, 0, "&s", &version);
+	if (!nm_streq (version, VERSION)) {
+		_LOGD ("ignore %s from version \"%s\"", filename, version);
+		g_clear_pointer (&cache->data, g_variant_unref);
+		return cache;
+	}
+
+	entries = g_variant_get_child_value (cache->data, 1);
+	g_variant_iter_init (&iter, entries);
+	while (g_variant_iter_next (&iter, "{&s@" CACHE_ENTRY_TYPE "}", &path, &entry))
+		g_hash_table_insert (cache->old_entries, (gpointer) path, entry);
+
+	_LOGD ("loaded %u entries from %s", g_hash_table_size (cache->old_entries), filename);
+	return cache;
+}
+
+void
+nms_keyfile_cache_free (NMSKeyfileCache *cache)
+{
+	if (!cache)
+		return;
+
+	g_hash_table_unref (cache->new_entries);
+	g_hash_table_unref (cache->old_entries);
+	if (cache->data)
+		g_variant_unref (cache->data);
+	g_free (cache->filename);
+	g_slice_free (NMSKeyfileCache, cache);
+}
+
+/**
+ * nms_keyfile_cache_lookup:
+ * @cache: the cache
+ * @path: the path of the keyfile
+ * @st: the stat() result of @path
+ *
+ * If the keyfile is unchanged since it was added to the cache, return
+ * the cached connection. The entry is kept for the next version of
+ * the cache file.
+ *
+ * Returns: (transfer full): the normalized connection or %NULL.
+ */
+NMConnection *
+nms_keyfile_cache_lookup (NMSKeyfileCache *cache,
+                          const char *path,
+                          const struct stat *st)
+{
+	gs_unref_variant GVariant *dict = NULL;
+	gs_free_error GError *error = NULL;
+	NMConnection *connection;
+	GVariant *entry;
+	guint64 dev, ino, size;
+	gint64 mtime;
+
+	g_return_val_if_fail (cache, NULL);
+	g_return_val_if_fail (path, NULL);
+	g_return_val_if_fail (st, NULL);
+
+	entry = g_hash_table_lookup (cache->old_entries, path);
+	if (!entry)
+		return NULL;
+
+	/* the reader rejects such files. Let it report the error. */
+	if (!S_ISREG (st->st_mode))
+		return NULL;
+	if (   !NM_FLAGS_HAS (nm_utils_get_testing (), NM_UTILS_TEST_NO_KEYFILE_OWNER_CHECK)
+	    && (   (st->st_mode & 0077)
+	        || st->st_uid != 0))
+		return NULL;
+
+	g_variant_get (entry, "(ttxt@a{sa{sv}})", &dev, &ino, &mtime, &size, &dict);
+	if (   dev != (guint64) st->st_dev
+	    || ino != (guint64) st->st_ino
+	    || mtime != _stat_mtime_nsec (st)
+	    || size != (guint64) st->st_size)
+		return NULL;
+
+	connection = nm_simple_connection_new_from_dbus (dict, &error);
+	if (!connection) {
+		_LOGD ("invalid entry for %s: %s", path, error->message);
+		return NULL;
+	}
+
+	g_hash_table_insert (cache->new_entries, g_strdup (path), g_variant_ref (entry));
+	return connection;
+}
+
+/**
+ * nms_keyfile_cache_add:
+ * @cache: the cache
+ * @path: the path of the keyfile
+ * @st: the stat() result of @path, before reading it
+ * @connection: the normalized connection read from @path
+ *
+ * Adds @connection to the next version of the cache file.
+ */
+void
+nms_keyfile_cache_add (NMSKeyfileCache *cache,
+                       const char *path,
+                       const struct stat *st,
+                       NMConnection *connection)
+{
+	GVariant *entry;
+
+	g_return_if_fail (cache);
+	g_return_if_fail (path);
+	g_return_if_fail (st);
+	g_return_if_fail (NM_IS_CONNECTION (connection));
+
+	entry = g_variant_new ("(ttxt@a{sa{sv}})",
+	                       (guint64) st->st_dev,
+	                       (guint64) st->st_ino,
+	                       _stat_mtime_nsec (st),
+	                       (guint64) st->st_size,
+	                       nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+	g_hash_table_insert (cache->new_entries, g_strdup (path), g_variant_ref_sink (entry));
+	cache->dirty = TRUE;
+}
+
+/**
+ * nms_keyfile_cache_save:
+ * @cache: the cache
+ * @error: the error in case of failure
+ *
+ * Writes the entries that were looked up or added to the cache file,
+ * unless nothing changed. As the connections contain secrets, the file
+ * is only readable by root.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+nms_keyfile_cache_save (NMSKeyfileCache *cache,
+                        GError **error)
+{
+	gs_unref_variant GVariant *data = NULL;
+	GVariantBuilder builder;
+	GHashTableIter iter;
+	const char *path;
+	GVariant *entry;
+
+	g_return_val_if_fail (cache, FALSE);
+
+	if (   !cache->dirty
+	    && g_hash_table_size (cache->new_entries) == g_hash_table_size (cache->old_entries))
+		return TRUE;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{s" CACHE_ENTRY_TYPE "}"));
+	g_hash_table_iter_init (&iter, cache->new_entries);
+	while (g_hash_table_iter_next (&iter, (gpointer *) &path, (gpointer *) &entry))
+		g_variant_builder_add (&builder, "{s@" CACHE_ENTRY_TYPE "}", path, entry);
+
+	data = g_variant_ref_sink (g_variant_new ("(sa{s" CACHE_ENTRY_TYPE "})", VERSION, &builder));
+
+	if (!nm_utils_file_set_contents (cache->filename,
+	                                 g_variant_get_data (data),
+	                                 g_variant_get_size (data),
+	                                 0600,
+	                                 error))
+		return FALSE;
+
+	_LOGD ("wrote %u entries to %s", g_hash_table_size (cache->new_entries), cache->filename);
+	cache->dirty = FALSE;
+	return TRUE;
+}
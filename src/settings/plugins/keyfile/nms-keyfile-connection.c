@@ -122,38 +122,46 @@ nms_keyfile_connection_init (NMSKeyfileConnection *connection)
 {
 }
 
-NMSKeyfileConnection *
-nms_keyfile_connection_new (NMConnection *source,
-                            const char *full_path,
-                            GError **error)
+/**
+ * nms_keyfile_connection_read:
+ * @full_path: the keyfile to read
+ * @error: the error in case of failure
+ *
+ * Reads, normalizes and verifies the connection from @full_path.
+ * Different from nms_keyfile_connection_new(), this doesn't create
+ * a settings connection and can be called from a worker thread.
+ *
+ * Returns: (transfer full): the connection read from file.
+ */
+NMConnection *
+nms_keyfile_connection_read (const char *full_path, GError **error)
 {
-	GObject *object;
-	NMConnection *tmp;
-	const char *uuid;
-	gboolean update_unsaved = TRUE;
+	NMConnection *connection;
 
-	g_assert (source || full_path);
+	g_return_val_if_fail (full_path, NULL);
 
-	/* If we're given a connection already, prefer that instead of re-reading */
-	if (source)
-		tmp = g_object_ref (source);
-	else {
-		tmp = nms_keyfile_reader_from_file (full_path, error);
-		if (!tmp)
-			return NULL;
-
-		uuid = nm_connection_get_uuid (NM_CONNECTION (tmp));
-		if (!uuid) {
-			g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
-			             "Connection in file %s had no UUID", full_path);
-			g_object_unref (tmp);
-			return NULL;
-		}
+	connection = nms_keyfile_reader_from_file (full_path, error);
+	if (!connection)
+		return NULL;
 
-		/* If we just read the connection from disk, it's clearly not Unsaved */
-		update_unsaved = FALSE;
+	if (!nm_connection_get_uuid (connection)) {
+		g_set_error (error, NM_SETTINGS_ERROR, NM_SETTINGS_ERROR_INVALID_CONNECTION,
+		             "Connection in file %s had no UUID", full_path);
+		g_object_unref (connection);
+		return NULL;
 	}
 
+	return connection;
+}
+
+static NMSKeyfileConnection *
+_connection_new (NMConnection *tmp,
+                 const char *full_path,
+                 gboolean update_unsaved,
+                 GError **error)
+{
+	GObject *object;
+
 	object = (GObject *) g_object_new (NMS_TYPE_KEYFILE_CONNECTION,
 	                                   NM_SETTINGS_CONNECTION_FILENAME, full_path,
 	                                   NULL);
@@ -171,10 +179,52 @@ nms_keyfile_connection_new (NMConnection *source,
 		object = NULL;
 	}
 
-	g_object_unref (tmp);
 	return (NMSKeyfileConnection *) object;
 }
 
+NMSKeyfileConnection *
+nms_keyfile_connection_new (NMConnection *source,
+                            const char *full_path,
+                            GError **error)
+{
+	gs_unref_object NMConnection *tmp = NULL;
+
+	g_assert (source || full_path);
+
+	/* If we're given a connection already, prefer that instead of re-reading */
+	if (source)
+		return _connection_new (source, full_path, TRUE, error);
+
+	tmp = nms_keyfile_connection_read (full_path, error);
+	if (!tmp)
+		return NULL;
+
+	/* If we just read the connection from disk, it's clearly not Unsaved */
+	return _connection_new (tmp, full_path, FALSE, error);
+}
+
+/**
+ * nms_keyfile_connection_new_from_read:
+ * @read_connection: the connection as returned by nms_keyfile_connection_read()
+ * @full_path: the file from which @read_connection was read
+ * @error: the error in case of failure
+ *
+ * Like nms_keyfile_connection_new() with a %NULL source, but without
+ * reading the file again.
+ *
+ * Returns: the new settings connection.
+ */
+NMSKeyfileConnection *
+nms_keyfile_connection_new_from_read (NMConnection *read_connection,
+                                      const char *full_path,
+                                      GError **error)
+{
+	g_return_val_if_fail (NM_IS_CONNECTION (read_connection), NULL);
+	g_return_val_if_fail (full_path, NULL);
+
+	return _connection_new (read_connection, full_path, FALSE, error);
+}
+
 static void
 nms_keyfile_connection_class_init (NMSKeyfileConnectionClass *keyfile_connection_class)
 {
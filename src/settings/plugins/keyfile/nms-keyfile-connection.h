@@ -36,8 +36,15 @@ typedef struct _NMSKeyfileConnectionClass NMSKeyfileConnectionClass;
 
 GType nms_keyfile_connection_get_type (void);
 
+NMConnection *nms_keyfile_connection_read (const char *full_path,
+                                           GError **error);
+
 NMSKeyfileConnection *nms_keyfile_connection_new (NMConnection *source,
                                                   const char *filename,
                                                   GError **error);
 
+NMSKeyfileConnection *nms_keyfile_connection_new_from_read (NMConnection *read_connection,
+                                                            const char *full_path,
+                                                            GError **error);
+
 #endif /* __NMS_KEYFILE_CONNECTION_H__ */
@@ -36,18 +36,26 @@
 #include "nm-utils.h"
 #include "nm-config.h"
 #include "nm-core-internal.h"
+#include "nm-meta-setting.h"
+#include "crypto.h"
+#include "NetworkManagerUtils.h"
 
 #include "settings/nm-settings-plugin.h"
 
 #include "nms-keyfile-connection.h"
 #include "nms-keyfile-writer.h"
 #include "nms-keyfile-utils.h"
+#include "nms-keyfile-cache.h"
 
 /*****************************************************************************/
 
 typedef struct {
 	GHashTable *connections;  /* uuid::connection */
 
+	/* while reading all connections, the results of the parsing
+	 * (path::ReadResult). */
+	GHashTable *read_results;
+
 	gboolean initialized;
 	GFileMonitor *monitor;
 	gulong monitor_id;
@@ -113,6 +121,41 @@ remove_connection (NMSKeyfilePlugin *self, NMSKeyfileConnection *connection)
 	g_return_if_fail (removed);
 }
 
+/* If we load more files than this, parse them in worker threads. */
+#define READ_PARALLEL_MIN_FILES 32
+
+/* The maximum number of worker threads when load-threads is not configured. */
+#define READ_PARALLEL_MAX_THREADS 8
+
+typedef struct {
+	const char *path;
+	NMConnection *connection;
+	GError *error;
+	bool cached;
+} ReadResult;
+
+static NMSKeyfileConnection *
+_connection_new (NMSKeyfilePlugin *self,
+                 NMConnection *source,
+                 const char *full_path,
+                 GError **error)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	ReadResult *result;
+
+	if (   !source
+	    && priv->read_results
+	    && (result = g_hash_table_lookup (priv->read_results, full_path))) {
+		if (!result->connection) {
+			g_propagate_error (error, g_steal_pointer (&result->error));
+			return NULL;
+		}
+		return nms_keyfile_connection_new_from_read (result->connection, full_path, error);
+	}
+
+	return nms_keyfile_connection_new (source, full_path, error);
+}
+
 static NMSKeyfileConnection *
 find_by_path (NMSKeyfilePlugin *self, const char *path)
 {
@@ -182,7 +225,7 @@ update_connection (NMSKeyfilePlugin *self,
 	if (full_path)
 		_LOGD ("loading from file \"%s\"...", full_path);
 
-	connection_new = nms_keyfile_connection_new (source, full_path, &local);
+	connection_new = _connection_new (self, source, full_path, &local);
 	if (!connection_new) {
 		/* Error; remove the connection */
 		if (source)
@@ -391,24 +434,131 @@ _paths_from_connections (GHashTable *connections)
 	return paths;
 }
 
+typedef struct {
+	char *path;
+	struct stat st;
+	bool st_valid;
+	bool loaded;
+} FileInfo;
+
+static void
+_file_info_clear (gpointer data)
+{
+	g_free (((FileInfo *) data)->path);
+}
+
 static int
-_sort_paths (const char **f1, const char **f2, GHashTable *paths)
+_sort_paths (gconstpointer a, gconstpointer b)
 {
-	struct stat st;
-	gboolean c1, c2;
-	gint64 m1, m2;
+	const FileInfo *f1 = a;
+	const FileInfo *f2 = b;
+
+	if (f1->loaded != f2->loaded)
+		return f1->loaded ? -1 : 1;
+
+	if (f1->st_valid != f2->st_valid)
+		return f1->st_valid ? -1 : 1;
+
+	if (   f1->st_valid
+	    && f1->st.st_mtime != f2->st.st_mtime)
+		return f1->st.st_mtime > f2->st.st_mtime ? -1 : 1;
+
+	return strcmp (f1->path, f2->path);
+}
+
+static void
+_read_result_free (gpointer data)
+{
+	ReadResult *result = data;
+
+	if (result->connection)
+		g_object_unref (result->connection);
+	g_clear_error (&result->error);
+	g_slice_free (ReadResult, result);
+}
+
+static void
+_read_worker (gpointer data, gpointer user_data)
+{
+	ReadResult *result = data;
+
+	result->connection = nms_keyfile_connection_read (result->path, &result->error);
+}
+
+static guint
+_read_threads_get (NMSKeyfilePlugin *self, guint n_files)
+{
+	NMSKeyfilePluginPrivate *priv = NMS_KEYFILE_PLUGIN_GET_PRIVATE (self);
+	gint64 n_threads;
+
+	n_threads = nm_config_data_get_value_int64 (nm_config_get_data_orig (priv->config),
+	                                            NM_CONFIG_KEYFILE_GROUP_KEYFILE,
+	                                            NM_CONFIG_KEYFILE_KEY_KEYFILE_LOAD_THREADS,
+	                                            10, 0, 256, 0);
+	if (n_threads == 0) {
+		if (n_files < READ_PARALLEL_MIN_FILES)
+			return 1;
+		n_threads = MIN (g_get_num_processors (), READ_PARALLEL_MAX_THREADS);
+	}
+	return MIN (n_threads, n_files);
+}
 
-	c1 = !!g_hash_table_contains (paths, *f1);
-	c2 = !!g_hash_table_contains (paths, *f2);
-	if (c1 != c2)
-		return c1 ? -1 : 1;
+/* Take the unchanged files from @cache and parse the others, in a pool
+ * of worker threads if @n_threads is larger than one. The results are
+ * consumed by update_connection(), which still runs on the main thread
+ * in the order of @files. */
+static GHashTable *
+_read_files (GArray *files, NMSKeyfileCache *cache, guint n_threads)
+{
+	GHashTable *read_results;
+	ReadResult *result;
+	GThreadPool *pool = NULL;
+	GError *error = NULL;
+	guint i;
 
-	m1 = stat (*f1, &st) == 0 ? (gint64) st.st_mtime : G_MININT64;
-	m2 = stat (*f2, &st) == 0 ? (gint64) st.st_mtime : G_MININT64;
-	if (m1 != m2)
-		return m1 > m2 ? -1 : 1;
+	if (n_threads > 1) {
+		/* libnm-core registers the setting types and initializes the
+		 * crypto backend (to verify 802.1x certificates) lazily and not
+		 * thread-safe. Do that here, before the workers use them concurrently. */
+		for (i = 0; i < _NM_META_SETTING_TYPE_NUM; i++)
+			g_type_class_unref (g_type_class_ref (nm_meta_setting_infos[i].get_setting_gtype ()));
+		nm_utils_get_testing ();
+		crypto_init (NULL);
+
+		pool = g_thread_pool_new (_read_worker, NULL, n_threads, TRUE, &error);
+		if (!pool) {
+			_LOGW ("cannot create threads for reading connections: %s", error->message);
+			g_clear_error (&error);
+		}
+	}
+
+	read_results = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, _read_result_free);
+	for (i = 0; i < files->len; i++) {
+		const FileInfo *file = &g_array_index (files, FileInfo, i);
+
+		result = g_slice_new0 (ReadResult);
+		result->path = file->path;
+		g_hash_table_insert (read_results, (gpointer) result->path, result);
 
-	return strcmp (*f1, *f2);
+		if (file->st_valid) {
+			result->connection = nms_keyfile_cache_lookup (cache, file->path, &file->st);
+			if (result->connection) {
+				result->cached = TRUE;
+				continue;
+			}
+		}
+
+		if (pool)
+			g_thread_pool_push (pool, result, NULL);
+		else
+			_read_worker (result, NULL);
+	}
+
+	/* wait for all files to be parsed. */
+	if (pool)
+		g_thread_pool_free (pool, FALSE, TRUE);
+
+	return read_results;
 }
 
 static void
@@ -424,8 +574,12 @@ read_connections (NMSettingsPlugin *config)
 	NMSKeyfileConnection *connection;
 	GPtrArray *dead_connections = NULL;
 	guint i;
-	GPtrArray *filenames;
+	GArray *files;
 	GHashTable *paths;
+	guint n_threads;
+	guint n_cached = 0;
+	gint64 start_ns;
+	NMSKeyfileCache *cache;
 
 	dir = g_dir_open (nms_keyfile_utils_get_path (), 0, &error);
 	if (!dir) {
@@ -436,15 +590,9 @@ read_connections (NMSettingsPlugin *config)
 		return;
 	}
 
-	alive_connections = g_hash_table_new (nm_direct_hash, NULL);
+	start_ns = nm_utils_get_monotonic_timestamp_ns ();
 
-	filenames = g_ptr_array_new_with_free_func (g_free);
-	while ((item = g_dir_read_name (dir))) {
-		if (nms_keyfile_utils_should_ignore_file (item))
-			continue;
-		g_ptr_array_add (filenames, g_build_filename (nms_keyfile_utils_get_path (), item, NULL));
-	}
-	g_dir_close (dir);
+	alive_connections = g_hash_table_new (nm_direct_hash, NULL);
 
 	/* While reloading, we don't replace connections that we already loaded while
 	 * iterating over the files.
@@ -453,15 +601,64 @@ read_connections (NMSettingsPlugin *config)
 	 * time prefering older files.
 	 */
 	paths = _paths_from_connections (priv->connections);
-	g_ptr_array_sort_with_data (filenames, (GCompareDataFunc) _sort_paths, paths);
+
+	files = g_array_new (FALSE, FALSE, sizeof (FileInfo));
+	g_array_set_clear_func (files, _file_info_clear);
+	while ((item = g_dir_read_name (dir))) {
+		FileInfo *file;
+
+		if (nms_keyfile_utils_should_ignore_file (item))
+			continue;
+
+		g_array_set_size (files, files->len + 1);
+		file = &g_array_index (files, FileInfo, files->len - 1);
+		file->path = g_build_filename (nms_keyfile_utils_get_path (), item, NULL);
+		file->st_valid = stat (file->path, &file->st) == 0;
+		file->loaded = g_hash_table_contains (paths, file->path);
+	}
+	g_dir_close (dir);
+
 	g_hash_table_destroy (paths);
+	g_array_sort (files, _sort_paths);
 
-	for (i = 0; i < filenames->len; i++) {
-		connection = update_connection (self, NULL, filenames->pdata[i], NULL, FALSE, alive_connections, NULL);
+	cache = nms_keyfile_cache_load (NMS_KEYFILE_CACHE_FILE);
+
+	n_threads = _read_threads_get (self, files->len);
+	priv->read_results = _read_files (files, cache, n_threads);
+
+	for (i = 0; i < files->len; i++) {
+		connection = update_connection (self, NULL, g_array_index (files, FileInfo, i).path, NULL, FALSE, alive_connections, NULL);
 		if (connection)
 			g_hash_table_add (alive_connections, connection);
 	}
-	g_ptr_array_free (filenames, TRUE);
+
+	/* remember the newly parsed files for the next time. */
+	for (i = 0; i < files->len; i++) {
+		const FileInfo *file = &g_array_index (files, FileInfo, i);
+		ReadResult *result;
+
+		result = g_hash_table_lookup (priv->read_results, file->path);
+		if (!result->connection)
+			continue;
+		if (result->cached)
+			n_cached++;
+		else if (file->st_valid)
+			nms_keyfile_cache_add (cache, file->path, &file->st, result->connection);
+	}
+	if (!nms_keyfile_cache_save (cache, &error)) {
+		_LOGD ("cannot write cache: %s", error->message);
+		g_clear_error (&error);
+	}
+	nms_keyfile_cache_free (cache);
+
+	_LOGD ("read %u files (%u cached) in %"G_GINT64_FORMAT" msec using %u threads",
+	       files->len,
+	       n_cached,
+	       (nm_utils_get_monotonic_timestamp_ns () - start_ns) / NM_UTILS_NS_PER_MSEC,
+	       n_threads);
+
+	g_clear_pointer (&priv->read_results, g_hash_table_destroy);
+	g_array_free (files, TRUE);
 
 	g_hash_table_iter_init (&iter, priv->connections);
 	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &connection)) {
@@ -0,0 +1,344 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager system settings service - keyfile plugin
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "nm-core-internal.h"
+#include "nm-simple-connection.h"
+
+#include "settings/plugins/keyfile/nms-keyfile-cache.h"
+
+#include "nm-test-utils-core.h"
+
+#define CACHE_FILE    TEST_SCRATCH_DIR "/test-keyfile-cache"
+#define KEYFILE_PATH  "/etc/NetworkManager/system-connections/Test_Wired"
+
+/*****************************************************************************/
+
+/* the cache never calls stat() itself, so the tests can pretend
+ * that the keyfile is owned by root. */
+static void
+_stat_init (struct stat *st)
+{
+	memset (st, 0, sizeof (*st));
+	st->st_mode = S_IFREG | 0600;
+	st->st_uid = 0;
+	st->st_gid = 0;
+	st->st_dev = 0x801;
+	st->st_ino = 4242;
+	st->st_size = 321;
+	st->st_mtim.tv_sec = 1500000000;
+	st->st_mtim.tv_nsec = 123456789;
+}
+
+static NMConnection *
+_connection_new (void)
+{
+	NMConnection *connection;
+
+	connection = nmtst_create_minimal_connection ("Test Wired", NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	nmtst_connection_normalize (connection);
+	return connection;
+}
+
+/* writes a cache file like nms_keyfile_cache_save() but with
+ * an arbitrary version and connection. */
+static void
+_write_cache_file (const char *version, const struct stat *st, GVariant *connection_dict)
+{
+	gs_unref_variant GVariant *data = NULL;
+	GVariantBuilder builder;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{s(ttxta{sa{sv}})}"));
+	g_variant_builder_add (&builder, "{s(ttxt@a{sa{sv}})}",
+	                       KEYFILE_PATH,
+	                       (guint64) st->st_dev,
+	                       (guint64) st->st_ino,
+	                       (gint64) st->st_mtim.tv_sec * NM_UTILS_NS_PER_SECOND + st->st_mtim.tv_nsec,
+	                       (guint64) st->st_size,
+	                       connection_dict);
+	data = g_variant_ref_sink (g_variant_new ("(sa{s(ttxta{sa{sv}})})", version, &builder));
+
+	nmtst_assert_success (g_file_set_contents (CACHE_FILE,
+	                                           g_variant_get_data (data),
+	                                           g_variant_get_size (data),
+	                                           NULL),
+	                      NULL);
+}
+
+static void
+_write_cache_file_raw (const void *contents, gsize len)
+{
+	nmtst_assert_success (g_file_set_contents (CACHE_FILE, contents, len, NULL), NULL);
+}
+
+/* adds @connection with @st to a new cache and saves it. */
+static void
+_save_cache (const struct stat *st, NMConnection *connection)
+{
+	NMSKeyfileCache *cache;
+	GError *error = NULL;
+
+	unlink (CACHE_FILE);
+
+	cache = nms_keyfile_cache_load (CACHE_FILE);
+	g_assert (cache);
+	g_assert (!nms_keyfile_cache_lookup (cache, KEYFILE_PATH, st));
+	nms_keyfile_cache_add (cache, KEYFILE_PATH, st, connection);
+	nmtst_assert_success (nms_keyfile_cache_save (cache, &error), error);
+	nms_keyfile_cache_free (cache);
+}
+
+static void
+_assert_hit (const struct stat *st, NMConnection *expected)
+{
+	NMSKeyfileCache *cache;
+	gs_unref_object NMConnection *connection = NULL;
+
+	cache = nms_keyfile_cache_load (CACHE_FILE);
+	connection = nms_keyfile_cache_lookup (cache, KEYFILE_PATH, st);
+	g_assert (NM_IS_CONNECTION (connection));
+	nmtst_assert_connection_equals (connection, FALSE, expected, FALSE);
+	nms_keyfile_cache_free (cache);
+}
+
+static void
+_assert_miss (const struct stat *st)
+{
+	NMSKeyfileCache *cache;
+
+	cache = nms_keyfile_cache_load (CACHE_FILE);
+	g_assert (!nms_keyfile_cache_lookup (cache, KEYFILE_PATH, st));
+	nms_keyfile_cache_free (cache);
+}
+
+/*****************************************************************************/
+
+static void
+test_hit_and_stale (void)
+{
+	gs_unref_object NMConnection *connection = _connection_new ();
+	struct stat st, st2;
+
+	_stat_init (&st);
+	_save_cache (&st, connection);
+
+	_assert_hit (&st, connection);
+
+	st2 = st;
+	st2.st_mtim.tv_nsec++;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_mtim.tv_sec--;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_size++;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_ino++;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_dev++;
+	_assert_miss (&st2);
+
+	/* other metadata doesn't matter. */
+	st2 = st;
+	st2.st_atim.tv_sec++;
+	st2.st_ctim.tv_sec++;
+	st2.st_nlink = 2;
+	_assert_hit (&st2, connection);
+
+	unlink (CACHE_FILE);
+}
+
+static void
+test_save_keeps_looked_up (void)
+{
+	gs_unref_object NMConnection *connection = _connection_new ();
+	NMSKeyfileCache *cache;
+	gs_unref_object NMConnection *c = NULL;
+	GError *error = NULL;
+	struct stat st, st2;
+
+	_stat_init (&st);
+	_save_cache (&st, connection);
+
+	/* a hit is written to the next version of the file... */
+	cache = nms_keyfile_cache_load (CACHE_FILE);
+	c = nms_keyfile_cache_lookup (cache, KEYFILE_PATH, &st);
+	g_assert (c);
+	nmtst_assert_success (nms_keyfile_cache_save (cache, &error), error);
+	nms_keyfile_cache_free (cache);
+	_assert_hit (&st, connection);
+
+	/* ... but an entry that wasn't looked up or is stale is dropped. */
+	st2 = st;
+	st2.st_size++;
+	cache = nms_keyfile_cache_load (CACHE_FILE);
+	g_assert (!nms_keyfile_cache_lookup (cache, KEYFILE_PATH, &st2));
+	nmtst_assert_success (nms_keyfile_cache_save (cache, &error), error);
+	nms_keyfile_cache_free (cache);
+	_assert_miss (&st);
+
+	unlink (CACHE_FILE);
+}
+
+static void
+test_version_mismatch (void)
+{
+	gs_unref_object NMConnection *connection = _connection_new ();
+	struct stat st;
+
+	_stat_init (&st);
+
+	_write_cache_file (VERSION, &st, nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+	_assert_hit (&st, connection);
+
+	_write_cache_file ("0.9.10", &st, nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+	_assert_miss (&st);
+
+	_write_cache_file ("", &st, nm_connection_to_dbus (connection, NM_CONNECTION_SERIALIZE_ALL));
+	_assert_miss (&st);
+
+	unlink (CACHE_FILE);
+}
+
+static void
+test_corrupted (void)
+{
+	gs_unref_object NMConnection *connection = _connection_new ();
+	gs_unref_variant GVariant *wrong_type = NULL;
+	gs_free char *contents = NULL;
+	gsize len;
+	struct stat st;
+	guint i;
+
+	_stat_init (&st);
+
+	/* the file doesn't exist. */
+	unlink (CACHE_FILE);
+	_assert_miss (&st);
+
+	/* empty file. */
+	_write_cache_file_raw ("", 0);
+	_assert_miss (&st);
+
+	/* a keyfile instead of a serialized GVariant. */
+	_write_cache_file_raw ("[connection]\nid=Test Wired\n", NM_STRLEN ("[connection]\nid=Test Wired\n"));
+	_assert_miss (&st);
+
+	/* a GVariant of another type. */
+	wrong_type = g_variant_ref_sink (g_variant_new ("(su)", VERSION, 5u));
+	_write_cache_file_raw (g_variant_get_data (wrong_type), g_variant_get_size (wrong_type));
+	_assert_miss (&st);
+
+	/* a matching entry whose connection is not valid. */
+	_write_cache_file (VERSION, &st, g_variant_new_array (G_VARIANT_TYPE ("{sa{sv}}"), NULL, 0));
+	_assert_miss (&st);
+
+	/* truncated or garbled versions of a valid file. */
+	_save_cache (&st, connection);
+	nmtst_assert_success (g_file_get_contents (CACHE_FILE, &contents, &len, NULL), NULL);
+	g_assert_cmpint (len, >, 16);
+
+	_write_cache_file_raw (contents, 7);
+	_assert_miss (&st);
+
+	/* which entries survive is undefined, but it must not crash. */
+	_write_cache_file_raw (contents, len / 2);
+	nms_keyfile_cache_free (nms_keyfile_cache_load (CACHE_FILE));
+
+	/* this also garbles the version string at the beginning. */
+	for (i = 0; i < len; i += 3)
+		contents[i] ^= 0x5a;
+	_write_cache_file_raw (contents, len);
+	_assert_miss (&st);
+
+	unlink (CACHE_FILE);
+}
+
+static void
+test_owner_and_mode (void)
+{
+	gs_unref_object NMConnection *connection = _connection_new ();
+	struct stat st, st2;
+
+	_stat_init (&st);
+	_save_cache (&st, connection);
+
+	/* the keyfile reader rejects these files, so the cache must not
+	 * return a connection for them either. */
+	st2 = st;
+	st2.st_uid = 1000;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_mode = S_IFREG | 0640;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_mode = S_IFREG | 0604;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_mode = S_IFDIR | 0700;
+	_assert_miss (&st2);
+
+	st2 = st;
+	st2.st_mode = S_IFLNK | 0600;
+	_assert_miss (&st2);
+
+	/* the group doesn't matter, only the permissions. */
+	st2 = st;
+	st2.st_gid = 1000;
+	st2.st_mode = S_IFREG | 0400;
+	_assert_hit (&st2, connection);
+
+	unlink (CACHE_FILE);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int main (int argc, char **argv)
+{
+	/* unlike test-keyfile, keep the owner check of the keyfiles. */
+	nmtst_init_assert_logging (&argc, &argv, "INFO", "DEFAULT");
+
+	if (g_mkdir_with_parents (TEST_SCRATCH_DIR, 0755) != 0)
+		g_error ("failure to create test directory \"%s\": %s", TEST_SCRATCH_DIR, g_strerror (errno));
+
+	g_test_add_func ("/keyfile/cache/hit_and_stale", test_hit_and_stale);
+	g_test_add_func ("/keyfile/cache/save_keeps_looked_up", test_save_keeps_looked_up);
+	g_test_add_func ("/keyfile/cache/version_mismatch", test_version_mismatch);
+	g_test_add_func ("/keyfile/cache/corrupted", test_corrupted);
+	g_test_add_func ("/keyfile/cache/owner_and_mode", test_owner_and_mode);
+
+	return g_test_run ();
+}
@@ -41,8 +41,10 @@
 /*****************************************************************************/
 
 typedef struct {
-	GDBusProxy *proxy;
-	gulong change_id;
+	char *path;
+
+	/* the properties, or %NULL while they are fetched. */
+	GVariant *props;
 } BssData;
 
 struct _AddNetworkData;
@@ -126,7 +128,8 @@ typedef struct {
 	AssocData *    assoc_data;
 
 	char *         net_path;
-	GHashTable *   bss_proxies;
+	GHashTable *   bss_hash;
+	guint          bss_props_changed_id;
 	char *         current_bss;
 
 	gint32         last_scan; /* timestamp as returned by nm_utils_get_monotonic_timestamp_s() */
@@ -165,6 +168,7 @@ G_DEFINE_TYPE (NMSupplicantInterface, nm_supplicant_interface, G_TYPE_OBJECT)
 /*****************************************************************************/
 
 static void scan_done_emit_signal (NMSupplicantInterface *self);
+static void bss_subscription_clear (NMSupplicantInterface *self);
 
 /*****************************************************************************/
 
@@ -194,121 +198,207 @@ bss_data_destroy (gpointer user_data)
 {
 	BssData *bss_data = user_data;
 
-	nm_clear_g_signal_handler (bss_data->proxy, &bss_data->change_id);
-	g_object_unref (bss_data->proxy);
+	if (bss_data->props)
+		g_variant_unref (bss_data->props);
+	g_free (bss_data->path);
 	g_slice_free (BssData, bss_data);
 }
 
+/* Returns a floating a{sv} with @changed applied to @props. */
+static GVariant *
+bss_props_merge (GVariant *props, GVariant *changed)
+{
+	GVariantBuilder builder;
+	GVariantIter iter;
+	const char *name;
+	GVariant *value;
+
+	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+
+	g_variant_iter_init (&iter, props);
+	while (g_variant_iter_next (&iter, "{&sv}", &name, &value)) {
+		gs_unref_variant GVariant *v_changed = NULL;
+
+		v_changed = g_variant_lookup_value (changed, name, NULL);
+		if (!v_changed)
+			g_variant_builder_add (&builder, "{sv}", name, value);
+		g_variant_unref (value);
+	}
+
+	g_variant_iter_init (&iter, changed);
+	while (g_variant_iter_next (&iter, "{&sv}", &name, &value)) {
+		g_variant_builder_add (&builder, "{sv}", name, value);
+		g_variant_unref (value);
+	}
+
+	return g_variant_builder_end (&builder);
+}
+
 static void
-bss_proxy_properties_changed_cb (GDBusProxy *proxy,
-                                 GVariant *changed_properties,
-                                 char **invalidated_properties,
-                                 gpointer user_data)
+bss_set_props (NMSupplicantInterface *self, BssData *bss_data, GVariant *props)
 {
-	NMSupplicantInterface *self = NM_SUPPLICANT_INTERFACE (user_data);
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
-	if (priv->scanning)
-		priv->last_scan = nm_utils_get_monotonic_timestamp_s ();
+	g_variant_ref_sink (props);
+	if (bss_data->props)
+		g_variant_unref (bss_data->props);
+	bss_data->props = props;
 
 	g_signal_emit (self, signals[BSS_UPDATED], 0,
-	               g_dbus_proxy_get_object_path (proxy),
-	               changed_properties);
+	               bss_data->path,
+	               props);
+
+	if (priv->scan_done_pending)
+		scan_done_emit_signal (self);
 }
 
-static GVariant *
-bss_proxy_get_properties (NMSupplicantInterface *self, GDBusProxy *proxy)
+static void
+bss_subscription_clear (NMSupplicantInterface *self)
 {
-	gs_strfreev char **properties = NULL;
-	GVariantBuilder builder;
-	char **iter;
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
-	iter = properties = g_dbus_proxy_get_cached_property_names (proxy);
+	if (priv->bss_props_changed_id) {
+		g_dbus_connection_signal_unsubscribe (g_dbus_proxy_get_connection (priv->iface_proxy),
+		                                      priv->bss_props_changed_id);
+		priv->bss_props_changed_id = 0;
+	}
+}
 
-	g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
-	if (iter) {
-		while (*iter) {
-			GVariant *copy = g_dbus_proxy_get_cached_property (proxy, *iter);
+/* The BSS of all interfaces share one subscription with the same match
+ * rule, which GDBus adds to the bus only once. Signals for the BSS of
+ * other interfaces are ignored by the lookup. */
+static void
+bss_props_changed_cb (GDBusConnection *connection,
+                      const char *sender_name,
+                      const char *object_path,
+                      const char *interface_name,
+                      const char *signal_name,
+                      GVariant *parameters,
+                      gpointer user_data)
+{
+	NMSupplicantInterface *self = NM_SUPPLICANT_INTERFACE (user_data);
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	gs_unref_variant GVariant *changed_properties = NULL;
+	BssData *bss_data;
+	GVariant *props;
 
-			g_variant_builder_add (&builder, "{sv}", *iter++, copy);
-			g_variant_unref (copy);
-		}
-	}
-	return g_variant_builder_end (&builder);
+	if (!g_variant_is_of_type (parameters, G_VARIANT_TYPE ("(sa{sv}as)")))
+		return;
+
+	bss_data = g_hash_table_lookup (priv->bss_hash, object_path);
+	if (!bss_data)
+		return;
+
+	/* the properties are still being fetched. The result is at least
+	 * as recent as this change. */
+	if (!bss_data->props)
+		return;
+
+	changed_properties = g_variant_get_child_value (parameters, 1);
+
+	if (priv->scanning)
+		priv->last_scan = nm_utils_get_monotonic_timestamp_s ();
+
+	props = g_variant_ref_sink (bss_props_merge (bss_data->props, changed_properties));
+	g_variant_unref (bss_data->props);
+	bss_data->props = props;
+
+	g_signal_emit (self, signals[BSS_UPDATED], 0,
+	               object_path,
+	               changed_properties);
 }
 
+typedef struct {
+	NMSupplicantInterface *self;
+	char *path;
+} BssGetAllData;
+
 static void
-bss_proxy_acquired_cb (GDBusProxy *proxy, GAsyncResult *result, gpointer user_data)
+bss_get_all_cb (GObject *source, GAsyncResult *result, gpointer user_data)
 {
+	BssGetAllData *data = user_data;
 	NMSupplicantInterface *self;
 	NMSupplicantInterfacePrivate *priv;
 	gs_free_error GError *error = NULL;
-	GVariant *props = NULL;
-	const char *object_path;
+	gs_unref_variant GVariant *variant = NULL;
+	gs_unref_variant GVariant *props = NULL;
+	gs_free char *path = data->path;
 	BssData *bss_data;
-	gboolean success;
 
-	success = g_async_initable_init_finish (G_ASYNC_INITABLE (proxy), result, &error);
-	if (   !success
+	self = data->self;
+	g_slice_free (BssGetAllData, data);
+
+	variant = g_dbus_connection_call_finish (G_DBUS_CONNECTION (source), result, &error);
+	if (   !variant
 	    && g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
 		return;
 
-	self = NM_SUPPLICANT_INTERFACE (user_data);
 	priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
-	if (!success) {
-		_LOGD ("failed to acquire BSS proxy: (%s)", error->message);
-		g_hash_table_remove (priv->bss_proxies,
-		                     g_dbus_proxy_get_object_path (proxy));
-		return;
-	}
-
-	object_path = g_dbus_proxy_get_object_path (proxy);
-	bss_data = g_hash_table_lookup (priv->bss_proxies, object_path);
+	bss_data = g_hash_table_lookup (priv->bss_hash, path);
 	if (!bss_data)
 		return;
 
-	bss_data->change_id = g_signal_connect (proxy, "g-properties-changed", G_CALLBACK (bss_proxy_properties_changed_cb), self);
-
-	props = bss_proxy_get_properties (self, proxy);
-	g_signal_emit (self, signals[BSS_UPDATED], 0,
-	               g_dbus_proxy_get_object_path (proxy),
-	               g_variant_ref_sink (props));
-	g_variant_unref (props);
+	if (!variant) {
+		_LOGD ("failed to get BSS properties: (%s)", error->message);
+		g_hash_table_remove (priv->bss_hash, path);
+		if (priv->scan_done_pending)
+			scan_done_emit_signal (self);
+		return;
+	}
 
-	if (priv->scan_done_pending)
-		scan_done_emit_signal (self);
+	props = g_variant_get_child_value (variant, 0);
+	bss_set_props (self, bss_data, props);
 }
 
 static void
-bss_add_new (NMSupplicantInterface *self, const char *object_path)
+bss_add_new (NMSupplicantInterface *self, const char *object_path, GVariant *props)
 {
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
-	GDBusProxy *bss_proxy;
+	BssGetAllData *data;
 	BssData *bss_data;
 
 	g_return_if_fail (object_path != NULL);
 
-	if (g_hash_table_lookup (priv->bss_proxies, object_path))
+	if (props && g_variant_n_children (props) == 0)
+		props = NULL;
+
+	bss_data = g_hash_table_lookup (priv->bss_hash, object_path);
+	if (!bss_data) {
+		bss_data = g_slice_new0 (BssData);
+		bss_data->path = g_strdup (object_path);
+		g_hash_table_insert (priv->bss_hash, bss_data->path, bss_data);
+	} else {
+		/* the properties are known or already being fetched. */
+		if (bss_data->props || !props)
+			return;
+	}
+
+	/* BSSAdded carries all properties. Only fetch them for the BSS that
+	 * we learn about from the BSSs property. */
+	if (props) {
+		bss_set_props (self, bss_data, props);
 		return;
+	}
 
-	bss_proxy = g_object_new (G_TYPE_DBUS_PROXY,
-	                          "g-bus-type", G_BUS_TYPE_SYSTEM,
-	                          "g-flags", G_DBUS_PROXY_FLAGS_NONE,
-	                          "g-name", WPAS_DBUS_SERVICE,
-	                          "g-object-path", object_path,
-	                          "g-interface-name", WPAS_DBUS_IFACE_BSS,
-	                          NULL);
-	bss_data = g_slice_new0 (BssData);
-	bss_data->proxy = bss_proxy;
-	g_hash_table_insert (priv->bss_proxies,
-	                     (char *) g_dbus_proxy_get_object_path (bss_proxy),
-	                     bss_data);
-	g_async_initable_init_async (G_ASYNC_INITABLE (bss_proxy),
-	                             G_PRIORITY_DEFAULT,
-	                             priv->other_cancellable,
-	                             (GAsyncReadyCallback) bss_proxy_acquired_cb,
-	                             self);
+	if (!priv->iface_proxy)
+		return;
+
+	data = g_slice_new (BssGetAllData);
+	data->self = self;
+	data->path = g_strdup (object_path);
+	g_dbus_connection_call (g_dbus_proxy_get_connection (priv->iface_proxy),
+	                        WPAS_DBUS_SERVICE,
+	                        object_path,
+	                        DBUS_INTERFACE_PROPERTIES,
+	                        "GetAll",
+	                        g_variant_new ("(s)", WPAS_DBUS_IFACE_BSS),
+	                        G_VARIANT_TYPE ("(a{sv})"),
+	                        G_DBUS_CALL_FLAGS_NONE,
+	                        -1,
+	                        priv->other_cancellable,
+	                        bss_get_all_cb,
+	                        data);
 }
 
 /*****************************************************************************/
@@ -338,6 +428,7 @@ set_state (NMSupplicantInterface *self, NMSupplicantInterfaceState new_state)
 
 		if (priv->iface_proxy)
 			g_signal_handlers_disconnect_by_data (priv->iface_proxy, self);
+		bss_subscription_clear (self);
 	}
 
 	priv->state = new_state;
@@ -951,25 +1042,22 @@ scan_done_emit_signal (NMSupplicantInterface *self)
 	gboolean success;
 	GHashTableIter iter;
 
-	g_hash_table_iter_init (&iter, priv->bss_proxies);
+	g_hash_table_iter_init (&iter, priv->bss_hash);
 	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &bss_data)) {
 		/* we have some BSS' that need to be initialized first. Delay
 		 * emitting signal. */
-		if (!bss_data->change_id) {
+		if (!bss_data->props) {
 			priv->scan_done_pending = TRUE;
 			return;
 		}
 	}
 
 	/* Emit BSS_UPDATED so that wifi device has the APs (in case it removed them) */
-	g_hash_table_iter_init (&iter, priv->bss_proxies);
+	g_hash_table_iter_init (&iter, priv->bss_hash);
 	while (g_hash_table_iter_next (&iter, (gpointer *) &object_path, (gpointer *) &bss_data)) {
-		gs_unref_variant GVariant *props = NULL;
-
-		props = bss_proxy_get_properties (self, bss_data->proxy);
 		g_signal_emit (self, signals[BSS_UPDATED], 0,
 		               object_path,
-		               g_variant_ref_sink (props));
+		               bss_data->props);
 	}
 
 	success = priv->scan_done_success;
@@ -1004,7 +1092,7 @@ wpas_iface_bss_added (GDBusProxy *proxy,
 	if (priv->scanning)
 		priv->last_scan = nm_utils_get_monotonic_timestamp_s ();
 
-	bss_add_new (self, path);
+	bss_add_new (self, path, props);
 }
 
 static void
@@ -1016,10 +1104,10 @@ wpas_iface_bss_removed (GDBusProxy *proxy,
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 	BssData *bss_data;
 
-	bss_data = g_hash_table_lookup (priv->bss_proxies, path);
+	bss_data = g_hash_table_lookup (priv->bss_hash, path);
 	if (!bss_data)
 		return;
-	g_hash_table_steal (priv->bss_proxies, path);
+	g_hash_table_steal (priv->bss_hash, path);
 	g_signal_emit (self, signals[BSS_REMOVED], 0, path);
 	bss_data_destroy (bss_data);
 }
@@ -1069,7 +1157,7 @@ props_changed_cb (GDBusProxy *proxy,
 	if (g_variant_lookup (changed_properties, "BSSs", "^a&o", &array)) {
 		iter = array;
 		while (*iter)
-			bss_add_new (self, *iter++);
+			bss_add_new (self, *iter++, NULL);
 		g_free (array);
 	}
 
@@ -1132,6 +1220,17 @@ on_iface_proxy_acquired (GDBusProxy *proxy, GAsyncResult *result, gpointer user_
 	_nm_dbus_signal_connect (priv->iface_proxy, "NetworkRequest", G_VARIANT_TYPE ("(oss)"),
 	                         G_CALLBACK (wpas_iface_network_request), self);
 
+	priv->bss_props_changed_id = g_dbus_connection_signal_subscribe (g_dbus_proxy_get_connection (priv->iface_proxy),
+	                                                                 WPAS_DBUS_SERVICE,
+	                                                                 DBUS_INTERFACE_PROPERTIES,
+	                                                                 "PropertiesChanged",
+	                                                                 NULL,
+	                                                                 WPAS_DBUS_IFACE_BSS,
+	                                                                 G_DBUS_SIGNAL_FLAGS_NONE,
+	                                                                 bss_props_changed_cb,
+	                                                                 self,
+	                                                                 NULL);
+
 	/* Scan result aging parameters */
 	g_dbus_proxy_call (priv->iface_proxy,
 	                   DBUS_INTERFACE_PROPERTIES ".Set",
@@ -1931,7 +2030,7 @@ nm_supplicant_interface_init (NMSupplicantInterface * self)
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 
 	priv->state = NM_SUPPLICANT_INTERFACE_STATE_INIT;
-	priv->bss_proxies = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, bss_data_destroy);
+	priv->bss_hash = g_hash_table_new_full (nm_str_hash, g_str_equal, NULL, bss_data_destroy);
 }
 
 NMSupplicantInterface *
@@ -1979,13 +2078,14 @@ dispose (GObject *object)
 
 	if (priv->iface_proxy)
 		g_signal_handlers_disconnect_by_data (priv->iface_proxy, object);
+	bss_subscription_clear (self);
 	g_clear_object (&priv->iface_proxy);
 
 	nm_clear_g_cancellable (&priv->init_cancellable);
 	nm_clear_g_cancellable (&priv->other_cancellable);
 
 	g_clear_object (&priv->wpas_proxy);
-	g_clear_pointer (&priv->bss_proxies, (GDestroyNotify) g_hash_table_destroy);
+	g_clear_pointer (&priv->bss_hash, (GDestroyNotify) g_hash_table_destroy);
 
 	g_clear_pointer (&priv->net_path, g_free);
 	g_clear_pointer (&priv->dev, g_free);
@@ -1223,11 +1223,24 @@ static int client_timeout_t2(sd_event_source *s, uint64_t usec, void *userdata)
 static int client_timeout_t1(sd_event_source *s, uint64_t usec, void *userdata) {
         sd_dhcp_client *client = userdata;
         DHCP_CLIENT_DONT_DESTROY(client);
+        int r;
+
+        /* NM: bound clients don't keep a socket open, open it only for renewing. */
+        client->receive_message = sd_event_source_unref(client->receive_message);
+        client->fd = asynchronous_close(client->fd);
+
+        r = dhcp_network_bind_udp_socket(client->ifindex, client->lease->address, client->port);
+        if (r < 0) {
+                log_dhcp_client(client, "could not bind UDP socket");
+                client_stop(client, r);
+                return 0;
+        }
+        client->fd = r;
 
         client->state = DHCP_STATE_RENEWING;
         client->attempt = 1;
 
-        return client_initialize_time_events(client);
+        return client_initialize_events(client, client_receive_message_udp);
 }
 
 static int client_handle_offer(sd_dhcp_client *client, DHCPMessage *offer, size_t len) {
@@ -1377,6 +1390,17 @@ static uint64_t client_compute_timeout(sd_dhcp_client *client, uint32_t lifetime
                 + (random_u32() & 0x1fffff);
 }
 
+/* NM: renewal does not need to happen at an exact point in time. Allow
+ * sd-event to delay the T1 and T2 timers by up to 1% of the remaining
+ * time (at most 5 seconds), so that the timers of many clients on the
+ * same event loop can expire in the same wakeup. */
+static uint64_t client_compute_accuracy(uint64_t time_now, uint64_t timeout) {
+        if (timeout <= time_now)
+                return 10 * USEC_PER_MSEC;
+
+        return CLAMP((timeout - time_now) / 100, 10 * USEC_PER_MSEC, 5 * USEC_PER_SEC);
+}
+
 static int client_set_lease_timeouts(sd_dhcp_client *client) {
         usec_t time_now;
         uint64_t lifetime_timeout;
@@ -1476,7 +1500,7 @@ static int client_set_lease_timeouts(sd_dhcp_client *client) {
                               &client->timeout_t2,
                               clock_boottime_or_monotonic(),
                               t2_timeout,
-                              10 * USEC_PER_MSEC,
+                              client_compute_accuracy(time_now, t2_timeout),
                               client_timeout_t2, client);
         if (r < 0)
                 return r;
@@ -1501,7 +1525,7 @@ static int client_set_lease_timeouts(sd_dhcp_client *client) {
         r = sd_event_add_time(client->event,
                               &client->timeout_t1,
                               clock_boottime_or_monotonic(),
-                              t1_timeout, 10 * USEC_PER_MSEC,
+                              t1_timeout, client_compute_accuracy(time_now, t1_timeout),
                               client_timeout_t1, client);
         if (r < 0)
                 return r;
@@ -1595,15 +1619,12 @@ static int client_handle_message(sd_dhcp_client *client, DHCPMessage *message, i
                                 goto error;
                         }
 
-                        r = dhcp_network_bind_udp_socket(client->ifindex, client->lease->address, client->port);
-                        if (r < 0) {
-                                log_dhcp_client(client, "could not bind UDP socket");
-                                goto error;
-                        }
-
-                        client->fd = r;
-
-                        client_initialize_io_events(client, client_receive_message_udp);
+                        /* NM: don't bind a UDP socket while bound. With many
+                         * clients that costs one file descriptor each for the
+                         * whole lifetime of the lease, only to receive
+                         * FORCERENEW, which we accept without the
+                         * authentication that RFC 3203 requires. The socket is
+                         * opened in client_timeout_t1(). */
 
                         if (notify_event) {
                                 client_notify(client, notify_event);
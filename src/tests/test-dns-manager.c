@@ -0,0 +1,269 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "nm-config.h"
+#include "dns/nm-dns-manager.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+/* a fake resolvconf. It records "$1 <search domains>" to "log", but
+ * only once the file "gate" exists. It creates "started" first, so
+ * that the test knows that it runs. */
+#define RESOLVCONF_SCRIPT \
+	"#!/bin/sh\n" \
+	"dir=\"$(dirname \"$0\")\"\n" \
+	"input=\n" \
+	"[ \"$1\" = -a ] && input=\"$(cat)\"\n" \
+	"touch \"$dir/started\"\n" \
+	"while [ ! -e \"$dir/gate\" ]; do sleep 0.01; done\n" \
+	"echo \"$1 $(echo \"$input\" | sed -n 's/^search //p')\" >> \"$dir/log\"\n"
+
+typedef struct {
+	char *dir;
+	char *path_gate;
+	char *path_started;
+	char *path_log;
+	char *path_resolvconf;
+	char *path_my_resolv_conf;
+	GMainLoop *loop;
+	NMConfig *config;
+	NMDnsManager *dns_manager;
+
+	/* for each CONFIG_CHANGED, the content of "log" at the time. */
+	GPtrArray *config_changed;
+} TestData;
+
+static char *
+_read_log (TestData *td)
+{
+	char *contents = NULL;
+
+	if (!g_file_get_contents (td->path_log, &contents, NULL, NULL))
+		return g_strdup ("");
+	return contents;
+}
+
+static void
+_config_changed_cb (NMDnsManager *dns_manager, TestData *td)
+{
+	g_ptr_array_add (td->config_changed, _read_log (td));
+	g_main_loop_quit (td->loop);
+}
+
+static void
+_set_gate (TestData *td, gboolean open)
+{
+	if (open)
+		nmtst_assert_success (g_file_set_contents (td->path_gate, "", 0, NULL), NULL);
+	else
+		unlink (td->path_gate);
+}
+
+/* runs the main loop until the fake resolvconf started. */
+static void
+_wait_started (TestData *td)
+{
+	gint64 deadline = g_get_monotonic_time () + 5 * G_USEC_PER_SEC;
+
+	while (!g_file_test (td->path_started, G_FILE_TEST_EXISTS)) {
+		g_assert (g_get_monotonic_time () < deadline);
+		nmtst_main_loop_run (td->loop, 10);
+	}
+	unlink (td->path_started);
+}
+
+static void
+_wait_config_changed (TestData *td, guint n)
+{
+	while (td->config_changed->len < n)
+		g_assert (nmtst_main_loop_run (td->loop, 5000));
+	g_assert_cmpint (td->config_changed->len, ==, n);
+}
+
+static void
+_setup (TestData *td)
+{
+	gs_free char *path_conf = NULL;
+	gs_free_error GError *error = NULL;
+	NMConfigCmdLineOptions *cli;
+	GOptionContext *context;
+	char *argv_data[] = {
+		"test-dns-manager",
+		"--config", NULL,
+		"--intern-config", "",
+		"--config-dir", "/no/such/dir",
+		"--system-config-dir", "",
+		NULL,
+	};
+	char **argv = argv_data;
+	int argc = G_N_ELEMENTS (argv_data) - 1;
+	gs_free char *rc_manager = NULL;
+
+	td->dir = g_dir_make_tmp ("test-dns-manager-XXXXXX", &error);
+	nmtst_assert_success (td->dir, error);
+
+	td->path_gate = g_build_filename (td->dir, "gate", NULL);
+	td->path_started = g_build_filename (td->dir, "started", NULL);
+	td->path_log = g_build_filename (td->dir, "log", NULL);
+	td->path_resolvconf = g_build_filename (td->dir, "resolvconf", NULL);
+	td->path_my_resolv_conf = g_build_filename (td->dir, "resolv.conf", NULL);
+	td->loop = g_main_loop_new (NULL, FALSE);
+	td->config_changed = g_ptr_array_new_with_free_func (g_free);
+
+	nmtst_assert_success (g_file_set_contents (td->path_resolvconf, RESOLVCONF_SCRIPT, -1, &error), error);
+	g_assert_cmpint (chmod (td->path_resolvconf, 0755), ==, 0);
+
+	path_conf = g_build_filename (td->dir, "NetworkManager.conf", NULL);
+	nmtst_assert_success (g_file_set_contents (path_conf,
+	                                           "[main]\n"
+	                                           "dns=default\n"
+	                                           "rc-manager=resolvconf\n",
+	                                           -1,
+	                                           &error),
+	                      error);
+	argv_data[2] = path_conf;
+
+	cli = nm_config_cmd_line_options_new (FALSE);
+	context = g_option_context_new (NULL);
+	nm_config_cmd_line_options_add_to_entries (cli, context);
+	g_assert (g_option_context_parse (context, &argc, &argv, NULL));
+	g_option_context_free (context);
+	td->config = nm_config_setup (cli, NULL, &error);
+	nmtst_assert_success (td->config, error);
+	nm_config_cmd_line_options_free (cli);
+
+	_nm_dns_manager_set_paths_for_testing (td->path_resolvconf, td->path_my_resolv_conf);
+
+	td->dns_manager = g_object_new (NM_TYPE_DNS_MANAGER, NULL);
+	g_signal_connect (td->dns_manager, NM_DNS_MANAGER_CONFIG_CHANGED, G_CALLBACK (_config_changed_cb), td);
+
+	g_object_get (td->dns_manager, NM_DNS_MANAGER_RC_MANAGER, &rc_manager, NULL);
+	g_assert_cmpstr (rc_manager, ==, "resolvconf");
+}
+
+static void
+_teardown (TestData *td)
+{
+	const char *const files[] = { "gate", "started", "log", "resolvconf", "resolv.conf", "NetworkManager.conf" };
+	guint i;
+
+	/* the manager is only disposed when no job holds a reference. */
+	g_signal_handlers_disconnect_by_func (td->dns_manager, _config_changed_cb, td);
+	g_object_add_weak_pointer (G_OBJECT (td->dns_manager), (gpointer *) &td->dns_manager);
+	g_object_unref (td->dns_manager);
+	g_assert (!td->dns_manager);
+	g_object_unref (td->config);
+
+	for (i = 0; i < G_N_ELEMENTS (files); i++) {
+		gs_free char *path = g_build_filename (td->dir, files[i], NULL);
+
+		unlink (path);
+	}
+	g_assert_cmpint (rmdir (td->dir), ==, 0);
+
+	g_ptr_array_unref (td->config_changed);
+	g_main_loop_unref (td->loop);
+	g_free (td->dir);
+	g_free (td->path_gate);
+	g_free (td->path_started);
+	g_free (td->path_log);
+	g_free (td->path_resolvconf);
+	g_free (td->path_my_resolv_conf);
+}
+
+/*****************************************************************************/
+
+static void
+test_rc_job (void)
+{
+	TestData td_data = { 0 };
+	TestData *const td = &td_data;
+	gs_free char *log = NULL;
+
+	_setup (td);
+
+	/* the first update blocks in resolvconf. */
+	_set_gate (td, FALSE);
+	nm_dns_manager_set_hostname (td->dns_manager, "host.one.example", FALSE);
+	_wait_started (td);
+
+	/* while it runs, later updates only replace the pending job. */
+	nm_dns_manager_set_hostname (td->dns_manager, "host.two.example", FALSE);
+	nmtst_main_loop_run (td->loop, 50);
+	nm_dns_manager_set_hostname (td->dns_manager, "host.three.example", FALSE);
+	nmtst_main_loop_run (td->loop, 50);
+
+	/* config-changed is only emitted once a job completes. */
+	g_assert_cmpint (td->config_changed->len, ==, 0);
+	g_assert (!g_file_test (td->path_log, G_FILE_TEST_EXISTS));
+
+	_set_gate (td, TRUE);
+	_wait_config_changed (td, 2);
+
+	/* the jobs completed in order, each one before its signal, and the
+	 * second update was skipped. */
+	g_assert_cmpstr (td->config_changed->pdata[0], ==, "-a one.example\n");
+	g_assert_cmpstr (td->config_changed->pdata[1], ==, "-a one.example\n"
+	                                                  "-a three.example\n");
+	g_assert (g_file_test (td->path_my_resolv_conf, G_FILE_TEST_IS_REGULAR));
+
+	/* a hanging resolvconf is killed after a second. The update fails,
+	 * but the next one runs. */
+	_set_gate (td, FALSE);
+	unlink (td->path_started);
+	NMTST_EXPECT_NM_WARN ("*could not commit DNS changes: Error waiting for resolvconf to exit*");
+	nm_dns_manager_set_hostname (td->dns_manager, "host.four.example", FALSE);
+	_wait_started (td);
+	g_assert (!nmtst_main_loop_run (td->loop, 2000));
+	g_test_assert_expected_messages ();
+	g_assert_cmpint (td->config_changed->len, ==, 2);
+
+	_set_gate (td, TRUE);
+	nm_dns_manager_set_hostname (td->dns_manager, "host.five.example", FALSE);
+	_wait_config_changed (td, 3);
+
+	log = _read_log (td);
+	g_assert_cmpstr (log, ==, "-a one.example\n"
+	                          "-a three.example\n"
+	                          "-a five.example\n");
+
+	_teardown (td);
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	nmtst_init_assert_logging (&argc, &argv, "INFO", "DEFAULT");
+
+	g_test_add_func ("/dns-manager/rc-job", test_rc_job);
+
+	return g_test_run ();
+}
@@ -1014,6 +1014,66 @@ test_connection_sort_autoconnect_priority (void)
 
 /*****************************************************************************/
 
+static void
+test_connections_index_by_ifname (void)
+{
+	const guint N_CONNECTIONS = 5000;
+	const guint N_IFNAMES = 300;
+	gs_free NMConnection **connections = NULL;
+	GHashTable *index;
+	NMConnection *const*list;
+	guint i, j, len, n_found;
+	char ifname[32];
+
+	connections = g_new0 (NMConnection *, N_CONNECTIONS + 1);
+	for (i = 0; i < N_CONNECTIONS; i++) {
+		gs_free char *id = g_strdup_printf ("con-%u", i);
+		NMSettingConnection *s_con;
+		NMConnection *c;
+
+		c = nmtst_create_minimal_connection (id, NULL, NM_SETTING_WIRED_SETTING_NAME, &s_con);
+		if (i % 3 != 0) {
+			nm_sprintf_buf (ifname, "eth%u", (i / 3) % N_IFNAMES);
+			g_object_set (s_con,
+			              NM_SETTING_CONNECTION_INTERFACE_NAME, ifname,
+			              NULL);
+		}
+		nmtst_connection_normalize (c);
+		connections[i] = c;
+	}
+
+	index = nm_utils_connections_index_by_ifname (connections);
+
+	/* connections without interface-name are candidates for every device. */
+	list = nm_utils_connections_index_lookup (index, NULL, &len);
+	g_assert_cmpint (len, ==, (N_CONNECTIONS + 2) / 3);
+	for (j = 0; j < len; j++)
+		g_assert_cmpstr (nm_connection_get_interface_name (list[j]), ==, NULL);
+	g_assert (!list[len]);
+	n_found = len;
+
+	for (i = 0; i < N_IFNAMES; i++) {
+		nm_sprintf_buf (ifname, "eth%u", i);
+		list = nm_utils_connections_index_lookup (index, ifname, &len);
+		g_assert_cmpint (len, >, 0);
+		for (j = 0; j < len; j++)
+			g_assert_cmpstr (nm_connection_get_interface_name (list[j]), ==, ifname);
+		g_assert (!list[len]);
+		n_found += len;
+	}
+	g_assert_cmpint (n_found, ==, N_CONNECTIONS);
+
+	list = nm_utils_connections_index_lookup (index, "wlan0", &len);
+	g_assert_cmpint (len, ==, 0);
+	g_assert (list && !list[0]);
+
+	g_hash_table_unref (index);
+	for (i = 0; i < N_CONNECTIONS; i++)
+		g_object_unref (connections[i]);
+}
+
+/*****************************************************************************/
+
 #define MATCH_S390 "S390:"
 #define MATCH_DRIVER "DRIVER:"
 
@@ -1769,6 +1829,7 @@ main (int argc, char **argv)
 	g_test_add_func ("/general/connection-match/routes/ip6", test_connection_match_ip6_routes);
 
 	g_test_add_func ("/general/connection-sort/autoconnect-priority", test_connection_sort_autoconnect_priority);
+	g_test_add_func ("/general/connections-index/by-ifname", test_connections_index_by_ifname);
 
 	g_test_add_func ("/general/match-spec/device", test_match_spec_device);
 	g_test_add_func ("/general/match-spec/config", test_match_spec_config);
@@ -22,9 +22,12 @@
 
 #include <string.h>
 #include <arpa/inet.h>
+#include <linux/rtnetlink.h>
 
 #include "nm-ip4-config.h"
 #include "platform/nm-platform.h"
+#include "platform/nmp-object.h"
+#include "platform/nm-fake-platform.h"
 
 #include "nm-test-utils-core.h"
 
@@ -330,6 +333,157 @@ test_strip_search_trailing_dot (void)
 
 /*****************************************************************************/
 
+static void
+_route_changed_cb (NMPlatform *platform,
+                   int obj_type_i,
+                   int ifindex,
+                   gconstpointer platform_object,
+                   int change_type_i,
+                   GPtrArray *deltas)
+{
+	g_ptr_array_add (deltas, (gpointer) nmp_object_ref (NMP_OBJECT_UP_CAST (platform_object)));
+}
+
+static const NMPlatformIP4Route *
+_ext_route (int ifindex, const char *network, guint mss)
+{
+	return nmtst_platform_ip4_route_full (network, 16, NULL, ifindex, NM_IP_CONFIG_SOURCE_USER,
+	                                      100, mss, RT_SCOPE_LINK, NULL);
+}
+
+static void
+_ext_route_add (int ifindex, const char *network, guint mss)
+{
+	g_assert_cmpint (nm_platform_ip4_route_add (NM_PLATFORM_GET,
+	                                            NMP_NLM_FLAG_REPLACE,
+	                                            _ext_route (ifindex, network, mss)),
+	                 ==,
+	                 NM_PLATFORM_ERROR_SUCCESS);
+}
+
+static void
+_ext_route_delete (int ifindex, const char *network)
+{
+	NMPObject needle;
+	const NMPObject *obj;
+
+	nmp_object_stackinit (&needle, NMP_OBJECT_TYPE_IP4_ROUTE,
+	                      (const NMPlatformObject *) _ext_route (ifindex, network, 0));
+	obj = nm_platform_lookup_obj (NM_PLATFORM_GET, NMP_CACHE_ID_TYPE_OBJECT_TYPE, &needle);
+	g_assert (obj);
+	g_assert (nm_platform_object_delete (NM_PLATFORM_GET, obj));
+}
+
+/* what NMDevice does when it recaptures the external configuration:
+ * intersect the internal configuration and subtract it. */
+static NMIP4Config *
+_ext_capture (int ifindex, NMIP4Config *internal)
+{
+	nm_auto_unref_dedup_multi_index NMDedupMultiIndex *multi_idx = nm_dedup_multi_index_new ();
+	NMIP4Config *ext;
+
+	ext = nm_ip4_config_capture (multi_idx, NM_PLATFORM_GET, ifindex, FALSE);
+	g_assert (ext);
+	nm_ip4_config_intersect (internal, ext, 0);
+	nm_ip4_config_subtract (ext, internal, 0);
+	return ext;
+}
+
+/* the routes must be the same. Unlike nm_ip4_config_equal(), the order
+ * doesn't matter. */
+static void
+_assert_same_routes (const NMIP4Config *a, const NMIP4Config *b)
+{
+	NMDedupMultiIter iter;
+	const NMPlatformIP4Route *route;
+
+	g_assert_cmpint (nm_ip4_config_get_num_routes (a), ==, nm_ip4_config_get_num_routes (b));
+	nm_ip_config_iter_ip4_route_for_each (&iter, a, &route) {
+		const NMPObject *obj;
+
+		obj = nm_ip4_config_nmpobj_lookup (b, NMP_OBJECT_UP_CAST (route));
+		g_assert (obj);
+		g_assert_cmpint (nm_platform_ip4_route_cmp_full (route, NMP_OBJECT_CAST_IP4_ROUTE (obj)), ==, 0);
+	}
+}
+
+static void
+test_update_ext_route (void)
+{
+	gs_unref_object NMIP4Config *internal = NULL;
+	gs_unref_object NMIP4Config *internal_full = NULL;
+	gs_unref_object NMIP4Config *ext = NULL;
+	gs_unref_object NMIP4Config *ext_full = NULL;
+	gs_unref_ptrarray GPtrArray *deltas = NULL;
+	NMIPConfig *internal_list[2] = { NULL, NULL };
+	char network[INET_ADDRSTRLEN];
+	gulong handler_id;
+	int ifindex;
+	guint i;
+
+	ifindex = nm_platform_link_get_ifindex (NM_PLATFORM_GET, "eth0");
+	g_assert_cmpint (ifindex, >, 0);
+
+	/* 10.0.0.0/16 - 10.19.0.0/16, the first ten are also configured internally. */
+	internal = nmtst_ip4_config_new (ifindex);
+	for (i = 0; i < 20; i++) {
+		nm_sprintf_buf (network, "10.%u.0.0", i);
+		_ext_route_add (ifindex, network, 0);
+		if (i < 10)
+			nm_ip4_config_add_route (internal, _ext_route (ifindex, network, 0), NULL);
+	}
+	ext = _ext_capture (ifindex, internal);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (internal), ==, 10);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (ext), ==, 10);
+
+	internal_full = nm_ip4_config_clone (internal);
+
+	deltas = g_ptr_array_new_with_free_func ((GDestroyNotify) nmp_object_unref);
+	handler_id = g_signal_connect (NM_PLATFORM_GET, NM_PLATFORM_SIGNAL_IP4_ROUTE_CHANGED,
+	                               G_CALLBACK (_route_changed_cb), deltas);
+
+	/* remove an internal and an external route. */
+	_ext_route_delete (ifindex, "10.3.0.0");
+	_ext_route_delete (ifindex, "10.15.0.0");
+
+	/* new external routes, one of them added and removed again. */
+	_ext_route_add (ifindex, "10.30.0.0", 0);
+	_ext_route_add (ifindex, "10.31.0.0", 0);
+	_ext_route_delete (ifindex, "10.31.0.0");
+
+	/* change the attributes of an internal and an external route. */
+	_ext_route_add (ifindex, "10.4.0.0", 1400);
+	_ext_route_add (ifindex, "10.17.0.0", 1400);
+
+	/* removed and added again. */
+	_ext_route_delete (ifindex, "10.18.0.0");
+	_ext_route_add (ifindex, "10.18.0.0", 0);
+
+	g_signal_handler_disconnect (NM_PLATFORM_GET, handler_id);
+	g_assert_cmpint (deltas->len, >=, 9);
+
+	/* what NMDevice does for each changed route. */
+	internal_list[0] = (NMIPConfig *) internal;
+	for (i = 0; i < deltas->len; i++) {
+		if (!nm_ip_config_update_ext_route ((NMIPConfig *) ext,
+		                                    NULL,
+		                                    NM_PLATFORM_GET,
+		                                    deltas->pdata[i],
+		                                    internal_list))
+			nm_ip4_config_nmpobj_remove (internal, deltas->pdata[i]);
+	}
+
+	ext_full = _ext_capture (ifindex, internal_full);
+
+	_assert_same_routes (ext, ext_full);
+	_assert_same_routes (internal, internal_full);
+
+	g_assert_cmpint (nm_ip4_config_get_num_routes (internal), ==, 9);
+	g_assert_cmpint (nm_ip4_config_get_num_routes (ext), ==, 10);
+}
+
+/*****************************************************************************/
+
 NMTST_DEFINE ();
 
 int
@@ -337,12 +491,15 @@ main (int argc, char **argv)
 {
 	nmtst_init_with_logging (&argc, &argv, NULL, "DEFAULT");
 
+	nm_fake_platform_setup ();
+
 	g_test_add_func ("/ip4-config/subtract", test_subtract);
 	g_test_add_func ("/ip4-config/compare-with-source", test_compare_with_source);
 	g_test_add_func ("/ip4-config/add-address-with-source", test_add_address_with_source);
 	g_test_add_func ("/ip4-config/add-route-with-source", test_add_route_with_source);
 	g_test_add_func ("/ip4-config/merge-subtract-mtu", test_merge_subtract_mtu);
 	g_test_add_func ("/ip4-config/strip-search-trailing-dot", test_strip_search_trailing_dot);
+	g_test_add_func ("/ip4-config/update-ext-route", test_update_ext_route);
 
 	return g_test_run ();
 }
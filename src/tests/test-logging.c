@@ -0,0 +1,151 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <string.h>
+
+#include "nm-test-utils-core.h"
+
+/* the ring is set up in main() with this size, which gets rounded
+ * up to 8 entries. */
+#define RING_SIZE 5
+
+/*****************************************************************************/
+
+static void
+_log_range (guint start, guint end)
+{
+	guint i;
+
+	for (i = start; i < end; i++) {
+		if (i % 2)
+			nm_log_trace (LOGD_CORE, "ring message %u", i);
+		else
+			nm_log_dbg (LOGD_CORE, "ring message %u", i);
+	}
+}
+
+static void
+_expect_range (guint start, guint end)
+{
+	guint i;
+
+	for (i = start; i < end; i++) {
+		gs_free char *pattern = NULL;
+
+		pattern = g_strdup_printf ("*<%s> [*] ring message %u",
+		                           i % 2 ? "trace" : "debug", i);
+		NMTST_EXPECT_NM (G_LOG_LEVEL_DEBUG, pattern);
+	}
+}
+
+static void
+_flush (guint n_expected, guint n_lost, guint start, guint end)
+{
+	gs_free char *pattern = NULL;
+
+	pattern = g_strdup_printf ("*<info>  [*] logging: flush %u messages from ring (%u lost)",
+	                           n_expected, n_lost);
+	NMTST_EXPECT_NM (G_LOG_LEVEL_INFO, pattern);
+	_expect_range (start, end);
+	nm_logging_ring_flush ();
+	g_test_assert_expected_messages ();
+}
+
+/*****************************************************************************/
+
+static void
+test_ring_flush (void)
+{
+	_nm_logging_ring_set_index_for_testing (0);
+
+	/* nothing is written before the flush. */
+	_log_range (0, 3);
+	g_test_assert_expected_messages ();
+	_flush (3, 0, 0, 3);
+
+	/* a second flush only writes the new messages. */
+	_flush (0, 0, 0, 0);
+
+	/* the oldest messages are overwritten. */
+	_log_range (3, 14);
+	_flush (8, 3, 6, 14);
+}
+
+static void
+test_ring_wrap (void)
+{
+	/* the 32 bit index wraps in the middle of the messages. */
+	_nm_logging_ring_set_index_for_testing (G_MAXUINT32 - 4);
+
+	_log_range (0, 12);
+	_flush (8, 4, 4, 12);
+
+	_log_range (12, 14);
+	_flush (2, 0, 12, 14);
+}
+
+static void
+test_ring_truncate (void)
+{
+	char msg[1000];
+	char expected[400];
+	gs_free char *pattern = NULL;
+
+	_nm_logging_ring_set_index_for_testing (0);
+
+	memset (msg, 'x', sizeof (msg) - 1);
+	msg[sizeof (msg) - 1] = '\0';
+	nm_log_dbg (LOGD_CORE, "%s", msg);
+
+	/* the message is cut to fit the entry and ends with a marker. */
+	memset (expected, 'x', sizeof (expected) - 4);
+	strcpy (&expected[sizeof (expected) - 4], "...");
+	pattern = g_strdup_printf ("*<debug> [*] %s", expected);
+
+	NMTST_EXPECT_NM_INFO ("logging: flush 1 messages from ring (0 lost)");
+	NMTST_EXPECT_NM (G_LOG_LEVEL_DEBUG, pattern);
+	nm_logging_ring_flush ();
+	g_test_assert_expected_messages ();
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	gboolean success;
+
+	nmtst_init_assert_logging (&argc, &argv, "TRACE", "ALL");
+
+	/* the ring only takes messages that are enabled. */
+	success = nm_logging_setup ("TRACE", "ALL", NULL, NULL);
+	g_assert (success);
+	nm_logging_ring_setup (RING_SIZE);
+
+	g_test_add_func ("/logging/ring/flush", test_ring_flush);
+	g_test_add_func ("/logging/ring/wrap", test_ring_wrap);
+	g_test_add_func ("/logging/ring/truncate", test_ring_truncate);
+
+	return g_test_run ();
+}
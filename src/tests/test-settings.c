@@ -0,0 +1,184 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright 2018 Red Hat, Inc.
+ */
+
+#include "nm-default.h"
+
+#include <unistd.h>
+#include <pwd.h>
+
+#include "nm-setting-connection.h"
+#include "nm-setting-wired.h"
+
+#include "nm-auth-manager.h"
+#include "nm-auth-subject.h"
+#include "nm-bus-manager.h"
+#include "settings/nm-settings.h"
+#include "settings/nm-settings-connection.h"
+
+#include "nm-test-utils-core.h"
+
+/*****************************************************************************/
+
+static NMSettingsConnection *
+_connection_new (const char *id, const char *path, const char *user)
+{
+	gs_unref_object NMConnection *connection = NULL;
+	NMSettingsConnection *settings_connection;
+
+	connection = nmtst_create_minimal_connection (id, NULL, NM_SETTING_WIRED_SETTING_NAME, NULL);
+	if (user)
+		g_assert (nm_setting_connection_add_permission (nm_connection_get_setting_connection (connection), "user", user, NULL));
+	nmtst_connection_normalize (connection);
+
+	settings_connection = g_object_new (NM_TYPE_SETTINGS_CONNECTION, NULL);
+	nm_connection_replace_settings_from_connection (NM_CONNECTION (settings_connection), connection);
+	nm_connection_set_path (NM_CONNECTION (settings_connection), path);
+	return settings_connection;
+}
+
+static NMAuthSubject *
+_subject_new (uid_t uid)
+{
+	NMAuthSubject *subject;
+
+	/* the subject reads the start time of the process, so use the
+	 * test's own pid. */
+	subject = g_object_new (NM_TYPE_AUTH_SUBJECT,
+	                        NM_AUTH_SUBJECT_SUBJECT_TYPE, (int) NM_AUTH_SUBJECT_TYPE_UNIX_PROCESS,
+	                        NM_AUTH_SUBJECT_UNIX_PROCESS_DBUS_SENDER, ":1.42",
+	                        NM_AUTH_SUBJECT_UNIX_PROCESS_PID, (gulong) getpid (),
+	                        NM_AUTH_SUBJECT_UNIX_PROCESS_UID, (gulong) uid,
+	                        NULL);
+	g_assert (nm_auth_subject_is_unix_process (subject));
+	return subject;
+}
+
+/* checks that @all_settings contains exactly the connections in @expected,
+ * in that order, and that their settings are the ones of GetSettings. */
+static void
+_assert_all_settings (GVariant *all_settings, NMSettingsConnection *const*expected)
+{
+	gs_unref_variant GVariant *result = g_variant_ref_sink (all_settings);
+	guint i;
+
+	g_assert (g_variant_is_of_type (result, G_VARIANT_TYPE ("a{oa{sa{sv}}}")));
+	g_assert_cmpint (g_variant_n_children (result), ==, NM_PTRARRAY_LEN (expected));
+
+	for (i = 0; expected[i]; i++) {
+		gs_unref_variant GVariant *settings_expected = NULL;
+		gs_unref_variant GVariant *settings = NULL;
+		const char *path;
+
+		g_variant_get_child (result, i, "{&o@a{sa{sv}}}", &path, &settings);
+		g_assert_cmpstr (path, ==, nm_connection_get_path (NM_CONNECTION (expected[i])));
+
+		settings_expected = g_variant_ref_sink (nm_settings_connection_get_settings_for_dbus (expected[i]));
+		g_assert (g_variant_equal (settings, settings_expected));
+	}
+}
+
+/*****************************************************************************/
+
+static void
+test_get_all_settings_acl (void)
+{
+	gs_unref_object NMSettingsConnection *c_public = NULL;
+	gs_unref_object NMSettingsConnection *c_root = NULL;
+	gs_unref_object NMSettingsConnection *c_user = NULL;
+	gs_unref_object NMAuthSubject *subject_internal = NULL;
+	gs_unref_object NMAuthSubject *subject_root = NULL;
+	gs_unref_object NMAuthSubject *subject_user = NULL;
+	gs_free char *user = NULL;
+	uid_t uid;
+
+	/* the ACL is checked by user name, so pick an unprivileged
+	 * user that actually exists. */
+	uid = getuid ();
+	if (uid != 0) {
+		struct passwd *pw = getpwuid (uid);
+
+		if (!pw) {
+			g_test_skip ("the current user has no passwd entry");
+			return;
+		}
+		user = g_strdup (pw->pw_name);
+	} else {
+		struct passwd *pw = getpwnam ("nobody");
+
+		if (!pw || pw->pw_uid == 0) {
+			g_test_skip ("there is no unprivileged \"nobody\" user");
+			return;
+		}
+		user = g_strdup (pw->pw_name);
+		uid = pw->pw_uid;
+	}
+
+	c_public = _connection_new ("public", "/org/freedesktop/NetworkManager/Settings/1", NULL);
+	c_root = _connection_new ("root", "/org/freedesktop/NetworkManager/Settings/2", "root");
+	c_user = _connection_new ("user", "/org/freedesktop/NetworkManager/Settings/3", user);
+
+	subject_internal = nm_auth_subject_new_internal ();
+	subject_root = _subject_new (0);
+	subject_user = _subject_new (uid);
+
+	{
+		NMSettingsConnection *const connections[] = { c_public, c_root, c_user, NULL };
+		NMSettingsConnection *const expected_user[] = { c_public, c_user, NULL };
+		NMSettingsConnection *const none[] = { NULL };
+
+		/* root and internal requests see everything. */
+		_assert_all_settings (nm_settings_get_all_settings_for_subject (connections, subject_internal), connections);
+		_assert_all_settings (nm_settings_get_all_settings_for_subject (connections, subject_root), connections);
+
+		/* the other user doesn't see the connection restricted to root. */
+		_assert_all_settings (nm_settings_get_all_settings_for_subject (connections, subject_user), expected_user);
+
+		_assert_all_settings (nm_settings_get_all_settings_for_subject (none, subject_user), none);
+	}
+
+	{
+		NMSettingsConnection *const connections[] = { c_root, NULL };
+		NMSettingsConnection *const none[] = { NULL };
+
+		/* asking for invisible connections only returns an empty result,
+		 * not an error. */
+		_assert_all_settings (nm_settings_get_all_settings_for_subject (connections, subject_user), none);
+	}
+}
+
+/*****************************************************************************/
+
+NMTST_DEFINE ();
+
+int
+main (int argc, char **argv)
+{
+	/* creating a settings connection instantiates the session monitor,
+	 * which may fail to find logind in the test environment and
+	 * log an error. */
+	nmtst_init_with_logging (&argc, &argv, NULL, "DEFAULT");
+
+	nm_bus_manager_setup (g_object_new (NM_TYPE_BUS_MANAGER, NULL));
+	nm_auth_manager_setup (FALSE);
+
+	g_test_add_func ("/settings/get-all-settings/acl", test_get_all_settings_acl);
+
+	return g_test_run ();
+}
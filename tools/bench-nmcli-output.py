@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+# -*- Mode: python; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+
+# Benchmark nmcli output against the fake NetworkManager service from
+# test-networkmanager-service.py, populated with many connection profiles
+# and Wi-Fi access points. It needs a private session bus, for example:
+#
+#   $ dbus-run-session -- ./tools/bench-nmcli-output.py --nmcli ./clients/cli/nmcli -n 5000
+#
+# For every command and output mode it reports the wall clock time and the
+# peak resident set size of nmcli. Compare the numbers before and after a
+# change; absolute values depend on the machine.
+
+from __future__ import print_function
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+import uuid
+
+import dbus
+
+NM_SERVICE = 'org.freedesktop.NetworkManager'
+NM_PATH = '/org/freedesktop/NetworkManager'
+IFACE_TEST = 'org.freedesktop.NetworkManager.LibnmGlibTest'
+
+COMMANDS = [
+    ['connection', 'show'],
+    ['device', 'wifi', 'list'],
+]
+
+MODES = [
+    ('terse', ['--terse']),
+    ('getfield', ['--get-values', 'all']),
+    ('tabular', []),
+    ('pretty', ['--pretty']),
+    ('multiline', ['--mode', 'multiline']),
+]
+
+def start_service(bus):
+    service = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           'test-networkmanager-service.py')
+    env = dict(os.environ)
+    env['NM_TEST_SERVICE_NO_TIMEOUT'] = '1'
+    proc = subprocess.Popen([sys.executable, service], stdin=subprocess.PIPE, env=env)
+
+    for i in range(100):
+        if bus.name_has_owner(NM_SERVICE):
+            return proc
+        time.sleep(0.1)
+    proc.kill()
+    raise Exception('the test service did not appear on the bus')
+
+def populate(bus, n):
+    test = dbus.Interface(bus.get_object(NM_SERVICE, NM_PATH), IFACE_TEST)
+
+    test.AddWifiDevice('wlan0')
+    for i in range(n):
+        test.AddWifiAp('wlan0', 'bench-ap-%d' % (i),
+                       '02:00:%02X:%02X:%02X:%02X' % ((i >> 24) & 0xff, (i >> 16) & 0xff,
+                                                      (i >> 8) & 0xff, i & 0xff))
+
+    for i in range(n):
+        con = {
+            'connection': {
+                'id': 'bench-con-%d' % (i),
+                'uuid': str(uuid.uuid4()),
+                'type': '802-3-ethernet',
+            },
+            '802-3-ethernet': dbus.Dictionary({}, signature='sv'),
+        }
+        test.AddConnection(con, False)
+
+def run_nmcli(nmcli, args):
+    env = dict(os.environ)
+    env['LIBNM_USE_SESSION_BUS'] = '1'
+    with open(os.devnull, 'w') as devnull:
+        start = time.time()
+        proc = subprocess.Popen([nmcli] + args, stdout=devnull, env=env)
+        (pid, status, rusage) = os.wait4(proc.pid, 0)
+        duration = time.time() - start
+    if status != 0:
+        raise Exception('"%s" failed with status %d' % (' '.join(args), status))
+    return (duration, rusage.ru_maxrss)
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark nmcli output with many objects.')
+    parser.add_argument('--nmcli', default='nmcli',
+                        help='the nmcli binary to run')
+    parser.add_argument('-n', '--count', type=int, default=1000,
+                        help='number of connection profiles and access points')
+    parser.add_argument('-r', '--repeat', type=int, default=3,
+                        help='runs per command; the fastest one is reported')
+    args = parser.parse_args()
+
+    bus = dbus.SessionBus()
+    service = start_service(bus)
+    try:
+        populate(bus, args.count)
+
+        for command in COMMANDS:
+            for (mode_name, mode_args) in MODES:
+                results = [run_nmcli(args.nmcli, mode_args + command) for i in range(args.repeat)]
+                (duration, maxrss) = min(results)
+                print('%-24s %-10s %6d objects: %8.1f ms %8d KiB max RSS'
+                      % (' '.join(command), mode_name, args.count,
+                         duration * 1000, maxrss))
+    finally:
+        service.stdin.close()
+        service.wait()
+
+if __name__ == '__main__':
+    main()
@@ -5,6 +5,7 @@ from __future__ import print_function
 
 from gi.repository import GLib
 import sys
+import os
 import dbus
 import dbus.service
 import dbus.mainloop.glib
@@ -1102,6 +1103,17 @@ class Settings(ExportedObj):
     def ListConnections(self):
         return self.connections.keys()
 
+    @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='ao', out_signature='a{oa{sa{sv}}}')
+    def GetAllSettings(self, paths):
+        if not paths:
+            paths = self.connections.keys()
+        result = {}
+        for path in paths:
+            con = self.connections.get(path)
+            if con is not None and con.visible:
+                result[path] = con.settings
+        return result
+
     @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='a{sa{sv}}', out_signature='o')
     def AddConnection(self, settings):
         return self.add_connection(settings)
@@ -1327,7 +1339,8 @@ def main():
     io.add_watch(GLib.IOCondition.HUP, stdin_cb)
 
     # also quit after inactivity to ensure we don't stick around if the above fails somehow
-    GLib.timeout_add_seconds(20, quit_cb, None)
+    if not os.environ.get('NM_TEST_SERVICE_NO_TIMEOUT'):
+        GLib.timeout_add_seconds(20, quit_cb, None)
 
     try:
         mainloop.run()